@@ -0,0 +1,489 @@
+#include "gospl_model.hpp"
+#include <fcntl.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+extern char** environ;
+
+/**
+ * Ensemble throughput benchmark
+ *
+ * Runs M members for N intervals under three execution strategies:
+ * - sequential: one process holds all M members (one handle each) and steps
+ *               them in turn, the way a single host job drives an ensemble;
+ * - fork:       one process starts up and builds a warm member, then forks P
+ *               clones that share its pages copy-on-write and each run M/P
+ *               members;
+ * - spawn:      P independent worker processes, each starting from scratch
+ *               and running M/P members.
+ * The process strategies are repeated for each worker count P (by default
+ * powers of two up to the number of cores).
+ *
+ * Members are synthetic by default: a grid mesh of --nodes nodes whose set-up
+ * builds the neighbour table and whose step is an explicit diffusion sweep.
+ * With --config they are goSPL models created through the C API and stepped
+ * with runProcessesForDt.
+ *
+ * Reported per run: member-steps per second, speed-up over sequential,
+ * memory per member (proportional set size of every process doing member
+ * work, divided by M), start-up time, and scheduler overhead: the share of
+ * P x wall time not spent stepping members (start-up, fork/exec, load
+ * imbalance, waiting).
+ */
+
+using Clock = std::chrono::steady_clock;
+
+static double seconds_since(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+struct Options {
+    int members = 8;
+    int intervals = 20;
+    size_t nodes = 40000;
+    double dt = 1000.0;
+    std::vector<int> procs;
+    std::vector<std::string> strategies{"sequential", "fork", "spawn"};
+    std::string config;
+};
+
+// What one process doing member work sends back through its pipe.
+struct WorkerResult {
+    std::uint64_t member_steps = 0;
+    double busy_seconds = 0.0;     // inside member steps
+    double startup_seconds = 0.0;  // interpreter and member set-up
+    std::uint64_t pss_bytes = 0;
+    int ok = 0;
+};
+
+/** Proportional set size of this process (shared pages split between sharers). */
+static std::uint64_t process_pss() {
+    for (const char* path : {"/proc/self/smaps_rollup", "/proc/self/status"}) {
+        std::ifstream in(path);
+        std::string key;
+        std::uint64_t kb;
+        const std::string want = std::strstr(path, "smaps") ? "Pss:" : "VmRSS:";
+        while (in >> key) {
+            if (key == want && in >> kb) return kb * 1024;
+            in.ignore(1 << 16, '\n');
+        }
+    }
+    return 0;
+}
+
+// -----------------------------------------------------------------------------
+// Members
+
+/**
+ * Synthetic member: elevation on a square grid mesh, stepped by diffusion.
+ */
+class SyntheticMember {
+public:
+    explicit SyntheticMember(size_t nodes) : side_(std::max<size_t>(2, size_t(std::sqrt(double(nodes))))) {
+        const size_t n = side_ * side_;
+        elevation_.resize(n);
+        next_.resize(n);
+        neighbours_.resize(n * 4);
+        for (size_t i = 0; i < n; ++i) {
+            const size_t x = i % side_, y = i / side_;
+            elevation_[i] = 100.0 * std::sin(0.01 * double(x)) * std::cos(0.013 * double(y));
+            neighbours_[i * 4] = std::uint32_t(x > 0 ? i - 1 : i);
+            neighbours_[i * 4 + 1] = std::uint32_t(x + 1 < side_ ? i + 1 : i);
+            neighbours_[i * 4 + 2] = std::uint32_t(y > 0 ? i - side_ : i);
+            neighbours_[i * 4 + 3] = std::uint32_t(y + 1 < side_ ? i + side_ : i);
+        }
+    }
+
+    void step(double dt) {
+        const double k = std::min(0.2, 1.0e-5 * dt);
+        const size_t n = elevation_.size();
+        for (size_t i = 0; i < n; ++i) {
+            const std::uint32_t* nb = &neighbours_[i * 4];
+            double lap = elevation_[nb[0]] + elevation_[nb[1]] + elevation_[nb[2]] +
+                         elevation_[nb[3]] - 4.0 * elevation_[i];
+            next_[i] = elevation_[i] + k * lap;
+        }
+        elevation_.swap(next_);
+    }
+
+private:
+    size_t side_;
+    std::vector<double> elevation_, next_;
+    std::vector<std::uint32_t> neighbours_;
+};
+
+/**
+ * One ensemble member, synthetic or a goSPL model behind the C API.
+ */
+class Member {
+public:
+    explicit Member(const Options& opt) {
+        if (opt.config.empty())
+            synthetic_ = std::make_unique<SyntheticMember>(opt.nodes);
+        else
+            model_ = gospl::Model(opt.config);
+    }
+
+    Member(const Member& other) {
+        if (other.synthetic_) synthetic_ = std::make_unique<SyntheticMember>(*other.synthetic_);
+    }
+
+    Member(Member&&) = default;
+
+    bool clonable() const { return bool(synthetic_); }
+
+    void step(double dt) {
+        if (synthetic_)
+            synthetic_->step(dt);
+        else
+            model_.run_for(dt);
+    }
+
+private:
+    std::unique_ptr<SyntheticMember> synthetic_;
+    gospl::Model model_;
+};
+
+/**
+ * Holds the interpreter (goSPL members only) and a process's members.
+ */
+struct MemberSet {
+    std::optional<gospl::Session> session;
+    std::vector<Member> members;
+
+    void start(const Options& opt) {
+        if (!opt.config.empty() && !session) {
+            gospl_log_configure(GOSPL_LOG_WARN, 0, nullptr);
+            session.emplace();
+        }
+    }
+
+    // Add members; synthetic ones are copied from template when there is one.
+    void add(const Options& opt, int count, const Member* templ) {
+        members.reserve(members.size() + count);
+        for (int i = 0; i < count; ++i) {
+            if (templ && templ->clonable())
+                members.emplace_back(*templ);
+            else
+                members.emplace_back(opt);
+        }
+    }
+
+    WorkerResult run(const Options& opt, Clock::time_point started) {
+        WorkerResult r;
+        r.startup_seconds = seconds_since(started);
+        for (int n = 0; n < opt.intervals; ++n) {
+            for (Member& m : members) {
+                Clock::time_point start = Clock::now();
+                m.step(opt.dt);
+                r.busy_seconds += seconds_since(start);
+                ++r.member_steps;
+            }
+        }
+        r.pss_bytes = process_pss();
+        r.ok = 1;
+        return r;
+    }
+};
+
+static int share(int members, int procs, int rank) {
+    return members / procs + (rank < members % procs ? 1 : 0);
+}
+
+static void send_result(int fd, const WorkerResult& r) {
+    if (write(fd, &r, sizeof(r)) != ssize_t(sizeof(r))) _exit(3);
+    close(fd);
+}
+
+// Runs in a child process; returns its exit status.
+static int guarded_worker(int fd, const std::function<WorkerResult()>& body) {
+    try {
+        send_result(fd, body());
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "❌ worker " << getpid() << ": " << e.what() << '\n';
+        send_result(fd, WorkerResult{});
+        return 1;
+    }
+}
+
+struct Child {
+    pid_t pid;
+    int fd;
+};
+
+static std::vector<WorkerResult> collect(const std::vector<Child>& children) {
+    std::vector<WorkerResult> results;
+    for (const Child& c : children) {
+        WorkerResult r;
+        ssize_t got = read(c.fd, &r, sizeof(r));
+        close(c.fd);
+        int status = 0;
+        waitpid(c.pid, &status, 0);
+        if (got != ssize_t(sizeof(r))) r = WorkerResult{};
+        results.push_back(r);
+    }
+    return results;
+}
+
+// -----------------------------------------------------------------------------
+// Strategies (each runs in its own process so memory figures start clean)
+
+static std::vector<WorkerResult> run_sequential(const Options& opt, Clock::time_point started) {
+    MemberSet set;
+    set.start(opt);
+    set.add(opt, opt.members, nullptr);
+    return {set.run(opt, started)};
+}
+
+static std::vector<WorkerResult> run_fork(const Options& opt, int procs, Clock::time_point started) {
+    // Warm parent: interpreter and one member built once, inherited by clones
+    MemberSet warm;
+    warm.start(opt);
+    warm.add(opt, 1, nullptr);
+    std::vector<Child> children;
+    for (int rank = 0; rank < procs; ++rank) {
+        int fds[2];
+        if (pipe(fds) != 0) throw std::runtime_error("pipe failed");
+        // Forks with the GIL held so the clones inherit a consistent interpreter
+        pid_t pid = gospl_fork();
+        if (pid < 0) throw std::runtime_error("fork failed");
+        if (pid == 0) {
+            close(fds[0]);
+            _exit(guarded_worker(fds[1], [&] {
+                MemberSet set;
+                const int count = share(opt.members, procs, rank);
+                if (warm.members.front().clonable()) {
+                    set.add(opt, count, &warm.members.front());
+                } else if (count > 0) {
+                    // goSPL members: the inherited model is the first clone
+                    set.members.push_back(std::move(warm.members.front()));
+                    set.add(opt, count - 1, nullptr);
+                }
+                return set.run(opt, started);
+            }));
+        }
+        close(fds[1]);
+        children.push_back({pid, fds[0]});
+    }
+    warm.members.clear();
+    return collect(children);
+}
+
+static std::vector<std::string> worker_args(const Options& opt, int count, int fd) {
+    std::vector<std::string> args{"/proc/self/exe", "--worker", std::to_string(fd),
+                                  "--members", std::to_string(count),
+                                  "--intervals", std::to_string(opt.intervals),
+                                  "--nodes", std::to_string(opt.nodes),
+                                  "--dt", std::to_string(opt.dt)};
+    if (!opt.config.empty()) {
+        args.push_back("--config");
+        args.push_back(opt.config);
+    }
+    return args;
+}
+
+static std::vector<WorkerResult> run_spawn(const Options& opt, int procs) {
+    std::vector<Child> children;
+    for (int rank = 0; rank < procs; ++rank) {
+        int fds[2];
+        // only the write end is inherited; the parent closes it right after
+        if (pipe(fds) != 0) throw std::runtime_error("pipe failed");
+        fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+        std::vector<std::string> args = worker_args(opt, share(opt.members, procs, rank), fds[1]);
+        std::vector<char*> argv;
+        for (std::string& a : args) argv.push_back(a.data());
+        argv.push_back(nullptr);
+        pid_t pid;
+        int rc = posix_spawn(&pid, "/proc/self/exe", nullptr, nullptr, argv.data(), environ);
+        close(fds[1]);
+        if (rc != 0) {
+            close(fds[0]);
+            throw std::runtime_error(std::string("posix_spawn failed: ") + std::strerror(rc));
+        }
+        children.push_back({pid, fds[0]});
+    }
+    return collect(children);
+}
+
+// -----------------------------------------------------------------------------
+// Driver
+
+struct RunSummary {
+    WorkerResult total;
+    double wall = 0.0;
+    int ok = 0;
+};
+
+static RunSummary run_isolated(const Options& opt, const std::string& strategy, int procs) {
+    std::cout.flush();  // not inherited unflushed by the child
+    int fds[2];
+    if (pipe(fds) != 0) throw std::runtime_error("pipe failed");
+    pid_t pid = fork();
+    if (pid < 0) throw std::runtime_error("fork failed");
+    if (pid == 0) {
+        close(fds[0]);
+        RunSummary s;
+        try {
+            Clock::time_point started = Clock::now();
+            std::vector<WorkerResult> results =
+                strategy == "sequential" ? run_sequential(opt, started)
+                : strategy == "fork"     ? run_fork(opt, procs, started)
+                                         : run_spawn(opt, procs);
+            s.wall = seconds_since(started);
+            s.ok = 1;
+            for (const WorkerResult& r : results) {
+                s.ok &= r.ok;
+                s.total.member_steps += r.member_steps;
+                s.total.busy_seconds += r.busy_seconds;
+                s.total.startup_seconds = std::max(s.total.startup_seconds, r.startup_seconds);
+                s.total.pss_bytes += r.pss_bytes;
+            }
+        } catch (const std::exception& e) {
+            std::cerr << "❌ " << strategy << ": " << e.what() << '\n';
+            s.ok = 0;
+        }
+        if (write(fds[1], &s, sizeof(s)) != ssize_t(sizeof(s))) _exit(3);
+        _exit(s.ok ? 0 : 1);
+    }
+    close(fds[1]);
+    RunSummary s;
+    if (read(fds[0], &s, sizeof(s)) != ssize_t(sizeof(s))) s = RunSummary{};
+    close(fds[0]);
+    int status = 0;
+    waitpid(pid, &status, 0);
+    return s;
+}
+
+template <typename T>
+static std::vector<T> parse_list(const std::string& text) {
+    std::vector<T> values;
+    std::stringstream in(text);
+    std::string item;
+    while (std::getline(in, item, ',')) {
+        if (item.empty()) continue;
+        std::stringstream conv(item);
+        T value;
+        conv >> value;
+        if (conv.fail()) throw std::invalid_argument("bad list item: " + item);
+        values.push_back(value);
+    }
+    return values;
+}
+
+static void usage(const char* prog) {
+    std::cout << "Usage: " << prog << " [options]\n"
+              << "  --members M              ensemble members (default 8)\n"
+              << "  --intervals N            coupling intervals per member (default 20)\n"
+              << "  --nodes N                synthetic mesh nodes per member (default 40000)\n"
+              << "  --dt YEARS               interval length (default 1000)\n"
+              << "  --procs P[,P...]         worker counts (default powers of two up to the cores)\n"
+              << "  --strategies S[,S...]    sequential, fork, spawn (default all)\n"
+              << "  --config FILE            goSPL members from this config instead of synthetic\n";
+}
+
+static bool parse_args(int argc, char* argv[], Options& opt, int& worker_fd) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto value = [&]() -> std::string {
+            if (i + 1 >= argc) throw std::invalid_argument(arg + " needs a value");
+            return argv[++i];
+        };
+        if (arg == "--members") opt.members = std::stoi(value());
+        else if (arg == "--intervals") opt.intervals = std::stoi(value());
+        else if (arg == "--nodes") opt.nodes = std::stoull(value());
+        else if (arg == "--dt") opt.dt = std::stod(value());
+        else if (arg == "--procs") opt.procs = parse_list<int>(value());
+        else if (arg == "--strategies") opt.strategies = parse_list<std::string>(value());
+        else if (arg == "--config") opt.config = value();
+        else if (arg == "--worker") worker_fd = std::stoi(value());
+        else if (arg == "--help" || arg == "-h") { usage(argv[0]); return false; }
+        else throw std::invalid_argument("unknown option: " + arg);
+    }
+    if (opt.members < 1 || opt.intervals < 1) throw std::invalid_argument("members and intervals must be positive");
+    for (const std::string& s : opt.strategies)
+        if (s != "sequential" && s != "fork" && s != "spawn")
+            throw std::invalid_argument("unknown strategy: " + s);
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    Options opt;
+    int worker_fd = -1;
+    try {
+        if (!parse_args(argc, argv, opt, worker_fd)) return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "❌ " << e.what() << '\n';
+        usage(argv[0]);
+        return 2;
+    }
+
+    if (worker_fd >= 0) {
+        // Spawned worker: start from scratch and run --members members
+        return guarded_worker(worker_fd, [&] {
+            Clock::time_point started = Clock::now();
+            MemberSet set;
+            set.start(opt);
+            set.add(opt, opt.members, nullptr);
+            return set.run(opt, started);
+        });
+    }
+
+    const int cores = int(std::max(1u, std::thread::hardware_concurrency()));
+    if (opt.procs.empty())
+        for (int p = 1; p <= cores; p *= 2) opt.procs.push_back(p);
+
+    std::cout << "Ensemble benchmark: " << opt.members << " members x " << opt.intervals
+              << " intervals, " << (opt.config.empty() ? std::to_string(opt.nodes) + "-node synthetic members"
+                                                       : "goSPL members from " + opt.config)
+              << ", " << cores << " cores\n\n";
+    std::cout << std::left << std::setw(12) << "strategy" << std::right << std::setw(7) << "procs"
+              << std::setw(16) << "member-steps/s" << std::setw(10) << "speedup"
+              << std::setw(14) << "MB/member" << std::setw(13) << "startup ms"
+              << std::setw(12) << "overhead %" << '\n';
+
+    double sequential_rate = 0.0;
+    int status = 0;
+    for (const std::string& strategy : opt.strategies) {
+        std::vector<int> procs = strategy == "sequential" ? std::vector<int>{1} : opt.procs;
+        for (int p : procs) {
+            if (p < 1) continue;
+            RunSummary s = run_isolated(opt, strategy, p);
+            if (!s.ok) {
+                std::cerr << "❌ " << strategy << " with " << p << " processes failed\n";
+                status = 1;
+                continue;
+            }
+            const double rate = double(s.total.member_steps) / s.wall;
+            if (strategy == "sequential") sequential_rate = rate;
+            const double overhead = 1.0 - s.total.busy_seconds / (double(p) * s.wall);
+            std::cout << std::left << std::setw(12) << strategy << std::right << std::setw(7) << p
+                      << std::fixed << std::setprecision(1) << std::setw(16) << rate
+                      << std::setprecision(2) << std::setw(10)
+                      << (sequential_rate > 0.0 ? rate / sequential_rate : 0.0)
+                      << std::setw(14) << double(s.total.pss_bytes) / opt.members / (1024.0 * 1024.0)
+                      << std::setprecision(1) << std::setw(13) << s.total.startup_seconds * 1.0e3
+                      << std::setw(12) << 100.0 * std::max(0.0, overhead) << '\n';
+        }
+    }
+    return status;
+}
@@ -0,0 +1,665 @@
+#include "gospl_model.hpp"
+#include <zlib.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Output I/O benchmark for snapshot, checkpoint and history writers
+ *
+ * A synthetic stepping loop evolves surface fields on a mesh of N nodes and
+ * hands frames to a writer at fixed cadences:
+ * - snapshot:   elevation, erosion and uplift (3 x N doubles)
+ * - checkpoint: coordinates plus all fields, self-contained, replaced in place
+ * - history:    per-step statistics and a fixed set of probe nodes
+ *
+ * Each writer strategy is run on the same frame sequence:
+ * - sync:       raw records written and flushed on the stepping thread
+ * - async:      frames copied into a bounded queue drained by a writer thread
+ * - compressed: each field deflated (zlib, level 1) before writing
+ * - delta:      each field XORed with its previous frame, then deflated;
+ *               checkpoints stay full so any one restores on its own
+ * Prefix a strategy with "async+" (e.g. async+delta) to encode it off the
+ * stepping thread.
+ *
+ * Reported per mesh size and writer: logical and on-disk bytes, throughput
+ * (logical bytes over the time the writer spent encoding and writing) and the
+ * stall seen by the stepping thread (time spent inside write() plus the
+ * final drain), also as a share of the stepping time.
+ *
+ * With --config a goSPL model is created through the C API and stepped
+ * instead, and the time goSPL spends writing its own output (at the tout
+ * cadence of the config) is read back with get_output_stats(), as the
+ * reference the candidate writers are measured against.
+ */
+
+using Clock = std::chrono::steady_clock;
+
+static double seconds_since(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+enum class FrameKind : std::uint32_t { Snapshot = 0, Checkpoint = 1, History = 2 };
+
+static const char* kind_name(FrameKind kind) {
+    switch (kind) {
+        case FrameKind::Snapshot: return "snapshot";
+        case FrameKind::Checkpoint: return "checkpoint";
+        default: return "history";
+    }
+}
+
+struct Field {
+    std::string name;
+    const double* data;
+    size_t count;
+};
+
+struct Frame {
+    FrameKind kind;
+    std::uint64_t step;
+    std::vector<Field> fields;
+
+    size_t bytes() const {
+        size_t total = 0;
+        for (const Field& f : fields) total += f.count * sizeof(double);
+        return total;
+    }
+};
+
+// Owned copy of a frame, used by the async writer's queue.
+struct FrameCopy {
+    FrameKind kind;
+    std::uint64_t step;
+    std::vector<std::string> names;
+    std::vector<std::vector<double>> data;
+
+    void assign(const Frame& frame) {
+        kind = frame.kind;
+        step = frame.step;
+        names.resize(frame.fields.size());
+        data.resize(frame.fields.size());
+        for (size_t i = 0; i < frame.fields.size(); ++i) {
+            names[i] = frame.fields[i].name;
+            data[i].assign(frame.fields[i].data, frame.fields[i].data + frame.fields[i].count);
+        }
+    }
+
+    Frame view() const {
+        Frame frame{kind, step, {}};
+        for (size_t i = 0; i < data.size(); ++i)
+            frame.fields.push_back({names[i], data[i].data(), data[i].size()});
+        return frame;
+    }
+};
+
+// Record header: kind, field count, step, then per field encoding, raw and
+// stored sizes ahead of the payload.
+struct RecordHeader {
+    std::uint32_t kind;
+    std::uint32_t fields;
+    std::uint64_t step;
+};
+
+struct FieldHeader {
+    std::uint32_t encoding;  // 0 raw, 1 deflate, 2 xor-delta + deflate
+    std::uint32_t reserved;
+    std::uint64_t raw_bytes;
+    std::uint64_t stored_bytes;
+};
+
+/**
+ * Output sink with one stream file per frame kind. Snapshots and history
+ * append; a checkpoint goes to a temporary file renamed over the previous one.
+ */
+class Sink {
+public:
+    explicit Sink(const std::filesystem::path& prefix) : prefix_(prefix) {}
+
+    ~Sink() {
+        for (auto& entry : streams_) std::fclose(entry.second);
+    }
+
+    void begin(const RecordHeader& header) {
+        FrameKind kind = static_cast<FrameKind>(header.kind);
+        if (kind == FrameKind::Checkpoint) {
+            current_ = open(path(kind, ".tmp"), "wb");
+        } else {
+            auto it = streams_.find(header.kind);
+            if (it == streams_.end())
+                it = streams_.emplace(header.kind, open(path(kind, ""), "wb")).first;
+            current_ = it->second;
+        }
+        put(&header, sizeof(header));
+    }
+
+    void field(const FieldHeader& header, const void* payload) {
+        put(&header, sizeof(header));
+        put(payload, header.stored_bytes);
+    }
+
+    void end(FrameKind kind) {
+        if (kind == FrameKind::Checkpoint) {
+            std::fclose(current_);
+            std::filesystem::rename(path(kind, ".tmp"), path(kind, ""));
+        } else {
+            std::fflush(current_);
+        }
+        current_ = nullptr;
+    }
+
+    std::uint64_t bytes_written() const { return bytes_; }
+
+private:
+    std::filesystem::path path(FrameKind kind, const char* suffix) const {
+        return prefix_.string() + "_" + kind_name(kind) + ".bin" + suffix;
+    }
+
+    static std::FILE* open(const std::filesystem::path& p, const char* mode) {
+        std::FILE* f = std::fopen(p.c_str(), mode);
+        if (!f) throw std::runtime_error("cannot open " + p.string());
+        return f;
+    }
+
+    void put(const void* data, size_t n) {
+        if (n && std::fwrite(data, 1, n, current_) != n)
+            throw std::runtime_error("short write to " + prefix_.string());
+        bytes_ += n;
+    }
+
+    std::filesystem::path prefix_;
+    std::map<std::uint32_t, std::FILE*> streams_;
+    std::FILE* current_ = nullptr;
+    std::uint64_t bytes_ = 0;
+};
+
+class Writer {
+public:
+    virtual ~Writer() = default;
+
+    // Called on the stepping thread; everything it costs there is stall.
+    virtual void write(const Frame& frame) = 0;
+    // Wait until every accepted frame is on disk.
+    virtual void drain() {}
+    virtual std::uint64_t bytes_written() const = 0;
+    // Seconds spent encoding and writing, on whichever thread does it.
+    virtual double busy_seconds() const = 0;
+};
+
+/**
+ * Encodes frames on the calling thread: raw, deflated or XOR-delta deflated.
+ */
+class EncodingWriter : public Writer {
+public:
+    EncodingWriter(const std::filesystem::path& prefix, std::uint32_t encoding)
+        : sink_(prefix), encoding_(encoding) {}
+
+    void write(const Frame& frame) override {
+        Clock::time_point start = Clock::now();
+        sink_.begin({static_cast<std::uint32_t>(frame.kind),
+                     static_cast<std::uint32_t>(frame.fields.size()), frame.step});
+        for (const Field& f : frame.fields) {
+            std::uint32_t encoding = encoding_;
+            const std::uint64_t raw = f.count * sizeof(double);
+            const void* payload = f.data;
+            std::uint64_t stored = raw;
+            if (encoding == 2) {
+                std::vector<double>& prev = previous_[key(frame.kind, f.name)];
+                if (frame.kind == FrameKind::Checkpoint || prev.size() != f.count) {
+                    encoding = 1;  // keyframe
+                } else {
+                    xor_.resize(f.count);
+                    const std::uint64_t* a = reinterpret_cast<const std::uint64_t*>(f.data);
+                    const std::uint64_t* b = reinterpret_cast<const std::uint64_t*>(prev.data());
+                    for (size_t i = 0; i < f.count; ++i) xor_[i] = a[i] ^ b[i];
+                    payload = xor_.data();
+                }
+                if (frame.kind != FrameKind::Checkpoint)
+                    prev.assign(f.data, f.data + f.count);
+            }
+            if (encoding != 0) {
+                uLongf bound = compressBound(raw);
+                deflated_.resize(bound);
+                if (compress2(deflated_.data(), &bound, static_cast<const Bytef*>(payload),
+                              raw, 1) != Z_OK)
+                    throw std::runtime_error("deflate failed");
+                payload = deflated_.data();
+                stored = bound;
+            }
+            sink_.field({encoding, 0, raw, stored}, payload);
+        }
+        sink_.end(frame.kind);
+        busy_ += seconds_since(start);
+    }
+
+    std::uint64_t bytes_written() const override { return sink_.bytes_written(); }
+    double busy_seconds() const override { return busy_; }
+
+private:
+    static std::string key(FrameKind kind, const std::string& name) {
+        return std::string(kind_name(kind)) + "/" + name;
+    }
+
+    Sink sink_;
+    std::uint32_t encoding_;
+    std::map<std::string, std::vector<double>> previous_;
+    std::vector<std::uint64_t> xor_;
+    std::vector<Bytef> deflated_;
+    double busy_ = 0.0;
+};
+
+/**
+ * Hands frames to a background thread through a bounded queue. The stepping
+ * thread pays for the copy, and waits only when all buffers are in flight.
+ */
+class AsyncWriter : public Writer {
+public:
+    AsyncWriter(std::unique_ptr<Writer> inner, size_t depth)
+        : inner_(std::move(inner)), free_(depth), worker_([this] { run(); }) {}
+
+    ~AsyncWriter() override {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        ready_cv_.notify_one();
+        worker_.join();
+    }
+
+    void write(const Frame& frame) override {
+        std::unique_lock<std::mutex> lock(mutex_);
+        free_cv_.wait(lock, [this] { return !free_.empty() || error_; });
+        if (error_) std::rethrow_exception(error_);
+        FrameCopy buffer = std::move(free_.back());
+        free_.pop_back();
+        lock.unlock();
+        buffer.assign(frame);  // reuses the buffer's capacity
+        lock.lock();
+        ready_.push_back(std::move(buffer));
+        lock.unlock();
+        ready_cv_.notify_one();
+    }
+
+    void drain() override {
+        std::unique_lock<std::mutex> lock(mutex_);
+        free_cv_.wait(lock, [this] { return (ready_.empty() && !writing_) || error_; });
+        if (error_) std::rethrow_exception(error_);
+    }
+
+    std::uint64_t bytes_written() const override { return inner_->bytes_written(); }
+    double busy_seconds() const override { return inner_->busy_seconds(); }
+
+private:
+    void run() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        for (;;) {
+            ready_cv_.wait(lock, [this] { return stop_ || !ready_.empty(); });
+            if (ready_.empty()) return;
+            FrameCopy buffer = std::move(ready_.front());
+            ready_.pop_front();
+            writing_ = true;
+            lock.unlock();
+            try {
+                inner_->write(buffer.view());
+            } catch (...) {
+                lock.lock();
+                error_ = std::current_exception();
+                writing_ = false;
+                free_cv_.notify_all();
+                return;
+            }
+            lock.lock();
+            writing_ = false;
+            free_.push_back(std::move(buffer));
+            free_cv_.notify_all();
+        }
+    }
+
+    std::unique_ptr<Writer> inner_;
+    std::mutex mutex_;
+    std::condition_variable ready_cv_;
+    std::condition_variable free_cv_;
+    std::vector<FrameCopy> free_;
+    std::deque<FrameCopy> ready_;
+    bool writing_ = false;
+    bool stop_ = false;
+    std::exception_ptr error_;
+    std::thread worker_;
+};
+
+static std::unique_ptr<Writer> make_writer(const std::string& name,
+                                           const std::filesystem::path& prefix,
+                                           size_t queue_depth) {
+    if (name.rfind("async+", 0) == 0)
+        return std::make_unique<AsyncWriter>(make_writer(name.substr(6), prefix, queue_depth),
+                                             queue_depth);
+    if (name == "async")
+        return std::make_unique<AsyncWriter>(make_writer("sync", prefix, queue_depth),
+                                             queue_depth);
+    if (name == "sync") return std::make_unique<EncodingWriter>(prefix, 0);
+    if (name == "compressed") return std::make_unique<EncodingWriter>(prefix, 1);
+    if (name == "delta") return std::make_unique<EncodingWriter>(prefix, 2);
+    throw std::invalid_argument("unknown writer: " + name);
+}
+
+/**
+ * Synthetic surface state. Each step uplifts the whole mesh slowly and erodes
+ * a band of nodes, so consecutive frames share most of their values the way
+ * landscape fields do between outputs.
+ */
+struct SurfaceState {
+    std::vector<double> coords, elevation, erosion, uplift, stats, probes;
+    std::vector<size_t> probe_nodes;
+    double time = 0.0;
+    std::mt19937_64 rng{42};
+
+    SurfaceState(size_t nodes, size_t nprobes)
+        : coords(nodes * 3), elevation(nodes), erosion(nodes), uplift(nodes),
+          stats(5), probes(std::min(nprobes, nodes)) {
+        const size_t side = std::max<size_t>(1, static_cast<size_t>(std::sqrt(double(nodes))));
+        std::uniform_real_distribution<double> noise(0.0, 1.0);
+        for (size_t i = 0; i < nodes; ++i) {
+            coords[i * 3] = double(i % side) * 100.0;
+            coords[i * 3 + 1] = double(i / side) * 100.0;
+            elevation[i] = 100.0 * noise(rng);
+            uplift[i] = (i % side) < side / 2 ? 1.0e-3 : 0.0;
+        }
+        for (size_t p = 0; p < probes.size(); ++p) probe_nodes.push_back(p * nodes / probes.size());
+    }
+
+    void step(std::uint64_t n, double dt, double active) {
+        const size_t nodes = elevation.size();
+        const size_t band = std::max<size_t>(1, static_cast<size_t>(active * double(nodes)));
+        const size_t first = (n * band) % nodes;
+        std::uniform_real_distribution<double> rate(0.0, 1.0e-3);
+        std::fill(erosion.begin(), erosion.end(), 0.0);
+        for (size_t k = 0; k < band; ++k) {
+            size_t i = (first + k) % nodes;
+            erosion[i] = -rate(rng) * dt;
+        }
+        double lo = elevation[0], hi = elevation[0], sum = 0.0, eroded = 0.0;
+        for (size_t i = 0; i < nodes; ++i) {
+            elevation[i] += uplift[i] * dt + erosion[i];
+            lo = std::min(lo, elevation[i]);
+            hi = std::max(hi, elevation[i]);
+            sum += elevation[i];
+            eroded += erosion[i];
+        }
+        time += dt;
+        stats = {time, lo, hi, sum / double(nodes), eroded};
+        for (size_t p = 0; p < probe_nodes.size(); ++p) probes[p] = elevation[probe_nodes[p]];
+    }
+
+    Frame frame(FrameKind kind, std::uint64_t n) const {
+        switch (kind) {
+            case FrameKind::Snapshot:
+                return {kind, n, {{"elevation", elevation.data(), elevation.size()},
+                                  {"erosion", erosion.data(), erosion.size()},
+                                  {"uplift", uplift.data(), uplift.size()}}};
+            case FrameKind::Checkpoint:
+                return {kind, n, {{"time", &time, 1},
+                                  {"coords", coords.data(), coords.size()},
+                                  {"elevation", elevation.data(), elevation.size()},
+                                  {"erosion", erosion.data(), erosion.size()},
+                                  {"uplift", uplift.data(), uplift.size()}}};
+            default:
+                return {kind, n, {{"stats", stats.data(), stats.size()},
+                                  {"probes", probes.data(), probes.size()}}};
+        }
+    }
+};
+
+struct Options {
+    std::vector<size_t> nodes{10000, 100000, 1000000};
+    std::vector<std::string> writers{"sync", "async", "compressed", "delta"};
+    std::uint64_t steps = 100;
+    std::uint64_t snapshot_every = 10;
+    std::uint64_t checkpoint_every = 50;
+    std::uint64_t history_every = 1;
+    size_t probes = 64;
+    size_t queue_depth = 2;
+    double active = 0.05;
+    std::filesystem::path dir = std::filesystem::temp_directory_path() / "gospl_bench_output";
+    bool keep = false;
+    std::string config;
+    double dt = 0.0;  // 0: the model's time step
+};
+
+struct Result {
+    std::uint64_t frames = 0;
+    std::uint64_t logical_bytes = 0;
+    std::uint64_t disk_bytes = 0;
+    double step_seconds = 0.0;
+    double stall_seconds = 0.0;
+    double max_stall = 0.0;
+    double drain_seconds = 0.0;
+    double busy_seconds = 0.0;
+};
+
+static Result run(const Options& opt, size_t nodes, const std::string& writer_name) {
+    SurfaceState state(nodes, opt.probes);
+    std::filesystem::path prefix = opt.dir / (writer_name + "_" + std::to_string(nodes));
+    std::unique_ptr<Writer> writer = make_writer(writer_name, prefix, opt.queue_depth);
+    Result r;
+
+    auto emit = [&](FrameKind kind, std::uint64_t n) {
+        Frame frame = state.frame(kind, n);
+        Clock::time_point start = Clock::now();
+        writer->write(frame);
+        double stall = seconds_since(start);
+        r.stall_seconds += stall;
+        r.max_stall = std::max(r.max_stall, stall);
+        r.logical_bytes += frame.bytes();
+        ++r.frames;
+    };
+
+    for (std::uint64_t n = 1; n <= opt.steps; ++n) {
+        Clock::time_point start = Clock::now();
+        state.step(n, 1000.0, opt.active);
+        r.step_seconds += seconds_since(start);
+        if (opt.history_every && n % opt.history_every == 0) emit(FrameKind::History, n);
+        if (opt.snapshot_every && n % opt.snapshot_every == 0) emit(FrameKind::Snapshot, n);
+        if (opt.checkpoint_every && n % opt.checkpoint_every == 0) emit(FrameKind::Checkpoint, n);
+    }
+    Clock::time_point start = Clock::now();
+    writer->drain();
+    r.drain_seconds = seconds_since(start);
+    r.disk_bytes = writer->bytes_written();
+    r.busy_seconds = writer->busy_seconds();
+    return r;
+}
+
+/**
+ * Step a goSPL model from opt.config and report the share of the stepping
+ * time goSPL spent writing its own output.
+ */
+static int run_gospl(const Options& opt) {
+    gospl_log_configure(GOSPL_LOG_WARN, 0, nullptr);
+    gospl::Session session;
+    gospl::Model model(opt.config);
+    const double dt = opt.dt > 0.0 ? opt.dt : model.time_step();
+
+    int writes0 = 0;
+    double output0 = 0.0;
+    if (get_output_stats(model.handle(), &writes0, &output0) != 0)
+        throw gospl::ModelError("get_output_stats");
+
+    double step_seconds = 0.0, max_step = 0.0;
+    for (std::uint64_t n = 1; n <= opt.steps; ++n) {
+        Clock::time_point start = Clock::now();
+        model.run_for(dt);
+        double s = seconds_since(start);
+        step_seconds += s;
+        max_step = std::max(max_step, s);
+    }
+
+    int writes = 0;
+    double output = 0.0;
+    if (get_output_stats(model.handle(), &writes, &output) != 0)
+        throw gospl::ModelError("get_output_stats");
+    writes -= writes0;
+    output -= output0;
+
+    std::cout << "goSPL output benchmark: " << opt.steps << " steps of " << dt << " years from "
+              << opt.config << "\n\n";
+    std::cout << std::right << std::setw(8) << "writes" << std::setw(12) << "output ms"
+              << std::setw(12) << "ms/write" << std::setw(12) << "step ms"
+              << std::setw(12) << "max step" << std::setw(10) << "output %" << '\n';
+    std::cout << std::fixed << std::setw(8) << writes << std::setprecision(2)
+              << std::setw(12) << output * 1.0e3
+              << std::setw(12) << (writes ? output * 1.0e3 / writes : 0.0)
+              << std::setw(12) << step_seconds * 1.0e3
+              << std::setw(12) << max_step * 1.0e3
+              << std::setprecision(1)
+              << std::setw(10) << 100.0 * output / std::max(step_seconds, 1.0e-9) << '\n';
+    return 0;
+}
+
+template <typename T>
+static std::vector<T> parse_list(const std::string& text) {
+    std::vector<T> values;
+    std::stringstream in(text);
+    std::string item;
+    while (std::getline(in, item, ',')) {
+        if (item.empty()) continue;
+        std::stringstream conv(item);
+        T value;
+        conv >> value;
+        if (conv.fail()) throw std::invalid_argument("bad list item: " + item);
+        values.push_back(value);
+    }
+    return values;
+}
+
+static void usage(const char* prog) {
+    std::cout << "Usage: " << prog << " [options]\n"
+              << "  --nodes N[,N...]          mesh sizes (default 10000,100000,1000000)\n"
+              << "  --writers W[,W...]        sync, async, compressed, delta or async+<writer>\n"
+              << "                            (default sync,async,compressed,delta)\n"
+              << "  --steps N                 stepping intervals (default 100)\n"
+              << "  --snapshot-every N        snapshot cadence in steps, 0 disables (default 10)\n"
+              << "  --checkpoint-every N      checkpoint cadence in steps, 0 disables (default 50)\n"
+              << "  --history-every N         history cadence in steps, 0 disables (default 1)\n"
+              << "  --probes N                history probe nodes (default 64)\n"
+              << "  --active F                fraction of nodes eroded per step (default 0.05)\n"
+              << "  --queue-depth N           async writer buffers (default 2)\n"
+              << "  --dir PATH                output directory (default <tmp>/gospl_bench_output)\n"
+              << "  --keep                    keep the written files\n"
+              << "  --config FILE             time goSPL's own output for this config instead\n"
+              << "                            (uses --steps and --dt)\n"
+              << "  --dt YEARS                goSPL step length (default: the model's dt)\n";
+}
+
+static bool parse_args(int argc, char* argv[], Options& opt) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto value = [&]() -> std::string {
+            if (i + 1 >= argc) throw std::invalid_argument(arg + " needs a value");
+            return argv[++i];
+        };
+        if (arg == "--nodes") opt.nodes = parse_list<size_t>(value());
+        else if (arg == "--writers") opt.writers = parse_list<std::string>(value());
+        else if (arg == "--steps") opt.steps = std::stoull(value());
+        else if (arg == "--snapshot-every") opt.snapshot_every = std::stoull(value());
+        else if (arg == "--checkpoint-every") opt.checkpoint_every = std::stoull(value());
+        else if (arg == "--history-every") opt.history_every = std::stoull(value());
+        else if (arg == "--probes") opt.probes = std::stoull(value());
+        else if (arg == "--active") opt.active = std::stod(value());
+        else if (arg == "--queue-depth") opt.queue_depth = std::max<size_t>(1, std::stoull(value()));
+        else if (arg == "--dir") opt.dir = value();
+        else if (arg == "--keep") opt.keep = true;
+        else if (arg == "--config") opt.config = value();
+        else if (arg == "--dt") opt.dt = std::stod(value());
+        else if (arg == "--help" || arg == "-h") { usage(argv[0]); return false; }
+        else throw std::invalid_argument("unknown option: " + arg);
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    Options opt;
+    try {
+        if (!parse_args(argc, argv, opt)) return 0;
+        for (const std::string& w : opt.writers) make_writer(w, opt.dir / "probe", 1);
+    } catch (const std::exception& e) {
+        std::cerr << "❌ " << e.what() << '\n';
+        usage(argv[0]);
+        return 2;
+    }
+
+    if (!opt.config.empty()) {
+        try {
+            return run_gospl(opt);
+        } catch (const std::exception& e) {
+            std::cerr << "❌ " << e.what() << '\n';
+            return 1;
+        }
+    }
+
+    std::cout << "Output I/O benchmark: " << opt.steps << " steps, snapshot/checkpoint/history every "
+              << opt.snapshot_every << "/" << opt.checkpoint_every << "/" << opt.history_every
+              << " steps, writing to " << opt.dir.string() << '\n';
+
+    const double mb = 1024.0 * 1024.0;
+    int status = 0;
+    for (size_t nodes : opt.nodes) {
+        std::cout << "\nMesh nodes: " << nodes << '\n';
+        std::cout << std::left << std::setw(18) << "writer" << std::right
+                  << std::setw(8) << "frames" << std::setw(12) << "logical MB"
+                  << std::setw(10) << "disk MB" << std::setw(8) << "ratio"
+                  << std::setw(10) << "MB/s" << std::setw(11) << "stall ms"
+                  << std::setw(10) << "max ms" << std::setw(10) << "drain ms"
+                  << std::setw(9) << "stall %" << '\n';
+        for (const std::string& w : opt.writers) {
+            try {
+                std::filesystem::create_directories(opt.dir);
+                Result r = run(opt, nodes, w);
+                double stall = r.stall_seconds + r.drain_seconds;
+                std::cout << std::left << std::setw(18) << w << std::right << std::fixed
+                          << std::setw(8) << r.frames
+                          << std::setprecision(2)
+                          << std::setw(12) << r.logical_bytes / mb
+                          << std::setw(10) << r.disk_bytes / mb
+                          << std::setw(8) << double(r.logical_bytes) / double(std::max<std::uint64_t>(1, r.disk_bytes))
+                          << std::setprecision(1)
+                          << std::setw(10) << r.logical_bytes / mb / std::max(r.busy_seconds, 1.0e-9)
+                          << std::setprecision(2)
+                          << std::setw(11) << r.stall_seconds * 1.0e3
+                          << std::setw(10) << r.max_stall * 1.0e3
+                          << std::setw(10) << r.drain_seconds * 1.0e3
+                          << std::setprecision(1)
+                          << std::setw(9) << 100.0 * stall / (r.step_seconds + stall) << '\n';
+            } catch (const std::exception& e) {
+                std::cerr << "❌ " << w << " at " << nodes << " nodes: " << e.what() << '\n';
+                status = 1;
+            }
+            if (!opt.keep) {
+                std::error_code ec;
+                for (const char* kind : {"snapshot", "checkpoint", "history"})
+                    std::filesystem::remove(opt.dir / (w + "_" + std::to_string(nodes) + "_" + kind + ".bin"), ec);
+            }
+        }
+    }
+    if (!opt.keep) {
+        std::error_code ec;
+        std::filesystem::remove(opt.dir, ec);  // only if empty
+    }
+    return status;
+}
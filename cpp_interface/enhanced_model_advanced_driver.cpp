@@ -1,10 +1,11 @@
-#include "gospl_extensions.h"
+#include "gospl_model.hpp"
 #include <iostream>
 #include <vector>
 #include <cmath>
 #include <chrono>
 #include <iomanip>
 #include <algorithm>
+#include <optional>
 
 /**
  * Advanced Enhanced Model C++ Driver
@@ -16,7 +17,8 @@
  * 4. Comparing elevation changes before and after each time step
  * 5. Advanced coupling between tectonics and topographic evolution
  * 
- * This code interfaces with goSPL extensions through Python C API bindings.
+ * This code interfaces with goSPL extensions through the gospl::Model façade
+ * over the Python C API bindings.
  */
 
 struct ElevationStats {
@@ -31,59 +33,57 @@ struct ElevationStats {
 
 class AdvancedEnhancedModelDriver {
 public:
-    ModelHandle model_handle;
+    std::optional<gospl::Session> session;
+    gospl::Model model;
     bool initialized;
     std::vector<std::vector<double>> elevation_history;
     std::vector<double> time_history;
+    std::vector<double> changes;  // reused by analyze_elevation_changes()
     
-    AdvancedEnhancedModelDriver() : model_handle(-1), initialized(false) {}
+    AdvancedEnhancedModelDriver() : initialized(false) {}
     
     ~AdvancedEnhancedModelDriver() {
         cleanup();
     }
     
     bool initialize(const std::string& config_path) {
-        std::cout << "Advanced Enhanced Model C++ Driver: Elevation Tracking & Updating" << std::endl;
-        std::cout << std::string(65, '=') << std::endl;
+        std::cout << "Advanced Enhanced Model C++ Driver: Elevation Tracking & Updating" << '\n';
+        std::cout << std::string(65, '=') << '\n';
         
-        // Initialize gospl extensions
-        if (initialize_gospl_extensions() != 0) {
-            std::cerr << "Failed to initialize gospl extensions" << std::endl;
-            return false;
-        }
-        
-        // Create enhanced model
-        std::cout << "Initializing EnhancedModel with " << config_path << std::endl;
-        model_handle = create_enhanced_model(config_path.c_str());
+        // Buffered library and Python log on stderr, rank 0 only below errors
+        gospl_log_configure(GOSPL_LOG_INFO, 0, nullptr);
         
-        if (model_handle < 0) {
-            std::cerr << "Failed to create enhanced model" << std::endl;
+        try {
+            // Initialize gospl extensions
+            session.emplace();
+            
+            // Create enhanced model
+            std::cout << "Initializing EnhancedModel with " << config_path << '\n';
+            model = gospl::Model(config_path);
+        } catch (const gospl::Error& e) {
+            std::cerr << "Failed to set up the enhanced model: " << e.what() << std::endl;
+            cleanup();
             return false;
         }
         
-        double current_time = get_current_time(model_handle);
-        double dt = get_time_step(model_handle);
+        double current_time = model.time();
+        double dt = model.time_step();
         
         std::cout << "Model initialized at t=" << current_time 
-                  << ", dt=" << dt << std::endl;
+                  << ", dt=" << dt << '\n';
         
         initialized = true;
         return true;
     }
     
     void cleanup() {
-        if (model_handle >= 0) {
-            destroy_model(model_handle);
-            model_handle = -1;
-        }
-        
-        if (initialized) {
-            finalize_gospl_extensions();
-            initialized = false;
-        }
+        // The model must go before the session finalizes the interpreter
+        model.reset();
+        session.reset();
+        initialized = false;
     }
     
-    ElevationStats calculate_elevation_stats(const std::vector<double>& elevations) {
+    ElevationStats calculate_elevation_stats(gospl::span<const double> elevations) {
         ElevationStats stats;
         
         if (elevations.empty()) return stats;
@@ -100,14 +100,14 @@ public:
         return stats;
     }
     
-    ElevationStats analyze_elevation_changes(const std::vector<double>& z_before, 
-                                           const std::vector<double>& z_after,
+    ElevationStats analyze_elevation_changes(gospl::span<const double> z_before, 
+                                           gospl::span<const double> z_after,
                                            const std::string& step_info = "") {
         ElevationStats stats_before = calculate_elevation_stats(z_before);
         ElevationStats stats_after = calculate_elevation_stats(z_after);
         
         // Calculate changes
-        std::vector<double> changes(z_before.size());
+        changes.resize(z_before.size());
         double sum_sq_change = 0.0;
         
         for (size_t i = 0; i < z_before.size(); i++) {
@@ -139,24 +139,24 @@ public:
         }
         
         // Print analysis
-        std::cout << "  Elevation Analysis" << step_info << ":" << std::endl;
+        std::cout << "  Elevation Analysis" << step_info << ":" << '\n';
         std::cout << "    Before - Min: " << std::fixed << std::setprecision(6) 
                   << stats_before.min_elev << ", Max: " << stats_before.max_elev 
-                  << ", Mean: " << stats_before.mean_elev << std::endl;
+                  << ", Mean: " << stats_before.mean_elev << '\n';
         std::cout << "    After  - Min: " << stats_after.min_elev 
                   << ", Max: " << stats_after.max_elev 
-                  << ", Mean: " << stats_after.mean_elev << std::endl;
+                  << ", Mean: " << stats_after.mean_elev << '\n';
         
         auto min_change = *std::min_element(changes.begin(), changes.end());
         auto max_change = *std::max_element(changes.begin(), changes.end());
         
         std::cout << "    Change - Min: " << min_change << ", Max: " << max_change 
-                  << ", Mean: " << mean_change << std::endl;
-        std::cout << "    RMS change: " << rms_change << std::endl;
+                  << ", Mean: " << mean_change << '\n';
+        std::cout << "    RMS change: " << rms_change << '\n';
         
         if (significant_changes > 0) {
             std::cout << "    Points with significant change (>" << threshold 
-                      << "): " << significant_changes << "/" << changes.size() << std::endl;
+                      << "): " << significant_changes << "/" << changes.size() << '\n';
         }
         
         ElevationStats result;
@@ -172,8 +172,8 @@ public:
     void demonstrate_elevation_interpolation() {
         if (!initialized) return;
         
-        std::cout << "\nDemonstrating elevation interpolation:" << std::endl;
-        std::cout << std::string(50, '=') << std::endl;
+        std::cout << "\nDemonstrating elevation interpolation:" << '\n';
+        std::cout << std::string(50, '=') << '\n';
         
         // Create test points across the domain (11x11 grid = 121 points)
         const int grid_size = 11;
@@ -191,44 +191,36 @@ public:
             }
         }
         
-        std::cout << "Interpolating elevation at " << num_test_points << " test points" << std::endl;
+        std::cout << "Interpolating elevation at " << num_test_points << " test points" << '\n';
         
         // Test different interpolation parameters
         std::vector<int> k_values = {1, 3, 5};
         for (int k : k_values) {
-            int result = interpolate_elevation_to_points(model_handle, test_coords.data(), 
-                                                       num_test_points, test_elevations.data(), 
-                                                       k, 1.0);
-            if (result == 0) {
-                ElevationStats stats = calculate_elevation_stats(test_elevations);
-                std::cout << "  k=" << k << ": Min=" << std::fixed << std::setprecision(6) 
-                          << stats.min_elev << ", Max=" << stats.max_elev 
-                          << ", Mean=" << stats.mean_elev << std::endl;
-            }
+            model.interpolate_elevation(test_coords, test_elevations, k, 1.0);
+            ElevationStats stats = calculate_elevation_stats(test_elevations);
+            std::cout << "  k=" << k << ": Min=" << std::fixed << std::setprecision(6) 
+                      << stats.min_elev << ", Max=" << stats.max_elev 
+                      << ", Mean=" << stats.mean_elev << '\n';
         }
         
         std::vector<double> power_values = {0.5, 1.0, 2.0};
         for (double power : power_values) {
-            int result = interpolate_elevation_to_points(model_handle, test_coords.data(), 
-                                                       num_test_points, test_elevations.data(), 
-                                                       3, power);
-            if (result == 0) {
-                ElevationStats stats = calculate_elevation_stats(test_elevations);
-                std::cout << "  power=" << power << ": Min=" << stats.min_elev 
-                          << ", Max=" << stats.max_elev 
-                          << ", Mean=" << stats.mean_elev << std::endl;
-            }
+            model.interpolate_elevation(test_coords, test_elevations, 3, power);
+            ElevationStats stats = calculate_elevation_stats(test_elevations);
+            std::cout << "  power=" << power << ": Min=" << stats.min_elev 
+                      << ", Max=" << stats.max_elev 
+                      << ", Mean=" << stats.mean_elev << '\n';
         }
     }
     
     void run_controlled_simulation_with_elevation_tracking(double duration = 5.0, double dt = 1.0) {
         if (!initialized) return;
         
-        std::cout << "\nRunning controlled simulation with elevation tracking" << std::endl;
-        std::cout << "Duration: " << duration << " time units, dt: " << dt << std::endl;
-        std::cout << std::string(70, '=') << std::endl;
+        std::cout << "\nRunning controlled simulation with elevation tracking" << '\n';
+        std::cout << "Duration: " << duration << " time units, dt: " << dt << '\n';
+        std::cout << std::string(70, '=') << '\n';
         
-        double start_time = get_current_time(model_handle);
+        double start_time = model.time();
         double target_time = start_time + duration;
         int step = 0;
         
@@ -238,6 +230,8 @@ public:
         std::vector<double> coords(num_points * 3);
         std::vector<double> velocities(num_points * 3);
         std::vector<double> elevations(num_points);
+        std::vector<double> z_before(num_points);
+        model.reserve(num_points);
         
         // Initialize coordinates
         for (int i = 0; i < grid_size; i++) {
@@ -250,25 +244,23 @@ public:
         }
         
         // Get initial elevations
-        int elev_result = interpolate_elevation_to_points(model_handle, coords.data(), 
-                                                        num_points, elevations.data(), 5, 1.0);
-        if (elev_result == 0) {
-            // Update z coordinates with initial elevations
-            for (int i = 0; i < num_points; i++) {
-                coords[i * 3 + 2] = elevations[i];
-            }
-            
-            ElevationStats initial_stats = calculate_elevation_stats(elevations);
-            std::cout << "Initial elevation stats:" << std::endl;
-            std::cout << "  Min: " << std::fixed << std::setprecision(6) << initial_stats.min_elev << std::endl;
-            std::cout << "  Max: " << initial_stats.max_elev << std::endl;
-            std::cout << "  Mean: " << initial_stats.mean_elev << std::endl;
-            
-            // Store initial elevation history
-            elevation_history.push_back(elevations);
-            time_history.push_back(start_time);
+        model.interpolate_elevation(coords, elevations, 5, 1.0);
+        
+        // Update z coordinates with initial elevations
+        for (int i = 0; i < num_points; i++) {
+            coords[i * 3 + 2] = elevations[i];
         }
         
+        ElevationStats initial_stats = calculate_elevation_stats(elevations);
+        std::cout << "Initial elevation stats:" << '\n';
+        std::cout << "  Min: " << std::fixed << std::setprecision(6) << initial_stats.min_elev << '\n';
+        std::cout << "  Max: " << initial_stats.max_elev << '\n';
+        std::cout << "  Mean: " << initial_stats.mean_elev << '\n';
+        
+        // Store initial elevation history
+        elevation_history.push_back(elevations);
+        time_history.push_back(start_time);
+        
         // Run simulation with elevation tracking
         double current_time = start_time;
         while (current_time < target_time) {
@@ -277,10 +269,9 @@ public:
             
             std::cout << "\nStep " << (step + 1) << ": t=" 
                       << std::fixed << std::setprecision(2) << current_time 
-                      << " -> " << (current_time + step_dt) << std::endl;
+                      << " -> " << (current_time + step_dt) << '\n';
             
             // Store elevation before this step
-            std::vector<double> z_before(num_points);
             for (int i = 0; i < num_points; i++) {
                 z_before[i] = coords[i * 3 + 2];
             }
@@ -288,44 +279,39 @@ public:
             // Generate time-dependent velocity field (keeping x,y coordinates, updating z)
             create_velocity_field_at_coords(current_time, coords.data(), velocities.data(), num_points);
             std::cout << "  Generated velocity field for t=" 
-                      << std::fixed << std::setprecision(2) << current_time << std::endl;
+                      << std::fixed << std::setprecision(2) << current_time << '\n';
             
             // Apply velocities
-            int apply_result = apply_velocity_data(model_handle, coords.data(), velocities.data(),
-                                                 num_points, step_dt, 3, 1.0);
-            if (apply_result == 0) {
-                std::cout << "  Applied velocity data with timer=" << step_dt << std::endl;
+            try {
+                model.apply_velocity(coords, velocities, step_dt, 3, 1.0);
+                std::cout << "  Applied velocity data with timer=" << step_dt << '\n';
+            } catch (const gospl::ModelError& e) {
+                std::cerr << "  " << e.what() << std::endl;
             }
             
             // Run processes for this time step
-            double elapsed = run_processes_for_dt(model_handle, step_dt, 1, 1);
-            if (elapsed >= 0) {
-                std::cout << "  Completed step in " 
-                          << std::fixed << std::setprecision(2) << elapsed << "s" << std::endl;
-            }
+            double elapsed = model.run_for(step_dt, true, true);
+            std::cout << "  Completed step in " 
+                      << std::fixed << std::setprecision(2) << elapsed << "s" << '\n';
             
             // Interpolate current elevation field to velocity sampling points
-            std::vector<double> current_elevations(num_points);
-            int interp_result = interpolate_elevation_to_points(model_handle, coords.data(), 
-                                                              num_points, current_elevations.data(), 
-                                                              5, 1.0);
+            // (a view of the model's reused buffer)
+            gospl::span<const double> current_elevations = model.interpolate_elevation(coords, 5, 1.0);
             
-            if (interp_result == 0) {
-                // Update z coordinates with new elevations
-                for (int i = 0; i < num_points; i++) {
-                    coords[i * 3 + 2] = current_elevations[i];
-                }
-                
-                // Analyze elevation changes
-                std::string step_info = " (Step " + std::to_string(step + 1) + ")";
-                analyze_elevation_changes(z_before, current_elevations, step_info);
-                
-                // Store elevation history
-                elevation_history.push_back(current_elevations);
-                time_history.push_back(get_current_time(model_handle));
+            // Update z coordinates with new elevations
+            for (int i = 0; i < num_points; i++) {
+                coords[i * 3 + 2] = current_elevations[i];
             }
             
-            current_time = get_current_time(model_handle);
+            // Analyze elevation changes
+            std::string step_info = " (Step " + std::to_string(step + 1) + ")";
+            analyze_elevation_changes(z_before, current_elevations, step_info);
+            
+            // Store elevation history
+            elevation_history.emplace_back(current_elevations.begin(), current_elevations.end());
+            time_history.push_back(model.time());
+            
+            current_time = model.time();
             step++;
         }
         
@@ -360,45 +346,45 @@ private:
     }
     
     void print_final_analysis(int num_steps) {
-        std::cout << "\n" << std::string(70, '=') << std::endl;
-        std::cout << "FINAL ELEVATION ANALYSIS" << std::endl;
-        std::cout << std::string(70, '=') << std::endl;
+        std::cout << "\n" << std::string(70, '=') << '\n';
+        std::cout << "FINAL ELEVATION ANALYSIS" << '\n';
+        std::cout << std::string(70, '=') << '\n';
         
         if (elevation_history.size() < 2) return;
         
         const auto& initial_elevations = elevation_history[0];
         const auto& final_elevations = elevation_history.back();
         
-        double final_time = get_current_time(model_handle);
+        double final_time = model.time();
         double start_time = time_history[0];
         
         std::cout << "Total simulation time: " << std::fixed << std::setprecision(2) 
-                  << (final_time - start_time) << " time units" << std::endl;
-        std::cout << "Number of steps: " << num_steps << std::endl;
+                  << (final_time - start_time) << " time units" << '\n';
+        std::cout << "Number of steps: " << num_steps << '\n';
         
         analyze_elevation_changes(initial_elevations, final_elevations, " (Total)");
         
         // Analyze elevation evolution over time
-        std::cout << "\nElevation Evolution Summary:" << std::endl;
+        std::cout << "\nElevation Evolution Summary:" << '\n';
         for (size_t i = 0; i < elevation_history.size(); i++) {
             ElevationStats stats = calculate_elevation_stats(elevation_history[i]);
             
             if (i == 0) {
                 std::cout << "  t=" << std::fixed << std::setprecision(2) << time_history[i] 
                           << ": Mean elevation = " << std::setprecision(6) << stats.mean_elev 
-                          << " (initial)" << std::endl;
+                          << " (initial)" << '\n';
             } else {
                 ElevationStats prev_stats = calculate_elevation_stats(elevation_history[i-1]);
                 double change = stats.mean_elev - prev_stats.mean_elev;
                 std::cout << "  t=" << std::fixed << std::setprecision(2) << time_history[i] 
                           << ": Mean elevation = " << std::setprecision(6) << stats.mean_elev 
-                          << " (Δ=" << std::showpos << change << std::noshowpos << ")" << std::endl;
+                          << " (Δ=" << std::showpos << change << std::noshowpos << ")" << '\n';
             }
         }
         
         std::cout << "\n✓ Simulation completed! Ran for " 
                   << std::fixed << std::setprecision(2) << (final_time - start_time) 
-                  << " time units in " << num_steps << " steps" << std::endl;
+                  << " time units in " << num_steps << " steps" << '\n';
     }
 };
 
@@ -426,14 +412,11 @@ int main(int argc, char* argv[]) {
         // Run controlled simulation with elevation tracking
         driver.run_controlled_simulation_with_elevation_tracking(50.0, 1.0);
         
-        std::cout << "\n🎉 All demonstrations completed successfully!" << std::endl;
+        std::cout << "\n🎉 All demonstrations completed successfully!" << '\n';
         
         // Get final simulation time
-        double final_time = get_current_time(driver.model_handle);
-        if (final_time >= 0) {
-            std::cout << "Final simulation time: t=" 
-                      << std::fixed << std::setprecision(1) << final_time << std::endl;
-        }
+        std::cout << "Final simulation time: t=" 
+                  << std::fixed << std::setprecision(1) << driver.model.time() << '\n';
         
         return 0;
         
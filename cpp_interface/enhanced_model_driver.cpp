@@ -29,8 +29,11 @@ public:
     }
     
     bool initialize(const std::string& config_path) {
-        std::cout << "Enhanced Model C++ Driver: Granular Time Control" << std::endl;
-        std::cout << std::string(55, '=') << std::endl;
+        std::cout << "Enhanced Model C++ Driver: Granular Time Control" << '\n';
+        std::cout << std::string(55, '=') << '\n';
+        
+        // Buffered library and Python log on stderr, rank 0 only below errors
+        gospl_log_configure(GOSPL_LOG_INFO, 0, nullptr);
         
         // Initialize gospl extensions
         if (initialize_gospl_extensions() != 0) {
@@ -39,7 +42,7 @@ public:
         }
         
         // Create enhanced model
-        std::cout << "Initializing EnhancedModel with " << config_path << std::endl;
+        std::cout << "Initializing EnhancedModel with " << config_path << '\n';
         model_handle = create_enhanced_model(config_path.c_str());
         
         if (model_handle < 0) {
@@ -51,7 +54,7 @@ public:
         double dt = get_time_step(model_handle);
         
         std::cout << "Model initialized at t=" << current_time 
-                  << ", dt=" << dt << std::endl;
+                  << ", dt=" << dt << '\n';
         
         initialized = true;
         return true;
@@ -72,16 +75,16 @@ public:
     void demonstrate_enhanced_model_methods() {
         if (!initialized) return;
         
-        std::cout << "\nDemonstrating EnhancedModel methods:" << std::endl;
-        std::cout << std::string(50, '=') << std::endl;
+        std::cout << "\nDemonstrating EnhancedModel methods:" << '\n';
+        std::cout << std::string(50, '=') << '\n';
         
         double initial_time = get_current_time(model_handle);
         
         // Method 1: Run for specific number of steps
-        std::cout << "\n1. Running 3 steps with dt=0.5" << std::endl;
+        std::cout << "\n1. Running 3 steps with dt=0.5" << '\n';
         int steps_completed = run_processes_for_steps(model_handle, 3, 0.5, 1, 1);
         if (steps_completed > 0) {
-            std::cout << "   Completed " << steps_completed << " steps" << std::endl;
+            std::cout << "   Completed " << steps_completed << " steps" << '\n';
         } else {
             std::cerr << "   Error running steps" << std::endl;
         }
@@ -89,10 +92,10 @@ public:
         // Method 2: Run until specific time
         double current_time = get_current_time(model_handle);
         double target_time = current_time + 2.0;
-        std::cout << "\n2. Running until t=" << target_time << std::endl;
+        std::cout << "\n2. Running until t=" << target_time << '\n';
         int steps_until = run_processes_until_time(model_handle, target_time, 0.75, 1, 1);
         if (steps_until > 0) {
-            std::cout << "   Completed " << steps_until << " steps to reach target" << std::endl;
+            std::cout << "   Completed " << steps_until << " steps to reach target" << '\n';
         } else {
             std::cerr << "   Error running until time" << std::endl;
         }
@@ -100,15 +103,15 @@ public:
         double final_time = get_current_time(model_handle);
         double total_time = final_time - initial_time;
         std::cout << "\n✓ Enhanced model methods demo completed! Total time advanced: " 
-                  << std::fixed << std::setprecision(2) << total_time << std::endl;
+                  << std::fixed << std::setprecision(2) << total_time << '\n';
     }
     
     void run_controlled_simulation(double duration = 5.0, double dt = 1.0) {
         if (!initialized) return;
         
         std::cout << "\nRunning controlled simulation for " << duration 
-                  << " time units with dt=" << dt << std::endl;
-        std::cout << std::string(60, '=') << std::endl;
+                  << " time units with dt=" << dt << '\n';
+        std::cout << std::string(60, '=') << '\n';
         
         double start_time = get_current_time(model_handle);
         double target_time = start_time + duration;
@@ -127,7 +130,7 @@ public:
             
             std::cout << "\nStep " << (step + 1) << ": t=" 
                       << std::fixed << std::setprecision(2) << current_time 
-                      << " -> " << (current_time + step_dt) << std::endl;
+                      << " -> " << (current_time + step_dt) << '\n';
             
             // Generate time-dependent velocity field
             int points_generated = create_velocity_field(current_time, 5.0, 5.0, 0.1,
@@ -136,7 +139,7 @@ public:
             if (points_generated > 0) {
                 std::cout << "  Generated velocity field for t=" 
                           << std::fixed << std::setprecision(2) << current_time 
-                          << " (" << points_generated << " points)" << std::endl;
+                          << " (" << points_generated << " points)" << '\n';
                 
                 // Apply velocities using DataDrivenTectonics
                 int apply_result = apply_velocity_data(model_handle, 
@@ -144,7 +147,7 @@ public:
                                                      points_generated, step_dt, 3, 1.0);
                 
                 if (apply_result == 0) {
-                    std::cout << "  Applied velocity data with timer=" << step_dt << std::endl;
+                    std::cout << "  Applied velocity data with timer=" << step_dt << '\n';
                 } else {
                     std::cerr << "  Error applying velocity data" << std::endl;
                 }
@@ -154,7 +157,7 @@ public:
             double elapsed = run_processes_for_dt(model_handle, step_dt, 1, 1);
             if (elapsed >= 0) {
                 std::cout << "  Completed step in " 
-                          << std::fixed << std::setprecision(2) << elapsed << "s" << std::endl;
+                          << std::fixed << std::setprecision(2) << elapsed << "s" << '\n';
             } else {
                 std::cerr << "  Error running processes" << std::endl;
                 break;
@@ -169,7 +172,7 @@ public:
         double total_time = final_time - start_time;
         std::cout << "\n✓ Simulation completed! Ran for " 
                   << std::fixed << std::setprecision(2) << total_time 
-                  << " time units in " << step << " steps" << std::endl;
+                  << " time units in " << step << " steps" << '\n';
     }
 };
 
@@ -197,13 +200,13 @@ int main(int argc, char* argv[]) {
         // Run controlled simulation with time-dependent tectonics
         driver.run_controlled_simulation(5.0, 1.0);
         
-        std::cout << "\n🎉 All demonstrations completed successfully!" << std::endl;
+        std::cout << "\n🎉 All demonstrations completed successfully!" << '\n';
         
         // Get final simulation time
         double final_time = get_current_time(driver.model_handle);
         if (final_time >= 0) {
             std::cout << "Final simulation time: t=" 
-                      << std::fixed << std::setprecision(1) << final_time << std::endl;
+                      << std::fixed << std::setprecision(1) << final_time << '\n';
         }
         
         return 0;
@@ -242,7 +245,7 @@ void print_velocity_stats(const std::vector<double>& velocities, int num_points)
     
     std::cout << "  Velocity stats - Max: " 
               << std::fixed << std::setprecision(6) << max_vel
-              << ", Mean: " << mean_vel << std::endl;
+              << ", Mean: " << mean_vel << '\n';
 }
 
 /**
@@ -2,10 +2,28 @@
 #include <Python.h>
 #include <iostream>
 #include <cstring>
+#include <cstdio>
 #include <cmath>
+#include <map>
+#include <vector>
+#include <algorithm>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <chrono>
+#include <tuple>
+#include <memory>
+#include <atomic>
+#include <cstdlib>
+#include <cstddef>
+#include <string>
+#include <cstdint>
+#include <sys/mman.h>
+#include <unistd.h>
 
-// Include numpy headers
+// Include numpy headers (1.22 for the data memory handler API)
 #define NPY_NO_DEPRECATED_API NPY_1_7_API_VERSION
+#define NPY_TARGET_VERSION NPY_1_22_API_VERSION
 #include <numpy/arrayobject.h>
 
 static PyObject* gospl_module = nullptr;
@@ -22,15 +40,984 @@ static PyObject* get_dt_func = nullptr;
 // v2 redesigned coupling API
 static PyObject* set_surface_velocity_func   = nullptr;
 static PyObject* set_uplift_rate_func        = nullptr;
+static PyObject* accumulate_surface_velocity_func = nullptr;
 static PyObject* run_and_get_erosion_func    = nullptr;
 static PyObject* apply_drift_correction_func = nullptr;
+static PyObject* set_transfer_tolerance_func = nullptr;
+static PyObject* get_transfer_stats_func     = nullptr;
+static PyObject* declare_surface_points_func      = nullptr;
+static PyObject* set_surface_velocity_sparse_func = nullptr;
+static PyObject* set_uplift_rate_sparse_func      = nullptr;
+static PyObject* run_and_get_erosion_sparse_func  = nullptr;
+static PyObject* get_sparse_erosion_func          = nullptr;
+static PyObject* enable_speculation_func          = nullptr;
+static PyObject* speculate_next_interval_func     = nullptr;
+static PyObject* get_speculation_stats_func       = nullptr;
+static PyObject* register_plate_ids_func          = nullptr;
+static PyObject* set_euler_poles_func             = nullptr;
+static PyObject* register_forcing_callback_func   = nullptr;
+static PyObject* set_forcing_substeps_func        = nullptr;
+static PyObject* set_locality_ordering_func       = nullptr;
+static PyObject* set_active_set_func              = nullptr;
+static PyObject* get_active_set_stats_func        = nullptr;
+static PyObject* set_catchment_parallel_func      = nullptr;
+static PyObject* get_catchment_stats_func         = nullptr;
+static PyObject* set_incremental_depressions_func = nullptr;
+static PyObject* get_depression_stats_func        = nullptr;
+static PyObject* get_output_stats_func            = nullptr;
+static PyObject* set_gc_policy_func               = nullptr;
+static PyObject* collect_garbage_func             = nullptr;
+static PyObject* get_gc_stats_func                = nullptr;
+
+// Erosion rate (m/yr) at the query points of the last run_and_get_erosion()
+// call per handle; extrapolate_erosion() works from this without Python, so
+// it is read without the GIL and guarded by its own mutex.
+static std::map<ModelHandle, std::vector<double>> erosion_rates;
+static std::mutex erosion_rates_mutex;
+
+static void store_erosion_rate(ModelHandle handle, std::vector<double>&& rate) {
+    std::lock_guard<std::mutex> lock(erosion_rates_mutex);
+    erosion_rates[handle] = std::move(rate);
+}
+
+// Thread state saved after initialization when this library owns the
+// interpreter; API calls and speculation workers take the GIL per call.
+static PyThreadState* main_thread_state = nullptr;
+
+// Native entry point of each thread currently inside the interface, keyed by
+// its thread identifier (as in sys._current_frames()), while the sampling
+// profiler runs. Only touched with the GIL held; nested calls keep the
+// outermost entry.
+static std::atomic<bool> profiler_active{false};
+static std::map<unsigned long, const char*> profiler_entries;
+
+static bool profiler_enter(const char* entry) {
+    if (!profiler_active.load(std::memory_order_relaxed)) return false;
+    return profiler_entries.emplace(PyThread_get_thread_ident(), entry).second;
+}
+
+static void profiler_leave() {
+    profiler_entries.erase(PyThread_get_thread_ident());
+}
+
+// Speculative execution: after run_and_get_erosion() a worker thread runs the
+// next interval ahead of time. Every API call on the handle joins the worker
+// first, so the Python model never sees two callers at once.
+struct Speculation {
+    bool enabled = false;
+    std::thread worker;
+};
+static std::map<ModelHandle, Speculation> speculations;
+static std::mutex speculation_mutex;
+
+static void join_speculation(ModelHandle handle) {
+    std::thread worker;
+    {
+        std::lock_guard<std::mutex> lock(speculation_mutex);
+        auto it = speculations.find(handle);
+        if (it == speculations.end() || !it->second.worker.joinable()) return;
+        worker = std::move(it->second.worker);
+    }
+    worker.join();
+}
+
+static void join_all_speculations() {
+    std::vector<std::thread> workers;
+    {
+        std::lock_guard<std::mutex> lock(speculation_mutex);
+        for (auto& entry : speculations) {
+            if (entry.second.worker.joinable())
+                workers.push_back(std::move(entry.second.worker));
+        }
+    }
+    for (auto& worker : workers) worker.join();
+}
+
+static void launch_speculation(ModelHandle handle, double dt, int k, double power) {
+    std::lock_guard<std::mutex> lock(speculation_mutex);
+    auto it = speculations.find(handle);
+    if (it == speculations.end() || !it->second.enabled) return;
+    it->second.worker = std::thread([handle, dt, k, power]() {
+        PyGILState_STATE gil = PyGILState_Ensure();
+        const bool profiled = profiler_enter("speculate_next_interval");
+        PyObject* args = PyTuple_New(4);
+        PyTuple_SetItem(args, 0, PyLong_FromLong(handle));
+        PyTuple_SetItem(args, 1, PyFloat_FromDouble(dt));
+        PyTuple_SetItem(args, 2, PyLong_FromLong(k));
+        PyTuple_SetItem(args, 3, PyFloat_FromDouble(power));
+        PyObject* result = PyObject_CallObject(speculate_next_interval_func, args);
+        Py_DECREF(args);
+        if (!result) PyErr_Print();
+        Py_XDECREF(result);
+        if (profiled) profiler_leave();
+        PyGILState_Release(gil);
+    });
+}
+
+// Scope guard for every Python-calling entry point: waits for the handle's
+// speculation worker, then holds the GIL until the call returns.
+// The numpy allocator policy lives in a context variable, so threads
+// entering the interface pick it up here (see the numpy allocator below).
+static std::atomic<int> numpy_allocator_state{0};  // 0 unused, 1 on, 2 off
+static void sync_numpy_allocator();
+
+// The entry point defaults to the calling function, so that the sampling
+// profiler (below) can root each Python stack at the C function it came from.
+class ApiCall {
+public:
+    explicit ApiCall(ModelHandle handle = -1, const char* entry = __builtin_FUNCTION()) {
+        if (handle >= 0) join_speculation(handle);
+        gil_ = PyGILState_Ensure();
+        if (numpy_allocator_state.load(std::memory_order_relaxed)) sync_numpy_allocator();
+        profiled_ = profiler_enter(entry);
+    }
+    ~ApiCall() {
+        if (profiled_) profiler_leave();
+        PyGILState_Release(gil_);
+    }
+    ApiCall(const ApiCall&) = delete;
+    ApiCall& operator=(const ApiCall&) = delete;
+private:
+    PyGILState_STATE gil_;
+    bool profiled_;
+};
+
+// Buffered logging. Records go into a fixed ring of slots, a bounded queue
+// with a sequence number per slot, so producers claim a slot with one CAS and
+// never take a lock; a full ring drops the record (and counts it) rather than
+// stall the caller. A background thread writes the queued records in batches
+// with one flush per batch, waking every 100 ms, on errors and whenever half
+// a ring has been queued.
+namespace {
+
+const size_t kLogSlots  = 4096;  // power of two
+const size_t kLogSource = 32;
+const size_t kLogText   = 224;   // longer messages are truncated
+const char* const kLogNames[] = {"ERROR", "WARN", "INFO", "DEBUG"};
+
+struct LogSlot {
+    std::atomic<size_t> seq;
+    double time;
+    int level;
+    char source[kLogSource];
+    char text[kLogText];
+};
+
+struct Logger {
+    LogSlot slots[kLogSlots];
+    std::atomic<size_t> head{0};
+    std::atomic<int> level{GOSPL_LOG_INFO};
+    std::atomic<int> rank{-1};
+    std::atomic<int> rank_filter{-1};
+    std::atomic<long long> written{0};
+    std::atomic<long long> dropped{0};
+    std::atomic<bool> configured{false};
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    std::mutex drain_mutex;          // one consumer at a time
+    size_t tail = 0;                 // guarded by drain_mutex
+    FILE* out = nullptr;             // guarded by drain_mutex; null = stderr
+
+    std::once_flag started;
+    std::thread flusher;
+    std::mutex wake_mutex;
+    std::condition_variable wake;
+    bool stopping = false;           // guarded by wake_mutex
+
+    Logger() {
+        for (size_t i = 0; i < kLogSlots; ++i) slots[i].seq.store(i, std::memory_order_relaxed);
+    }
+};
+
+// Never destroyed: records may be queued from atexit handlers and threads
+// that outlive static destruction.
+Logger& logger() {
+    static Logger* instance = new Logger();
+    return *instance;
+}
+
+int log_rank() {
+    Logger& log = logger();
+    int rank = log.rank.load(std::memory_order_relaxed);
+    if (rank < 0) {
+        rank = 0;
+        for (const char* var : {"OMPI_COMM_WORLD_RANK", "PMI_RANK", "PMIX_RANK", "SLURM_PROCID"}) {
+            if (const char* value = std::getenv(var)) { rank = std::atoi(value); break; }
+        }
+        log.rank.store(rank, std::memory_order_relaxed);
+    }
+    return rank;
+}
+
+// Write out every record queued so far; the caller holds drain_mutex.
+size_t drain_log() {
+    Logger& log = logger();
+    FILE* out = log.out ? log.out : stderr;
+    const int rank = log_rank();
+    size_t count = 0;
+    for (;;) {
+        LogSlot& slot = log.slots[log.tail & (kLogSlots - 1)];
+        if (slot.seq.load(std::memory_order_acquire) != log.tail + 1) break;
+        std::fprintf(out, "%.6f rank=%d %s %s: %s\n", slot.time, rank,
+                     kLogNames[slot.level], slot.source, slot.text);
+        slot.seq.store(log.tail + kLogSlots, std::memory_order_release);
+        ++log.tail;
+        ++count;
+    }
+    if (count) {
+        std::fflush(out);
+        log.written.fetch_add((long long)count, std::memory_order_relaxed);
+    }
+    return count;
+}
+
+void flush_loop() {
+    Logger& log = logger();
+    std::unique_lock<std::mutex> lock(log.wake_mutex);
+    while (!log.stopping) {
+        log.wake.wait_for(lock, std::chrono::milliseconds(100));
+        lock.unlock();
+        {
+            std::lock_guard<std::mutex> drain(log.drain_mutex);
+            drain_log();
+        }
+        lock.lock();
+    }
+}
+
+void stop_log_flusher() {
+    Logger& log = logger();
+    {
+        std::lock_guard<std::mutex> lock(log.wake_mutex);
+        log.stopping = true;
+    }
+    log.wake.notify_all();
+    if (log.flusher.joinable()) log.flusher.join();
+    std::lock_guard<std::mutex> drain(log.drain_mutex);
+    drain_log();
+}
+
+void log_record(int level, const char* source, const char* text) {
+    Logger& log = logger();
+    level = std::max(int(GOSPL_LOG_ERROR), std::min(level, int(GOSPL_LOG_DEBUG)));
+    if (level > log.level.load(std::memory_order_relaxed)) return;
+    const int filter = log.rank_filter.load(std::memory_order_relaxed);
+    if (filter >= 0 && level != GOSPL_LOG_ERROR && log_rank() != filter) return;
+
+    std::call_once(log.started, [&log]() {
+        log.flusher = std::thread(flush_loop);
+        std::atexit(stop_log_flusher);
+    });
+
+    size_t pos = log.head.load(std::memory_order_relaxed);
+    LogSlot* slot;
+    for (;;) {
+        slot = &log.slots[pos & (kLogSlots - 1)];
+        const size_t seq = slot->seq.load(std::memory_order_acquire);
+        const std::ptrdiff_t diff = std::ptrdiff_t(seq) - std::ptrdiff_t(pos);
+        if (diff == 0) {
+            if (log.head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+        } else if (diff < 0) {
+            log.dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        } else {
+            pos = log.head.load(std::memory_order_relaxed);
+        }
+    }
+    slot->time = std::chrono::duration<double>(std::chrono::steady_clock::now() - log.start).count();
+    slot->level = level;
+    std::snprintf(slot->source, kLogSource, "%s", source ? source : "");
+    std::snprintf(slot->text, kLogText, "%s", text ? text : "");
+    slot->seq.store(pos + 1, std::memory_order_release);
+
+    if (level == GOSPL_LOG_ERROR || (pos & (kLogSlots / 2 - 1)) == 0) log.wake.notify_one();
+}
+
+}  // namespace
+
+// Python side of the logger: gospl_model_ext.log.emit() ends up here.
+static PyObject* log_emit(PyObject*, PyObject* args) {
+    int level;
+    const char* source;
+    const char* text;
+    if (!PyArg_ParseTuple(args, "iss", &level, &source, &text)) return nullptr;
+    log_record(level, source, text);
+    Py_RETURN_NONE;
+}
+
+static PyMethodDef log_emit_def = {
+    "log_emit", log_emit, METH_VARARGS,
+    "Queue a record in the native log ring."
+};
+
+// Push the log level to gospl_model_ext.log and route Python's stdout and
+// stderr through the logger (or restore them). Requires the GIL.
+static void configure_python_log(bool route) {
+    PyObject* module = PyImport_ImportModule("gospl_model_ext.log");
+    PyObject* level = module ? PyLong_FromLong(logger().level.load()) : nullptr;
+    PyObject* result = nullptr;
+    if (level && PyObject_SetAttrString(module, "level", level) == 0)
+        result = PyObject_CallMethod(module, "route_prints", "(O)", route ? Py_True : Py_False);
+    if (!result) PyErr_Clear();
+    Py_XDECREF(result);
+    Py_XDECREF(level);
+    Py_XDECREF(module);
+}
+
+// Sampling profiler. A timer thread with its own thread state takes the GIL
+// at the sampling rate and records the Python stack of every other thread
+// that is inside the interface or running Python code, rooted at the C entry
+// point registered by ApiCall. Samples are wall-clock: a thread waiting in
+// native code still counts at its Python call site, and one holding the GIL
+// in native code delays the sample until it lets go (so Python calls much
+// shorter than the interpreter's 5 ms switch interval, which hand the GIL
+// over as they return, are under-sampled). Identical stacks are
+// counted in folded form ("entry;frame;frame count") and written out when
+// the profiler stops, at the latest in finalize_gospl_extensions().
+namespace {
+
+struct Profiler {
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool stopping = false;           // guarded by mutex
+    std::thread sampler;
+    std::chrono::microseconds interval{10000};
+    std::string path;
+    std::map<std::string, long long> stacks;  // sampler thread only while running
+    std::atomic<long long> samples{0};
+    std::atomic<long long> distinct{0};
+    std::atomic<long long> sampling_ns{0};     // time the sampler held the GIL
+};
+
+Profiler& profiler() {
+    static Profiler* instance = new Profiler();
+    return *instance;
+}
+
+std::string frame_label(PyFrameObject* frame) {
+    PyCodeObject* code = PyFrame_GetCode(frame);
+    const char* name = PyUnicode_AsUTF8(code->co_name);
+    const char* file = PyUnicode_AsUTF8(code->co_filename);
+    if (!name || !file) PyErr_Clear();
+    std::string label = name ? name : "?";
+    std::string path = file ? file : "?";
+    label += " (" + path.substr(path.find_last_of('/') + 1) + ":" +
+             std::to_string(PyFrame_GetLineNumber(frame)) + ")";
+    Py_DECREF(code);
+    return label;
+}
+
+// Record one sample of every other thread; requires the GIL. Frames come from
+// sys._current_frames(), which walks the thread states under the
+// interpreter's lock; threads inside the interface without a Python frame are
+// counted under their entry point alone.
+void sample_threads(Profiler& p, unsigned long self) {
+    PyObject* current_frames = PySys_GetObject("_current_frames");
+    PyObject* current = current_frames ? PyObject_CallNoArgs(current_frames) : nullptr;
+    if (!current || !PyDict_Check(current)) {
+        Py_XDECREF(current);
+        PyErr_Clear();
+        return;
+    }
+    std::vector<std::string> frames;
+    auto record = [&](const char* entry, PyFrameObject* frame) {
+        frames.clear();
+        Py_XINCREF(frame);
+        while (frame) {
+            frames.push_back(frame_label(frame));
+            PyFrameObject* back = PyFrame_GetBack(frame);
+            Py_DECREF(frame);
+            frame = back;
+        }
+        std::string stack = entry;
+        for (auto it = frames.rbegin(); it != frames.rend(); ++it) {
+            stack += ';';
+            stack += *it;
+        }
+        if (p.stacks[stack]++ == 0) p.distinct.fetch_add(1, std::memory_order_relaxed);
+        p.samples.fetch_add(1, std::memory_order_relaxed);
+    };
+
+    PyObject* key;
+    PyObject* value;
+    Py_ssize_t pos = 0;
+    while (PyDict_Next(current, &pos, &key, &value)) {
+        const unsigned long id = PyLong_AsUnsignedLong(key);
+        if (id == self || !PyFrame_Check(value)) continue;
+        auto entry = profiler_entries.find(id);
+        record(entry != profiler_entries.end() ? entry->second : "[python]",
+               reinterpret_cast<PyFrameObject*>(value));
+    }
+    for (const auto& entry : profiler_entries) {
+        if (entry.first == self) continue;
+        PyObject* id = PyLong_FromUnsignedLong(entry.first);
+        const int seen = id ? PyDict_Contains(current, id) : -1;
+        Py_XDECREF(id);
+        if (seen == 0) record(entry.second, nullptr);
+    }
+    PyErr_Clear();
+    Py_DECREF(current);
+}
+
+void sample_loop() {
+    Profiler& p = profiler();
+    PyGILState_STATE gil = PyGILState_Ensure();
+    const unsigned long ident = PyThread_get_thread_ident();
+    PyThreadState* self = PyEval_SaveThread();
+    std::unique_lock<std::mutex> lock(p.mutex);
+    auto next = std::chrono::steady_clock::now();
+    while (!p.stopping) {
+        next += p.interval;
+        if (p.wake.wait_until(lock, next, [&p]() { return p.stopping; })) break;
+        lock.unlock();
+        PyEval_RestoreThread(self);
+        const auto start = std::chrono::steady_clock::now();
+        sample_threads(p, ident);
+        const auto end = std::chrono::steady_clock::now();
+        PyEval_SaveThread();
+        p.sampling_ns.fetch_add(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count(),
+            std::memory_order_relaxed);
+        // After a long wait for the GIL, resume the cadence instead of bursting
+        if (end > next) next = end;
+        lock.lock();
+    }
+    lock.unlock();
+    PyEval_RestoreThread(self);
+    PyGILState_Release(gil);
+}
+
+// Stop the sampler and write the folded stacks; returns the number of
+// distinct stacks written, or -1 if the profiler was not running or the
+// output could not be opened.
+int stop_profiler() {
+    Profiler& p = profiler();
+    if (!p.sampler.joinable()) return -1;
+    {
+        std::lock_guard<std::mutex> lock(p.mutex);
+        p.stopping = true;
+    }
+    p.wake.notify_all();
+    // The sampler needs the GIL to finish its last sample
+    if (Py_IsInitialized() && PyGILState_Check()) {
+        Py_BEGIN_ALLOW_THREADS
+        p.sampler.join();
+        Py_END_ALLOW_THREADS
+    } else {
+        p.sampler.join();
+    }
+    profiler_active = false;
+
+    std::string name = p.path;
+    const size_t at = name.find("%r");
+    if (at != std::string::npos) name.replace(at, 2, std::to_string(log_rank()));
+    FILE* out = std::fopen(name.c_str(), "w");
+    int written = -1;
+    if (out) {
+        for (const auto& stack : p.stacks)
+            std::fprintf(out, "%s %lld\n", stack.first.c_str(), stack.second);
+        std::fclose(out);
+        written = (int)p.stacks.size();
+        std::string text = std::to_string(p.samples.load()) + " samples, " +
+                           std::to_string(written) + " stacks written to " + name;
+        log_record(GOSPL_LOG_INFO, "gospl_profiler", text.c_str());
+    } else {
+        std::string text = "cannot write profile to " + name;
+        log_record(GOSPL_LOG_ERROR, "gospl_profiler", text.c_str());
+    }
+    p.stacks.clear();
+    return written;
+}
+
+}  // namespace
+
+// NumPy data allocator. Installed with PyDataMem_SetHandler, it keeps the
+// extension's array buffers out of the heap shared with the host:
+// - below 4 KiB, blocks come from the system allocator (posix_memalign), so
+//   small arrays still share the host's malloc heap;
+// - from 4 KiB to 64 MiB, blocks are rounded up to a power of two and carved
+//   from an arena reserved once (optionally huge-page backed, or supplied by
+//   the host); freed blocks go to a free list per size class and are reused,
+//   and blocks past the end of the arena come from the backing allocator;
+// - above 64 MiB, blocks are mapped and unmapped individually.
+// Every block starts with a 64-byte header recording how it was obtained, so
+// frees do not depend on the size numpy passes. Data is 64-byte aligned except
+// in memory from a host allocator, which only guarantees 16 bytes.
+namespace {
+
+const int kPoolMinShift = 12;
+const int kPoolMaxShift = 26;
+const int kPoolClasses = kPoolMaxShift - kPoolMinShift + 1;
+const size_t kBlockHeader = 64;
+const size_t kHugePage = size_t(2) << 20;
+const uint32_t kBlockMagic = 0x67506d41;
+
+enum BlockKind : uint32_t { kBlockSmall, kBlockPooled, kBlockLarge };
+
+struct BlockHeader {
+    uint32_t magic;
+    uint32_t kind;
+    int32_t cls;
+    size_t size;      // bytes requested
+    size_t mapped;    // bytes obtained from the backing allocator (large)
+};
+static_assert(sizeof(BlockHeader) <= kBlockHeader, "block header too large");
+
+struct NumpyAllocator {
+    std::mutex mutex;
+    // Configuration, fixed once the arena exists
+    size_t arena_bytes = size_t(1) << 30;
+    bool huge_pages = false;
+    GosplHostAlloc host_alloc = nullptr;
+    GosplHostFree host_free = nullptr;
+    void* host_data = nullptr;
+    // Arena and pools
+    char* arena = nullptr;
+    size_t arena_size = 0;
+    size_t arena_used = 0;
+    std::vector<void*> pool[kPoolClasses];
+    // Statistics
+    long long allocations = 0;
+    long long pool_hits = 0;
+    long long fallbacks = 0;
+    long long in_use = 0;
+    long long peak = 0;
+    // Python side
+    PyObject* capsule = nullptr;
+};
+
+NumpyAllocator& numpy_allocator() {
+    static NumpyAllocator* a = new NumpyAllocator();  // outlives arrays freed at exit
+    return *a;
+}
+
+// Backing memory: the host's allocator, or anonymous mappings (huge pages
+// when asked for and available, else transparent huge pages).
+void* backing_alloc(NumpyAllocator& a, size_t bytes) {
+    if (a.host_alloc) return a.host_alloc(bytes, a.host_data);
+    void* p = MAP_FAILED;
+#ifdef MAP_HUGETLB
+    // Reserved up front: without free huge pages this fails here instead of
+    // faulting on first touch.
+    if (a.huge_pages && bytes % kHugePage == 0)
+        p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+                 MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+#endif
+    if (p == MAP_FAILED)
+        p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+                 MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (p == MAP_FAILED) return nullptr;
+#ifdef MADV_HUGEPAGE
+    if (a.huge_pages) madvise(p, bytes, MADV_HUGEPAGE);
+#endif
+    return p;
+}
+
+void backing_free(NumpyAllocator& a, void* p, size_t bytes) {
+    if (a.host_alloc) {
+        if (a.host_free) a.host_free(p, bytes, a.host_data);
+    } else {
+        munmap(p, bytes);
+    }
+}
+
+int size_class(size_t bytes) {
+    int shift = kPoolMinShift;
+    while ((size_t(1) << shift) < bytes) ++shift;
+    return shift - kPoolMinShift;
+}
+
+// Returns the block start; *zeroed tells whether its memory is known zero.
+char* acquire_block(NumpyAllocator& a, size_t size, BlockKind* kind, int* cls, size_t* mapped,
+                    bool* zeroed) {
+    const size_t total = size + kBlockHeader;
+    *cls = -1;
+    *mapped = 0;
+    *zeroed = false;
+    if (total < (size_t(1) << kPoolMinShift)) {
+        *kind = kBlockSmall;
+        void* p = nullptr;
+        return posix_memalign(&p, kBlockHeader, total) == 0 ? static_cast<char*>(p) : nullptr;
+    }
+    if (total > (size_t(1) << kPoolMaxShift)) {
+        *kind = kBlockLarge;
+        *mapped = a.huge_pages ? (total + kHugePage - 1) / kHugePage * kHugePage : total;
+        std::lock_guard<std::mutex> lock(a.mutex);
+        *zeroed = !a.host_alloc;
+        return static_cast<char*>(backing_alloc(a, *mapped));
+    }
+
+    *kind = kBlockPooled;
+    *cls = size_class(total);
+    const size_t block = size_t(1) << (*cls + kPoolMinShift);
+    std::lock_guard<std::mutex> lock(a.mutex);
+    std::vector<void*>& free_list = a.pool[*cls];
+    if (!free_list.empty()) {
+        char* p = static_cast<char*>(free_list.back());
+        free_list.pop_back();
+        ++a.pool_hits;
+        return p;
+    }
+    if (!a.arena && a.arena_bytes) {
+        a.arena = static_cast<char*>(backing_alloc(a, a.arena_bytes));
+        a.arena_size = a.arena ? a.arena_bytes : 0;
+    }
+    // Blocks are aligned to their size (pages at most) so they can be trimmed.
+    const size_t align = std::min(block, size_t(4096));
+    const size_t offset = (a.arena_used + align - 1) / align * align;
+    if (a.arena && offset + block <= a.arena_size) {
+        a.arena_used = offset + block;
+        *zeroed = !a.host_alloc;
+        return a.arena + offset;
+    }
+    ++a.fallbacks;
+    *zeroed = !a.host_alloc;
+    return static_cast<char*>(backing_alloc(a, block));
+}
+
+void* allocate(NumpyAllocator& a, size_t size, bool zero) {
+    BlockKind kind;
+    int cls;
+    size_t mapped;
+    bool zeroed;
+    char* block = acquire_block(a, size, &kind, &cls, &mapped, &zeroed);
+    if (!block) return nullptr;
+    BlockHeader* h = reinterpret_cast<BlockHeader*>(block);
+    h->magic = kBlockMagic;
+    h->kind = kind;
+    h->cls = cls;
+    h->size = size;
+    h->mapped = mapped;
+    char* data = block + kBlockHeader;
+    if (zero && !zeroed) std::memset(data, 0, size);
+    std::lock_guard<std::mutex> lock(a.mutex);
+    ++a.allocations;
+    a.in_use += (long long)size;
+    a.peak = std::max(a.peak, a.in_use);
+    return data;
+}
+
+void release(NumpyAllocator& a, void* data) {
+    if (!data) return;
+    char* block = static_cast<char*>(data) - kBlockHeader;
+    BlockHeader* h = reinterpret_cast<BlockHeader*>(block);
+    if (h->magic != kBlockMagic) return;  // not ours; leak rather than corrupt
+    h->magic = 0;
+    std::lock_guard<std::mutex> lock(a.mutex);
+    a.in_use -= (long long)h->size;
+    if (h->kind == kBlockSmall) {
+        std::free(block);
+    } else if (h->kind == kBlockLarge) {
+        backing_free(a, block, h->mapped);
+    } else {
+        a.pool[h->cls].push_back(block);
+    }
+}
+
+void* npy_alloc_malloc(void* ctx, size_t size) {
+    return allocate(*static_cast<NumpyAllocator*>(ctx), size, false);
+}
+
+void* npy_alloc_calloc(void* ctx, size_t nelem, size_t elsize) {
+    if (elsize && nelem > SIZE_MAX / elsize) return nullptr;
+    return allocate(*static_cast<NumpyAllocator*>(ctx), nelem * elsize, true);
+}
+
+void* npy_alloc_realloc(void* ctx, void* ptr, size_t new_size) {
+    NumpyAllocator& a = *static_cast<NumpyAllocator*>(ctx);
+    if (!ptr) return allocate(a, new_size, false);
+    BlockHeader* h = reinterpret_cast<BlockHeader*>(static_cast<char*>(ptr) - kBlockHeader);
+    if (h->magic != kBlockMagic) return nullptr;
+    // Shrinking, or growing within the block's size class, keeps the block.
+    if (h->kind == kBlockPooled &&
+        new_size + kBlockHeader <= (size_t(1) << (h->cls + kPoolMinShift)) &&
+        (h->cls == 0 || new_size + kBlockHeader > (size_t(1) << (h->cls + kPoolMinShift - 1)))) {
+        std::lock_guard<std::mutex> lock(a.mutex);
+        a.in_use += (long long)new_size - (long long)h->size;
+        a.peak = std::max(a.peak, a.in_use);
+        h->size = new_size;
+        return ptr;
+    }
+    void* moved = allocate(a, new_size, false);
+    if (!moved) return nullptr;
+    std::memcpy(moved, ptr, std::min(h->size, new_size));
+    release(a, ptr);
+    return moved;
+}
+
+void npy_alloc_free(void* ctx, void* ptr, size_t /*size*/) {
+    release(*static_cast<NumpyAllocator*>(ctx), ptr);
+}
+
+PyDataMem_Handler numpy_handler = {
+    "gospl_arena",
+    1,
+    {&numpy_allocator(), npy_alloc_malloc, npy_alloc_calloc, npy_alloc_realloc, npy_alloc_free}
+};
+
+}  // namespace
+
+static void sync_numpy_allocator() {
+    NumpyAllocator& a = numpy_allocator();
+    if (!a.capsule) return;
+    const bool on = numpy_allocator_state.load() == 1;
+    PyObject* current = PyDataMem_GetHandler();
+    if (current && (current == a.capsule) != on) {
+        // NULL restores numpy's default policy
+        PyObject* old = PyDataMem_SetHandler(on ? a.capsule : nullptr);
+        Py_XDECREF(old);
+    }
+    Py_XDECREF(current);
+    PyErr_Clear();
+}
+
+// Native query kernel of gospl_model_ext.sphere_index.CubeSphereIndex.
+// The index (unit vectors stored bucket by bucket, bucket CSR and per-bucket
+// neighbour CSR) is built in numpy; this scans the candidate buckets of each
+// query and keeps the k smallest chord distances. Queries are split across
+// threads with the GIL released. Unfilled slots keep an infinite distance,
+// which sends the query to the exact fallback on the Python side.
+static void sphere_knn_range(const double* pts, const npy_int64* ids,
+                             const npy_int64* bucket_start, const npy_int64* nbr_start,
+                             const npy_int64* nbrs, const double* queries,
+                             const npy_int64* query_bucket, int k,
+                             npy_intp lo, npy_intp hi, double* dist, npy_int64* idx) {
+    for (npy_intp q = lo; q < hi; ++q) {
+        double* best_d = dist + q * k;
+        npy_int64* best_i = idx + q * k;
+        std::fill(best_d, best_d + k, HUGE_VAL);
+        std::fill(best_i, best_i + k, npy_int64(-1));
+        const double qx = queries[3 * q], qy = queries[3 * q + 1], qz = queries[3 * q + 2];
+        const npy_int64 cell = query_bucket[q];
+        for (npy_int64 n = nbr_start[cell]; n < nbr_start[cell + 1]; ++n) {
+            const npy_int64 b = nbrs[n];
+            for (npy_int64 p = bucket_start[b]; p < bucket_start[b + 1]; ++p) {
+                const double dx = pts[3 * p] - qx;
+                const double dy = pts[3 * p + 1] - qy;
+                const double dz = pts[3 * p + 2] - qz;
+                const double d2 = dx * dx + dy * dy + dz * dz;
+                if (d2 >= best_d[k - 1]) continue;
+                int j = k - 1;
+                while (j > 0 && best_d[j - 1] > d2) {
+                    best_d[j] = best_d[j - 1];
+                    best_i[j] = best_i[j - 1];
+                    --j;
+                }
+                best_d[j] = d2;
+                best_i[j] = p;
+            }
+        }
+        for (int j = 0; j < k; ++j) {
+            best_d[j] = std::sqrt(best_d[j]);
+            if (best_i[j] >= 0) best_i[j] = ids[best_i[j]];
+        }
+    }
+}
+
+static PyObject* sphere_knn(PyObject*, PyObject* args) {
+    PyObject* objs[7];
+    int k, workers;
+    if (!PyArg_ParseTuple(args, "OOOOOOOii", &objs[0], &objs[1], &objs[2], &objs[3],
+                          &objs[4], &objs[5], &objs[6], &k, &workers)) return nullptr;
+    if (k < 1) {
+        PyErr_SetString(PyExc_ValueError, "k must be positive");
+        return nullptr;
+    }
+    const int types[7] = {NPY_DOUBLE, NPY_INT64, NPY_INT64, NPY_INT64, NPY_INT64,
+                          NPY_DOUBLE, NPY_INT64};
+    PyArrayObject* arr[7] = {nullptr};
+    for (int i = 0; i < 7; ++i) {
+        arr[i] = (PyArrayObject*)PyArray_FROMANY(objs[i], types[i], 1, 2, NPY_ARRAY_IN_ARRAY);
+        if (!arr[i]) {
+            for (int j = 0; j < i; ++j) Py_DECREF(arr[j]);
+            return nullptr;
+        }
+    }
+
+    const npy_intp nq = PyArray_DIM(arr[6], 0);
+    npy_intp dims[2] = {nq, k};
+    PyObject* dist = PyArray_SimpleNew(2, dims, NPY_DOUBLE);
+    PyObject* idx = PyArray_SimpleNew(2, dims, NPY_INT64);
+    if (dist && idx) {
+        const double* pts = (const double*)PyArray_DATA(arr[0]);
+        const npy_int64* ids = (const npy_int64*)PyArray_DATA(arr[1]);
+        const npy_int64* bstart = (const npy_int64*)PyArray_DATA(arr[2]);
+        const npy_int64* nstart = (const npy_int64*)PyArray_DATA(arr[3]);
+        const npy_int64* nbrs = (const npy_int64*)PyArray_DATA(arr[4]);
+        const double* queries = (const double*)PyArray_DATA(arr[5]);
+        const npy_int64* qbucket = (const npy_int64*)PyArray_DATA(arr[6]);
+        double* d = (double*)PyArray_DATA((PyArrayObject*)dist);
+        npy_int64* ix = (npy_int64*)PyArray_DATA((PyArrayObject*)idx);
+
+        const npy_intp min_per_thread = 4096;
+        npy_intp nthreads = std::max<npy_intp>(1, std::min<npy_intp>(workers, nq / min_per_thread));
+        Py_BEGIN_ALLOW_THREADS
+        std::vector<std::thread> threads;
+        const npy_intp chunk = (nq + nthreads - 1) / nthreads;
+        for (npy_intp t = 1; t < nthreads; ++t) {
+            const npy_intp lo = t * chunk, hi = std::min(nq, lo + chunk);
+            threads.emplace_back(sphere_knn_range, pts, ids, bstart, nstart, nbrs,
+                                 queries, qbucket, k, lo, hi, d, ix);
+        }
+        sphere_knn_range(pts, ids, bstart, nstart, nbrs, queries, qbucket, k,
+                         0, std::min(nq, chunk), d, ix);
+        for (auto& th : threads) th.join();
+        Py_END_ALLOW_THREADS
+    }
+    for (int i = 0; i < 7; ++i) Py_DECREF(arr[i]);
+    if (!dist || !idx) {
+        Py_XDECREF(dist);
+        Py_XDECREF(idx);
+        return nullptr;
+    }
+    return Py_BuildValue("(NN)", dist, idx);
+}
+
+static PyMethodDef sphere_knn_def = {
+    "sphere_knn", sphere_knn, METH_VARARGS, "k-nearest scan of a cube-sphere bucket index."
+};
+
+// Native sweep of gospl_model_ext.catchments: solves (I - W^T) x = b basin by
+// basin. Basins are disjoint, so threads taking them from a shared counter
+// (largest first) never touch the same nodes. Each basin is swept in
+// topological order (Kahn); a basin with a cycle clears `ok` and the Python
+// side falls back to goSPL's global solve.
+static void catchment_sweep(const npy_int64* rcv, const double* wght, int ndir,
+                            const npy_int64* nodes, const npy_int64* start,
+                            const npy_int64* schedule, npy_intp nbasins, npy_intp n,
+                            double* x, npy_int64* indeg, std::atomic<npy_intp>* next,
+                            std::atomic<bool>* ok) {
+    std::vector<npy_int64> queue;
+    for (npy_intp t = next->fetch_add(1); t < nbasins; t = next->fetch_add(1)) {
+        const npy_int64 b = schedule[t];
+        const npy_int64* first = nodes + start[b];
+        const npy_int64* last = nodes + start[b + 1];
+        for (const npy_int64* p = first; p != last; ++p) {
+            for (int k = 0; k < ndir; ++k) {
+                const npy_int64 r = rcv[*p * ndir + k];
+                if (r >= 0 && r < n && r != *p && wght[*p * ndir + k] > 0.0) ++indeg[r];
+            }
+        }
+        queue.clear();
+        for (const npy_int64* p = first; p != last; ++p) {
+            if (indeg[*p] == 0) queue.push_back(*p);
+        }
+        for (size_t head = 0; head < queue.size(); ++head) {
+            const npy_int64 i = queue[head];
+            for (int k = 0; k < ndir; ++k) {
+                const npy_int64 r = rcv[i * ndir + k];
+                const double w = wght[i * ndir + k];
+                if (r < 0 || r >= n || r == i || !(w > 0.0)) continue;
+                x[r] += w * x[i];
+                if (--indeg[r] == 0) queue.push_back(r);
+            }
+        }
+        if ((npy_int64)queue.size() != last - first) ok->store(false);
+    }
+}
+
+static PyObject* catchment_accumulate(PyObject*, PyObject* args) {
+    PyObject* objs[6];
+    int threads;
+    if (!PyArg_ParseTuple(args, "OOOOOOi", &objs[0], &objs[1], &objs[2], &objs[3],
+                          &objs[4], &objs[5], &threads)) return nullptr;
+    const int types[6] = {NPY_INT64, NPY_DOUBLE, NPY_DOUBLE, NPY_INT64, NPY_INT64, NPY_INT64};
+    const int ndims[6] = {2, 2, 1, 1, 1, 1};
+    PyArrayObject* arr[6] = {nullptr};
+    for (int i = 0; i < 6; ++i) {
+        arr[i] = (PyArrayObject*)PyArray_FROMANY(objs[i], types[i], ndims[i], ndims[i],
+                                                 NPY_ARRAY_IN_ARRAY);
+        if (!arr[i]) {
+            for (int j = 0; j < i; ++j) Py_DECREF(arr[j]);
+            return nullptr;
+        }
+    }
+    const npy_intp n = PyArray_DIM(arr[0], 0);
+    const int ndir = (int)PyArray_DIM(arr[0], 1);
+    const npy_intp nbasins = PyArray_DIM(arr[5], 0);
+    if (PyArray_DIM(arr[1], 0) != n || PyArray_DIM(arr[1], 1) != ndir ||
+        PyArray_DIM(arr[2], 0) != n || PyArray_DIM(arr[3], 0) != n ||
+        PyArray_DIM(arr[4], 0) != nbasins + 1) {
+        for (int i = 0; i < 6; ++i) Py_DECREF(arr[i]);
+        PyErr_SetString(PyExc_ValueError, "inconsistent catchment array shapes");
+        return nullptr;
+    }
+
+    npy_intp dims[1] = {n};
+    PyObject* x = PyArray_SimpleNew(1, dims, NPY_DOUBLE);
+    bool success = false;
+    if (x) {
+        double* xd = (double*)PyArray_DATA((PyArrayObject*)x);
+        std::memcpy(xd, PyArray_DATA(arr[2]), n * sizeof(double));
+        const npy_int64* rcv = (const npy_int64*)PyArray_DATA(arr[0]);
+        const double* wght = (const double*)PyArray_DATA(arr[1]);
+        const npy_int64* nodes = (const npy_int64*)PyArray_DATA(arr[3]);
+        const npy_int64* start = (const npy_int64*)PyArray_DATA(arr[4]);
+        const npy_int64* schedule = (const npy_int64*)PyArray_DATA(arr[5]);
+        std::vector<npy_int64> indeg(n, 0);
+        std::atomic<npy_intp> next(0);
+        std::atomic<bool> ok(true);
+        const int nthreads = (int)std::max<npy_intp>(1, std::min<npy_intp>(threads, nbasins));
+
+        Py_BEGIN_ALLOW_THREADS
+        std::vector<std::thread> pool;
+        for (int t = 1; t < nthreads; ++t) {
+            pool.emplace_back(catchment_sweep, rcv, wght, ndir, nodes, start, schedule,
+                              nbasins, n, xd, indeg.data(), &next, &ok);
+        }
+        catchment_sweep(rcv, wght, ndir, nodes, start, schedule, nbasins, n, xd,
+                        indeg.data(), &next, &ok);
+        for (auto& th : pool) th.join();
+        Py_END_ALLOW_THREADS
+        success = ok.load();
+    }
+    for (int i = 0; i < 6; ++i) Py_DECREF(arr[i]);
+    if (!x) return nullptr;
+    return Py_BuildValue("(NO)", x, success ? Py_True : Py_False);
+}
+
+static PyMethodDef catchment_accumulate_def = {
+    "catchment_accumulate", catchment_accumulate, METH_VARARGS,
+    "Per-basin parallel solve of the flow accumulation system."
+};
+
+// Hand the native kernels to the extension modules that use them. Optional:
+// the Python code falls back to its own implementation when this fails.
+static void install_native_kernel(const char* module_name, const char* attr, PyMethodDef* def) {
+    PyObject* module = PyImport_ImportModule(module_name);
+    PyObject* fn = module ? PyCFunction_New(def, nullptr) : nullptr;
+    if (!fn || PyObject_SetAttrString(module, attr, fn) != 0) PyErr_Clear();
+    Py_XDECREF(fn);
+    Py_XDECREF(module);
+}
+
+static void install_native_kernels() {
+    install_native_kernel("gospl_model_ext.sphere_index", "_native_knn", &sphere_knn_def);
+    install_native_kernel("gospl_model_ext.catchments", "_native_accumulate",
+                          &catchment_accumulate_def);
+}
+
+// Done before the interface is imported so that its own messages are logged.
+static void install_python_log() {
+    install_native_kernel("gospl_model_ext.log", "_native_emit", &log_emit_def);
+    if (logger().configured.load()) configure_python_log(true);
+}
 
 int initialize_gospl_extensions() {
+    // Re-initialization: take the GIL back before touching the interpreter
+    if (main_thread_state) {
+        PyEval_RestoreThread(main_thread_state);
+        main_thread_state = nullptr;
+    }
+
     // Initialize Python interpreter
+    bool owns_interpreter = false;
     if (!Py_IsInitialized()) {
+        owns_interpreter = true;
         Py_Initialize();
         if (!Py_IsInitialized()) {
-            std::cerr << "Failed to initialize Python interpreter" << std::endl;
+            log_record(GOSPL_LOG_ERROR, "initialize_gospl_extensions",
+                       "failed to initialize the Python interpreter");
             return -1;
         }
     }
@@ -45,11 +1032,14 @@ int initialize_gospl_extensions() {
     PyRun_SimpleString("sys.path.insert(0, '..')");
     PyRun_SimpleString("sys.path.insert(0, '.')");
     
+    install_python_log();
+
     // Import our Python module
     gospl_module = PyImport_ImportModule("gospl_python_interface");
     if (!gospl_module) {
         PyErr_Print();
-        std::cerr << "Failed to import gospl_python_interface module" << std::endl;
+        log_record(GOSPL_LOG_ERROR, "initialize_gospl_extensions",
+                   "failed to import gospl_python_interface");
         return -1;
     }
     
@@ -67,24 +1057,89 @@ int initialize_gospl_extensions() {
     // v2 redesigned coupling API
     set_surface_velocity_func   = PyObject_GetAttrString(gospl_module, "set_surface_velocity");
     set_uplift_rate_func        = PyObject_GetAttrString(gospl_module, "set_uplift_rate");
+    accumulate_surface_velocity_func = PyObject_GetAttrString(gospl_module, "accumulate_surface_velocity");
     run_and_get_erosion_func    = PyObject_GetAttrString(gospl_module, "run_and_get_erosion");
     apply_drift_correction_func = PyObject_GetAttrString(gospl_module, "apply_drift_correction");
+    set_transfer_tolerance_func = PyObject_GetAttrString(gospl_module, "set_transfer_tolerance");
+    get_transfer_stats_func     = PyObject_GetAttrString(gospl_module, "get_transfer_stats");
+    declare_surface_points_func      = PyObject_GetAttrString(gospl_module, "declare_surface_points");
+    set_surface_velocity_sparse_func = PyObject_GetAttrString(gospl_module, "set_surface_velocity_sparse");
+    set_uplift_rate_sparse_func      = PyObject_GetAttrString(gospl_module, "set_uplift_rate_sparse");
+    run_and_get_erosion_sparse_func  = PyObject_GetAttrString(gospl_module, "run_and_get_erosion_sparse");
+    get_sparse_erosion_func          = PyObject_GetAttrString(gospl_module, "get_sparse_erosion");
+    enable_speculation_func          = PyObject_GetAttrString(gospl_module, "enable_speculation");
+    speculate_next_interval_func     = PyObject_GetAttrString(gospl_module, "speculate_next_interval");
+    get_speculation_stats_func       = PyObject_GetAttrString(gospl_module, "get_speculation_stats");
+    register_plate_ids_func          = PyObject_GetAttrString(gospl_module, "register_plate_ids");
+    set_euler_poles_func             = PyObject_GetAttrString(gospl_module, "set_euler_poles");
+    register_forcing_callback_func   = PyObject_GetAttrString(gospl_module, "register_forcing_callback");
+    set_forcing_substeps_func        = PyObject_GetAttrString(gospl_module, "set_forcing_substeps");
+    set_locality_ordering_func       = PyObject_GetAttrString(gospl_module, "set_locality_ordering");
+    set_active_set_func              = PyObject_GetAttrString(gospl_module, "set_active_set");
+    get_active_set_stats_func        = PyObject_GetAttrString(gospl_module, "get_active_set_stats");
+    set_catchment_parallel_func      = PyObject_GetAttrString(gospl_module, "set_catchment_parallel");
+    get_catchment_stats_func         = PyObject_GetAttrString(gospl_module, "get_catchment_stats");
+    set_incremental_depressions_func = PyObject_GetAttrString(gospl_module, "set_incremental_depressions");
+    get_depression_stats_func        = PyObject_GetAttrString(gospl_module, "get_depression_stats");
+    get_output_stats_func            = PyObject_GetAttrString(gospl_module, "get_output_stats");
+    set_gc_policy_func               = PyObject_GetAttrString(gospl_module, "set_gc_policy");
+    collect_garbage_func             = PyObject_GetAttrString(gospl_module, "collect_garbage");
+    get_gc_stats_func                = PyObject_GetAttrString(gospl_module, "get_gc_stats");
 
     if (!create_model_func || !destroy_model_func || !run_dt_func ||
         !run_steps_func || !run_until_func || !apply_vel_func || !apply_elev_func ||
         !interpolate_elev_func || !get_time_func || !get_dt_func ||
         !set_surface_velocity_func || !set_uplift_rate_func ||
-        !run_and_get_erosion_func || !apply_drift_correction_func) {
+        !run_and_get_erosion_func || !apply_drift_correction_func ||
+        !set_transfer_tolerance_func || !get_transfer_stats_func ||
+        !declare_surface_points_func || !set_surface_velocity_sparse_func ||
+        !set_uplift_rate_sparse_func || !run_and_get_erosion_sparse_func ||
+        !get_sparse_erosion_func || !accumulate_surface_velocity_func ||
+        !enable_speculation_func || !speculate_next_interval_func ||
+        !get_speculation_stats_func || !register_plate_ids_func ||
+        !set_euler_poles_func || !register_forcing_callback_func ||
+        !set_forcing_substeps_func || !set_locality_ordering_func ||
+        !set_active_set_func || !get_active_set_stats_func ||
+        !set_catchment_parallel_func || !get_catchment_stats_func ||
+        !set_incremental_depressions_func || !get_depression_stats_func ||
+        !get_output_stats_func ||
+        !set_gc_policy_func || !collect_garbage_func || !get_gc_stats_func) {
         PyErr_Print();
-        std::cerr << "Failed to get function references from Python module" << std::endl;
+        log_record(GOSPL_LOG_ERROR, "initialize_gospl_extensions",
+                   "missing functions in gospl_python_interface");
         return -1;
     }
     
-    std::cout << "gospl_extensions C++ interface initialized successfully" << std::endl;
+    install_native_kernels();
+
+    // Production runs can be profiled without code changes
+    if (const char* path = std::getenv("GOSPL_PROFILE")) {
+        const char* hz = std::getenv("GOSPL_PROFILE_HZ");
+        if (*path && !profiler().sampler.joinable() &&
+            gospl_profiler_start(hz ? std::atof(hz) : 100.0, path) != 0)
+            log_record(GOSPL_LOG_WARN, "initialize_gospl_extensions",
+                       "GOSPL_PROFILE set but the profiler could not be started");
+    }
+
+    log_record(GOSPL_LOG_INFO, "initialize_gospl_extensions", "interface initialized");
+
+    // Release the GIL so speculation workers can run between API calls
+    if (owns_interpreter) main_thread_state = PyEval_SaveThread();
     return 0;
 }
 
 void finalize_gospl_extensions() {
+    stop_profiler();
+    join_all_speculations();
+    {
+        std::lock_guard<std::mutex> lock(speculation_mutex);
+        speculations.clear();
+    }
+    if (main_thread_state) {
+        PyEval_RestoreThread(main_thread_state);
+        main_thread_state = nullptr;
+    }
+
     // Clean up Python references
     Py_XDECREF(create_model_func);
     Py_XDECREF(destroy_model_func);
@@ -98,18 +1153,55 @@ void finalize_gospl_extensions() {
     Py_XDECREF(get_dt_func);
     Py_XDECREF(set_surface_velocity_func);
     Py_XDECREF(set_uplift_rate_func);
+    Py_XDECREF(accumulate_surface_velocity_func);
     Py_XDECREF(run_and_get_erosion_func);
     Py_XDECREF(apply_drift_correction_func);
+    Py_XDECREF(set_transfer_tolerance_func);
+    Py_XDECREF(get_transfer_stats_func);
+    Py_XDECREF(declare_surface_points_func);
+    Py_XDECREF(set_surface_velocity_sparse_func);
+    Py_XDECREF(set_uplift_rate_sparse_func);
+    Py_XDECREF(run_and_get_erosion_sparse_func);
+    Py_XDECREF(get_sparse_erosion_func);
+    Py_XDECREF(enable_speculation_func);
+    Py_XDECREF(speculate_next_interval_func);
+    Py_XDECREF(get_speculation_stats_func);
+    Py_XDECREF(register_plate_ids_func);
+    Py_XDECREF(set_euler_poles_func);
+    Py_XDECREF(register_forcing_callback_func);
+    Py_XDECREF(set_forcing_substeps_func);
+    Py_XDECREF(set_locality_ordering_func);
+    Py_XDECREF(set_active_set_func);
+    Py_XDECREF(get_active_set_stats_func);
+    Py_XDECREF(set_catchment_parallel_func);
+    Py_XDECREF(get_catchment_stats_func);
+    Py_XDECREF(set_incremental_depressions_func);
+    Py_XDECREF(get_depression_stats_func);
+    Py_XDECREF(get_output_stats_func);
+    Py_XDECREF(set_gc_policy_func);
+    Py_XDECREF(collect_garbage_func);
+    Py_XDECREF(get_gc_stats_func);
+    if (logger().configured.load()) configure_python_log(false);
+    // Arrays keep the handler alive; it has to be enabled again after a restart
+    numpy_allocator_state = 0;
+    Py_CLEAR(numpy_allocator().capsule);
     Py_XDECREF(gospl_module);
+    gospl_module = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(erosion_rates_mutex);
+        erosion_rates.clear();
+    }
     
     // Finalize Python interpreter
     if (Py_IsInitialized()) {
         Py_Finalize();
     }
+    gospl_log_flush();
 }
 
 ModelHandle create_enhanced_model(const char* config_path) {
     if (!create_model_func) return -1;
+    ApiCall call;
     
     PyObject* args = PyTuple_New(1);
     PyTuple_SetItem(args, 0, PyUnicode_FromString(config_path));
@@ -130,6 +1222,7 @@ ModelHandle create_enhanced_model(const char* config_path) {
 
 int destroy_model(ModelHandle handle) {
     if (!destroy_model_func) return -1;
+    ApiCall call(handle);
     
     PyObject* args = PyTuple_New(1);
     PyTuple_SetItem(args, 0, PyLong_FromLong(handle));
@@ -144,12 +1237,21 @@ int destroy_model(ModelHandle handle) {
     
     int ret = PyLong_AsLong(result);
     Py_DECREF(result);
+    {
+        std::lock_guard<std::mutex> lock(erosion_rates_mutex);
+        erosion_rates.erase(handle);
+    }
+    {
+        std::lock_guard<std::mutex> lock(speculation_mutex);
+        speculations.erase(handle);
+    }
     
     return ret;
 }
 
 double run_processes_for_dt(ModelHandle handle, double dt, int verbose, int skip_tectonics) {
     if (!run_dt_func) return -1.0;
+    ApiCall call(handle);
     
     PyObject* args = PyTuple_New(4);
     PyTuple_SetItem(args, 0, PyLong_FromLong(handle));
@@ -173,6 +1275,7 @@ double run_processes_for_dt(ModelHandle handle, double dt, int verbose, int skip
 
 int run_processes_for_steps(ModelHandle handle, int num_steps, double dt, int verbose, int skip_tectonics) {
     if (!run_steps_func) return -1;
+    ApiCall call(handle);
     
     PyObject* args = PyTuple_New(5);
     PyTuple_SetItem(args, 0, PyLong_FromLong(handle));
@@ -197,6 +1300,7 @@ int run_processes_for_steps(ModelHandle handle, int num_steps, double dt, int ve
 
 int run_processes_until_time(ModelHandle handle, double target_time, double dt, int verbose, int skip_tectonics) {
     if (!run_until_func) return -1;
+    ApiCall call(handle);
     
     PyObject* args = PyTuple_New(5);
     PyTuple_SetItem(args, 0, PyLong_FromLong(handle));
@@ -222,6 +1326,7 @@ int run_processes_until_time(ModelHandle handle, double target_time, double dt,
 int apply_velocity_data(ModelHandle handle, const double* coords, const double* velocities,
                        int num_points, double timer, int k, double power) {
     if (!apply_vel_func) return -1;
+    ApiCall call(handle);
     
     // Create numpy arrays from C arrays
     npy_intp coord_dims[2] = {num_points, 3};
@@ -263,6 +1368,7 @@ int apply_velocity_data(ModelHandle handle, const double* coords, const double*
 int apply_elevation_data(ModelHandle handle, const double* coords, const double* elevations,
                         int num_points, int k, double power) {
     if (!apply_elev_func) return -1;
+    ApiCall call(handle);
     
     // Create numpy arrays from C arrays
     npy_intp coord_dims[2] = {num_points, 3};
@@ -300,9 +1406,10 @@ int apply_elevation_data(ModelHandle handle, const double* coords, const double*
     return ret;
 }
 
-int interpolate_elevation_to_points(ModelHandle handle, const double* coords, int num_points,
-                                   double* elevations, int k, double power) {
+static int interpolate_elevation_direct(ModelHandle handle, const double* coords, int num_points,
+                                        double* elevations, int k, double power) {
     if (!interpolate_elev_func) return -1;
+    ApiCall call(handle);
     
     // Create numpy array from C array
     npy_intp coord_dims[2] = {num_points, 3};
@@ -345,8 +1452,103 @@ int interpolate_elevation_to_points(ModelHandle handle, const double* coords, in
     }
 }
 
+// ---------------------------------------------------------------------------
+// Query coalescing: small concurrent interpolate_elevation_to_points() calls
+// with the same (handle, k, power) are merged into one Python call. The first
+// caller of a batch leads: it waits up to the window (or until the batch
+// reaches max_points), runs the merged query and scatters the results back.
+// ---------------------------------------------------------------------------
+
+struct QueryBatch {
+    std::vector<double> coords;
+    std::vector<double> elevations;
+    int status = -1;
+    bool full = false;
+    bool done = false;
+};
+
+static std::mutex coalesce_mutex;
+static std::condition_variable coalesce_cv;
+static std::map<std::tuple<ModelHandle, int, double>, std::shared_ptr<QueryBatch>> open_batches;
+static int coalesce_window_us   = 0;   // 0 disables coalescing
+static int coalesce_max_points  = 4096;
+static long coalesce_queries    = 0;
+static long coalesce_batches    = 0;
+
+int configure_query_coalescing(int window_us, int max_points) {
+    if (window_us < 0 || max_points <= 0) return -1;
+    std::lock_guard<std::mutex> lock(coalesce_mutex);
+    coalesce_window_us  = window_us;
+    coalesce_max_points = max_points;
+    return 0;
+}
+
+int get_query_coalescing_stats(long* queries, long* batches) {
+    std::lock_guard<std::mutex> lock(coalesce_mutex);
+    if (queries) *queries = coalesce_queries;
+    if (batches) *batches = coalesce_batches;
+    return 0;
+}
+
+int interpolate_elevation_to_points(ModelHandle handle, const double* coords, int num_points,
+                                   double* elevations, int k, double power) {
+    std::unique_lock<std::mutex> lock(coalesce_mutex);
+    if (coalesce_window_us == 0 || num_points >= coalesce_max_points) {
+        lock.unlock();
+        return interpolate_elevation_direct(handle, coords, num_points, elevations, k, power);
+    }
+
+    auto key = std::make_tuple(handle, k, power);
+    std::shared_ptr<QueryBatch> batch;
+    bool leader = false;
+    auto it = open_batches.find(key);
+    if (it == open_batches.end()) {
+        batch = std::make_shared<QueryBatch>();
+        open_batches[key] = batch;
+        leader = true;
+    } else {
+        batch = it->second;
+    }
+    size_t offset = batch->coords.size() / 3;
+    batch->coords.insert(batch->coords.end(), coords, coords + 3 * num_points);
+    coalesce_queries++;
+    if ((int)(batch->coords.size() / 3) >= coalesce_max_points) {
+        batch->full = true;
+        if (!leader) open_batches.erase(key);
+        coalesce_cv.notify_all();
+    }
+
+    if (leader) {
+        auto deadline = std::chrono::steady_clock::now() +
+                        std::chrono::microseconds(coalesce_window_us);
+        coalesce_cv.wait_until(lock, deadline, [&] { return batch->full; });
+        auto open = open_batches.find(key);
+        if (open != open_batches.end() && open->second == batch) open_batches.erase(open);
+        coalesce_batches++;
+
+        // The batch is closed: no one else touches coords until done is set.
+        int total = (int)(batch->coords.size() / 3);
+        batch->elevations.resize(total);
+        lock.unlock();
+        int status = interpolate_elevation_direct(handle, batch->coords.data(), total,
+                                                  batch->elevations.data(), k, power);
+        lock.lock();
+        batch->status = status;
+        batch->done = true;
+        coalesce_cv.notify_all();
+    } else {
+        coalesce_cv.wait(lock, [&] { return batch->done; });
+    }
+
+    if (batch->status == 0)
+        std::memcpy(elevations, batch->elevations.data() + offset, num_points * sizeof(double));
+    return batch->status;
+}
+
 double get_current_time(ModelHandle handle) {
-    if (!get_time_func) return -1.0;
+    // Model time may be negative (paleo runs), so errors are reported as NaN.
+    if (!get_time_func) return std::nan("");
+    ApiCall call(handle);
     
     PyObject* args = PyTuple_New(1);
     PyTuple_SetItem(args, 0, PyLong_FromLong(handle));
@@ -356,17 +1558,22 @@ double get_current_time(ModelHandle handle) {
     
     if (!result) {
         PyErr_Print();
-        return -1.0;
+        return std::nan("");
     }
     
     double time = PyFloat_AsDouble(result);
     Py_DECREF(result);
+    if (time == -1.0 && PyErr_Occurred()) {
+        PyErr_Print();
+        return std::nan("");
+    }
     
     return time;
 }
 
 double get_time_step(ModelHandle handle) {
     if (!get_dt_func) return -1.0;
+    ApiCall call(handle);
     
     PyObject* args = PyTuple_New(1);
     PyTuple_SetItem(args, 0, PyLong_FromLong(handle));
@@ -396,6 +1603,7 @@ int set_surface_velocity(ModelHandle handle,
                          const double* vz_yr,
                          int num_points, int k, double power) {
     if (!set_surface_velocity_func) return -1;
+    ApiCall call(handle);
 
     npy_intp coord_dims[2] = {num_points, 3};
     npy_intp vel_dims[1]   = {num_points};
@@ -431,9 +1639,54 @@ int set_surface_velocity(ModelHandle handle,
     return ret;
 }
 
+int accumulate_surface_velocity(ModelHandle handle,
+                                const double* coords,
+                                const double* vx_yr,
+                                const double* vy_yr,
+                                const double* vz_yr,
+                                int num_points, double dt_des, int k, double power) {
+    if (!accumulate_surface_velocity_func) return -1;
+    ApiCall call(handle);
+
+    npy_intp coord_dims[2] = {num_points, 3};
+    npy_intp vel_dims[1]   = {num_points};
+
+    PyObject* coord_array = PyArray_SimpleNewFromData(2, coord_dims, NPY_DOUBLE, (void*)coords);
+    PyObject* vx_array    = PyArray_SimpleNewFromData(1, vel_dims,   NPY_DOUBLE, (void*)vx_yr);
+    PyObject* vy_array    = PyArray_SimpleNewFromData(1, vel_dims,   NPY_DOUBLE, (void*)vy_yr);
+    PyObject* vz_array    = PyArray_SimpleNewFromData(1, vel_dims,   NPY_DOUBLE, (void*)vz_yr);
+
+    if (!coord_array || !vx_array || !vy_array || !vz_array) {
+        PyErr_Print();
+        Py_XDECREF(coord_array); Py_XDECREF(vx_array);
+        Py_XDECREF(vy_array);    Py_XDECREF(vz_array);
+        return -1;
+    }
+
+    PyObject* args = PyTuple_New(9);
+    PyTuple_SetItem(args, 0, PyLong_FromLong(handle));
+    PyTuple_SetItem(args, 1, coord_array);
+    PyTuple_SetItem(args, 2, vx_array);
+    PyTuple_SetItem(args, 3, vy_array);
+    PyTuple_SetItem(args, 4, vz_array);
+    PyTuple_SetItem(args, 5, PyLong_FromLong(num_points));
+    PyTuple_SetItem(args, 6, PyFloat_FromDouble(dt_des));
+    PyTuple_SetItem(args, 7, PyLong_FromLong(k));
+    PyTuple_SetItem(args, 8, PyFloat_FromDouble(power));
+
+    PyObject* result = PyObject_CallObject(accumulate_surface_velocity_func, args);
+    Py_DECREF(args);
+
+    if (!result) { PyErr_Print(); return -1; }
+    int ret = PyLong_AsLong(result);
+    Py_DECREF(result);
+    return ret;
+}
+
 int set_uplift_rate(ModelHandle handle, const double* coords, const double* vz_yr,
                    int num_points, int k, double power) {
     if (!set_uplift_rate_func) return -1;
+    ApiCall call(handle);
 
     npy_intp coord_dims[2] = {num_points, 3};
     npy_intp vz_dims[1]    = {num_points};
@@ -468,6 +1721,7 @@ int set_uplift_rate(ModelHandle handle, const double* coords, const double* vz_y
 int run_and_get_erosion(ModelHandle handle, double dt, const double* coords,
                         int num_points, double* erosion, int k, double power) {
     if (!run_and_get_erosion_func) return -1;
+    ApiCall call(handle);
 
     npy_intp coord_dims[2] = {num_points, 3};
     PyObject* coord_array = PyArray_SimpleNewFromData(2, coord_dims, NPY_DOUBLE, (void*)coords);
@@ -490,27 +1744,139 @@ int run_and_get_erosion(ModelHandle handle, double dt, const double* coords,
     if (PyArray_Check(result)) {
         PyArrayObject* arr = (PyArrayObject*)result;
         double* data = (double*)PyArray_DATA(arr);
-        for (int i = 0; i < num_points; i++)
+        std::vector<double> rate(num_points, 0.0);
+        for (int i = 0; i < num_points; i++) {
             erosion[i] = data[i];
+            if (dt > 0.0) rate[i] = data[i] / dt;
+        }
+        store_erosion_rate(handle, std::move(rate));
         Py_DECREF(result);
+        launch_speculation(handle, dt, k, power);
         return 0;
     }
     Py_DECREF(result);
     return -1;
 }
 
-int apply_drift_correction(ModelHandle handle, const double* coords, const double* des_elev,
-                           int num_points, double alpha, int k, double power) {
-    if (!apply_drift_correction_func) return -1;
+int get_erosion_rate(ModelHandle handle, double* rate, int num_points) {
+    std::lock_guard<std::mutex> lock(erosion_rates_mutex);
+    auto it = erosion_rates.find(handle);
+    if (it == erosion_rates.end() || (int)it->second.size() != num_points) return -1;
+    std::memcpy(rate, it->second.data(), num_points * sizeof(double));
+    return 0;
+}
 
-    npy_intp coord_dims[2] = {num_points, 3};
-    npy_intp elev_dims[1]  = {num_points};
+int extrapolate_erosion(ModelHandle handle, double dt, double* erosion, int num_points) {
+    std::lock_guard<std::mutex> lock(erosion_rates_mutex);
+    auto it = erosion_rates.find(handle);
+    if (it == erosion_rates.end() || (int)it->second.size() != num_points) return -1;
+    const std::vector<double>& rate = it->second;
+    for (size_t i = 0; i < rate.size(); i++)
+        erosion[i] = rate[i] * dt;
+    return (int)rate.size();
+}
 
-    PyObject* coord_array = PyArray_SimpleNewFromData(2, coord_dims, NPY_DOUBLE, (void*)coords);
-    PyObject* elev_array  = PyArray_SimpleNewFromData(1, elev_dims,  NPY_DOUBLE, (void*)des_elev);
+// Copy an (indices, values) result tuple into caller buffers; returns the
+// full count (which may exceed capacity) or -1 if the result is malformed.
+// When rate is given, it is reset to zero and the listed points get value/dt.
+static int copy_sparse_result(PyObject* result, int* indices, double* values, int capacity,
+                              std::vector<double>* rate = nullptr, double dt = 0.0) {
+    if (!PyTuple_Check(result) || PyTuple_Size(result) != 2) return -1;
 
-    if (!coord_array || !elev_array) {
-        PyErr_Print();
+    PyObject* idx_obj = PyTuple_GetItem(result, 0);
+    PyObject* val_obj = PyTuple_GetItem(result, 1);
+    if (!PyArray_Check(idx_obj) || !PyArray_Check(val_obj)) return -1;
+
+    PyArrayObject* idx_arr = (PyArrayObject*)idx_obj;
+    PyArrayObject* val_arr = (PyArrayObject*)val_obj;
+    if (PyArray_TYPE(idx_arr) != NPY_INT || PyArray_TYPE(val_arr) != NPY_DOUBLE ||
+        !PyArray_IS_C_CONTIGUOUS(idx_arr) || !PyArray_IS_C_CONTIGUOUS(val_arr))
+        return -1;
+
+    int count = (int)PyArray_SIZE(idx_arr);
+    if ((int)PyArray_SIZE(val_arr) != count) return -1;
+
+    int n = count < capacity ? count : capacity;
+    if (n > 0) {
+        std::memcpy(indices, PyArray_DATA(idx_arr), n * sizeof(int));
+        std::memcpy(values,  PyArray_DATA(val_arr), n * sizeof(double));
+    }
+
+    if (rate) {
+        const int* idx = (const int*)PyArray_DATA(idx_arr);
+        const double* val = (const double*)PyArray_DATA(val_arr);
+        std::fill(rate->begin(), rate->end(), 0.0);
+        if (dt > 0.0) {
+            for (int i = 0; i < count; i++) {
+                if (idx[i] >= 0 && idx[i] < (int)rate->size())
+                    (*rate)[idx[i]] = val[i] / dt;
+            }
+        }
+    }
+    return count;
+}
+
+int run_and_get_erosion_sparse(ModelHandle handle, double dt, const double* coords,
+                               int num_points, double threshold, int* indices,
+                               double* values, int capacity, int k, double power) {
+    if (!run_and_get_erosion_sparse_func) return -1;
+    ApiCall call(handle);
+
+    npy_intp coord_dims[2] = {num_points, 3};
+    PyObject* coord_array = PyArray_SimpleNewFromData(2, coord_dims, NPY_DOUBLE, (void*)coords);
+
+    if (!coord_array) { PyErr_Print(); return -1; }
+
+    PyObject* args = PyTuple_New(7);
+    PyTuple_SetItem(args, 0, PyLong_FromLong(handle));
+    PyTuple_SetItem(args, 1, PyFloat_FromDouble(dt));
+    PyTuple_SetItem(args, 2, coord_array);  // steals reference
+    PyTuple_SetItem(args, 3, PyLong_FromLong(num_points));
+    PyTuple_SetItem(args, 4, PyFloat_FromDouble(threshold));
+    PyTuple_SetItem(args, 5, PyLong_FromLong(k));
+    PyTuple_SetItem(args, 6, PyFloat_FromDouble(power));
+
+    PyObject* result = PyObject_CallObject(run_and_get_erosion_sparse_func, args);
+    Py_DECREF(args);
+
+    if (!result) { PyErr_Print(); return -1; }
+    std::vector<double> rate(num_points, 0.0);
+    int count = copy_sparse_result(result, indices, values, capacity, &rate, dt);
+    Py_DECREF(result);
+    if (count >= 0) store_erosion_rate(handle, std::move(rate));
+    if (count >= 0) launch_speculation(handle, dt, k, power);
+    return count;
+}
+
+int get_sparse_erosion(ModelHandle handle, int* indices, double* values, int capacity) {
+    if (!get_sparse_erosion_func) return -1;
+    ApiCall call(handle);
+
+    PyObject* args = PyTuple_New(1);
+    PyTuple_SetItem(args, 0, PyLong_FromLong(handle));
+
+    PyObject* result = PyObject_CallObject(get_sparse_erosion_func, args);
+    Py_DECREF(args);
+
+    if (!result) { PyErr_Print(); return -1; }
+    int count = copy_sparse_result(result, indices, values, capacity);
+    Py_DECREF(result);
+    return count;
+}
+
+int apply_drift_correction(ModelHandle handle, const double* coords, const double* des_elev,
+                           int num_points, double alpha, int k, double power) {
+    if (!apply_drift_correction_func) return -1;
+    ApiCall call(handle);
+
+    npy_intp coord_dims[2] = {num_points, 3};
+    npy_intp elev_dims[1]  = {num_points};
+
+    PyObject* coord_array = PyArray_SimpleNewFromData(2, coord_dims, NPY_DOUBLE, (void*)coords);
+    PyObject* elev_array  = PyArray_SimpleNewFromData(1, elev_dims,  NPY_DOUBLE, (void*)des_elev);
+
+    if (!coord_array || !elev_array) {
+        PyErr_Print();
         Py_XDECREF(coord_array);
         Py_XDECREF(elev_array);
         return -1;
@@ -534,6 +1900,739 @@ int apply_drift_correction(ModelHandle handle, const double* coords, const doubl
     return ret;
 }
 
+int set_transfer_tolerance(ModelHandle handle, double tol) {
+    if (!set_transfer_tolerance_func) return -1;
+    ApiCall call(handle);
+
+    PyObject* args = PyTuple_New(2);
+    PyTuple_SetItem(args, 0, PyLong_FromLong(handle));
+    PyTuple_SetItem(args, 1, PyFloat_FromDouble(tol));
+
+    PyObject* result = PyObject_CallObject(set_transfer_tolerance_func, args);
+    Py_DECREF(args);
+
+    if (!result) { PyErr_Print(); return -1; }
+    int ret = PyLong_AsLong(result);
+    Py_DECREF(result);
+    return ret;
+}
+
+int get_transfer_stats(ModelHandle handle, double* skip_rate, double* partial_rate) {
+    if (!get_transfer_stats_func) return -1;
+    ApiCall call(handle);
+
+    PyObject* args = PyTuple_New(1);
+    PyTuple_SetItem(args, 0, PyLong_FromLong(handle));
+
+    PyObject* result = PyObject_CallObject(get_transfer_stats_func, args);
+    Py_DECREF(args);
+
+    if (!result) { PyErr_Print(); return -1; }
+
+    if (PyTuple_Check(result) && PyTuple_Size(result) == 2) {
+        if (skip_rate)    *skip_rate    = PyFloat_AsDouble(PyTuple_GetItem(result, 0));
+        if (partial_rate) *partial_rate = PyFloat_AsDouble(PyTuple_GetItem(result, 1));
+        Py_DECREF(result);
+        return 0;
+    }
+    Py_DECREF(result);
+    return -1;
+}
+
+int declare_surface_points(ModelHandle handle, const double* coords, int num_points,
+                           int k, double power) {
+    if (!declare_surface_points_func) return -1;
+    ApiCall call(handle);
+
+    npy_intp coord_dims[2] = {num_points, 3};
+    PyObject* coord_array = PyArray_SimpleNewFromData(2, coord_dims, NPY_DOUBLE, (void*)coords);
+
+    if (!coord_array) { PyErr_Print(); return -1; }
+
+    PyObject* args = PyTuple_New(5);
+    PyTuple_SetItem(args, 0, PyLong_FromLong(handle));
+    PyTuple_SetItem(args, 1, coord_array);
+    PyTuple_SetItem(args, 2, PyLong_FromLong(num_points));
+    PyTuple_SetItem(args, 3, PyLong_FromLong(k));
+    PyTuple_SetItem(args, 4, PyFloat_FromDouble(power));
+
+    PyObject* result = PyObject_CallObject(declare_surface_points_func, args);
+    Py_DECREF(args);
+
+    if (!result) { PyErr_Print(); return -1; }
+    int ret = PyLong_AsLong(result);
+    Py_DECREF(result);
+    return ret;
+}
+
+int set_surface_velocity_sparse(ModelHandle handle, const int* indices,
+                                const double* vx_yr, const double* vy_yr,
+                                const double* vz_yr, int num_changed) {
+    if (!set_surface_velocity_sparse_func) return -1;
+    ApiCall call(handle);
+
+    npy_intp dims[1] = {num_changed};
+
+    PyObject* idx_array = PyArray_SimpleNewFromData(1, dims, NPY_INT,    (void*)indices);
+    PyObject* vx_array  = PyArray_SimpleNewFromData(1, dims, NPY_DOUBLE, (void*)vx_yr);
+    PyObject* vy_array  = PyArray_SimpleNewFromData(1, dims, NPY_DOUBLE, (void*)vy_yr);
+    PyObject* vz_array  = PyArray_SimpleNewFromData(1, dims, NPY_DOUBLE, (void*)vz_yr);
+
+    if (!idx_array || !vx_array || !vy_array || !vz_array) {
+        PyErr_Print();
+        Py_XDECREF(idx_array); Py_XDECREF(vx_array);
+        Py_XDECREF(vy_array);  Py_XDECREF(vz_array);
+        return -1;
+    }
+
+    PyObject* args = PyTuple_New(6);
+    PyTuple_SetItem(args, 0, PyLong_FromLong(handle));
+    PyTuple_SetItem(args, 1, idx_array);
+    PyTuple_SetItem(args, 2, vx_array);
+    PyTuple_SetItem(args, 3, vy_array);
+    PyTuple_SetItem(args, 4, vz_array);
+    PyTuple_SetItem(args, 5, PyLong_FromLong(num_changed));
+
+    PyObject* result = PyObject_CallObject(set_surface_velocity_sparse_func, args);
+    Py_DECREF(args);
+
+    if (!result) { PyErr_Print(); return -1; }
+    int ret = PyLong_AsLong(result);
+    Py_DECREF(result);
+    return ret;
+}
+
+int set_uplift_rate_sparse(ModelHandle handle, const int* indices, const double* vz_yr,
+                           int num_changed) {
+    if (!set_uplift_rate_sparse_func) return -1;
+    ApiCall call(handle);
+
+    npy_intp dims[1] = {num_changed};
+
+    PyObject* idx_array = PyArray_SimpleNewFromData(1, dims, NPY_INT,    (void*)indices);
+    PyObject* vz_array  = PyArray_SimpleNewFromData(1, dims, NPY_DOUBLE, (void*)vz_yr);
+
+    if (!idx_array || !vz_array) {
+        PyErr_Print();
+        Py_XDECREF(idx_array);
+        Py_XDECREF(vz_array);
+        return -1;
+    }
+
+    PyObject* args = PyTuple_New(4);
+    PyTuple_SetItem(args, 0, PyLong_FromLong(handle));
+    PyTuple_SetItem(args, 1, idx_array);
+    PyTuple_SetItem(args, 2, vz_array);
+    PyTuple_SetItem(args, 3, PyLong_FromLong(num_changed));
+
+    PyObject* result = PyObject_CallObject(set_uplift_rate_sparse_func, args);
+    Py_DECREF(args);
+
+    if (!result) { PyErr_Print(); return -1; }
+    int ret = PyLong_AsLong(result);
+    Py_DECREF(result);
+    return ret;
+}
+
+int register_plate_ids(ModelHandle handle, const double* coords, const int* plate_ids,
+                       int num_points) {
+    if (!register_plate_ids_func) return -1;
+    ApiCall call(handle);
+
+    npy_intp coord_dims[2] = {num_points, 3};
+    npy_intp id_dims[1]    = {num_points};
+
+    PyObject* coord_array = PyArray_SimpleNewFromData(2, coord_dims, NPY_DOUBLE, (void*)coords);
+    PyObject* id_array    = PyArray_SimpleNewFromData(1, id_dims,    NPY_INT,    (void*)plate_ids);
+
+    if (!coord_array || !id_array) {
+        PyErr_Print();
+        Py_XDECREF(coord_array);
+        Py_XDECREF(id_array);
+        return -1;
+    }
+
+    PyObject* args = PyTuple_New(4);
+    PyTuple_SetItem(args, 0, PyLong_FromLong(handle));
+    PyTuple_SetItem(args, 1, coord_array);
+    PyTuple_SetItem(args, 2, id_array);
+    PyTuple_SetItem(args, 3, PyLong_FromLong(num_points));
+
+    PyObject* result = PyObject_CallObject(register_plate_ids_func, args);
+    Py_DECREF(args);
+
+    if (!result) { PyErr_Print(); return -1; }
+    int ret = PyLong_AsLong(result);
+    Py_DECREF(result);
+    return ret;
+}
+
+int set_euler_poles(ModelHandle handle, const double* omega, int num_plates) {
+    if (!set_euler_poles_func) return -1;
+    ApiCall call(handle);
+
+    npy_intp dims[2] = {num_plates, 3};
+    PyObject* omega_array = PyArray_SimpleNewFromData(2, dims, NPY_DOUBLE, (void*)omega);
+
+    if (!omega_array) { PyErr_Print(); return -1; }
+
+    PyObject* args = PyTuple_New(3);
+    PyTuple_SetItem(args, 0, PyLong_FromLong(handle));
+    PyTuple_SetItem(args, 1, omega_array);
+    PyTuple_SetItem(args, 2, PyLong_FromLong(num_plates));
+
+    PyObject* result = PyObject_CallObject(set_euler_poles_func, args);
+    Py_DECREF(args);
+
+    if (!result) { PyErr_Print(); return -1; }
+    int ret = PyLong_AsLong(result);
+    Py_DECREF(result);
+    return ret;
+}
+
+// A registered host forcing callback. Owned by a capsule that is the `self`
+// of the Python callable handed to the model, so it lives exactly as long as
+// the model keeps the registration.
+struct ForcingSource {
+    ForcingCallback fn;
+    void* user_data;
+    int num_points;
+    int num_values;
+    std::vector<double> coords;
+};
+
+static const char* const forcing_capsule_name = "gospl_extensions.ForcingSource";
+
+static void free_forcing_source(PyObject* capsule) {
+    delete static_cast<ForcingSource*>(PyCapsule_GetPointer(capsule, forcing_capsule_name));
+}
+
+// pull(time) -> (num_points, num_values) array filled by the host callback,
+// which runs with the GIL released.
+static PyObject* pull_forcing(PyObject* self, PyObject* args) {
+    double time;
+    if (!PyArg_ParseTuple(args, "d", &time)) return nullptr;
+    ForcingSource* src = static_cast<ForcingSource*>(PyCapsule_GetPointer(self, forcing_capsule_name));
+    if (!src) return nullptr;
+
+    npy_intp dims[2] = {src->num_points, src->num_values};
+    PyObject* values = PyArray_SimpleNew(2, dims, NPY_DOUBLE);
+    if (!values) return nullptr;
+    double* data = (double*)PyArray_DATA((PyArrayObject*)values);
+
+    int rc;
+    Py_BEGIN_ALLOW_THREADS
+    rc = src->fn(time, src->num_points, src->coords.data(), data, src->user_data);
+    Py_END_ALLOW_THREADS
+
+    if (rc != 0) {
+        Py_DECREF(values);
+        char msg[96];
+        std::snprintf(msg, sizeof(msg), "forcing callback returned %d at t=%g", rc, time);
+        PyErr_SetString(PyExc_RuntimeError, msg);
+        return nullptr;
+    }
+    return values;
+}
+
+static PyMethodDef pull_forcing_def = {
+    "pull_forcing", pull_forcing, METH_VARARGS, "Fetch host forcing at the given time."
+};
+
+int register_forcing_callback(ModelHandle handle, int kind, const double* coords,
+                              int num_points, ForcingCallback fn, void* user_data) {
+    if (!register_forcing_callback_func) return -1;
+    if (kind != GOSPL_FORCING_VELOCITY && kind != GOSPL_FORCING_UPLIFT) return -1;
+    if (fn && (!coords || num_points <= 0)) return -1;
+    ApiCall call(handle);
+
+    PyObject* pull;
+    PyObject* coord_array;
+    if (fn) {
+        ForcingSource* src = new ForcingSource{fn, user_data, num_points,
+                                               kind == GOSPL_FORCING_VELOCITY ? 3 : 1,
+                                               std::vector<double>(coords, coords + 3 * num_points)};
+        PyObject* capsule = PyCapsule_New(src, forcing_capsule_name, free_forcing_source);
+        if (!capsule) { delete src; PyErr_Print(); return -1; }
+        pull = PyCFunction_New(&pull_forcing_def, capsule);
+        Py_DECREF(capsule);
+
+        npy_intp coord_dims[2] = {num_points, 3};
+        coord_array = PyArray_SimpleNewFromData(2, coord_dims, NPY_DOUBLE, (void*)coords);
+        if (!pull || !coord_array) {
+            PyErr_Print();
+            Py_XDECREF(pull);
+            Py_XDECREF(coord_array);
+            return -1;
+        }
+    } else {
+        pull = Py_None;
+        coord_array = Py_None;
+        Py_INCREF(Py_None);
+        Py_INCREF(Py_None);
+    }
+
+    PyObject* args = PyTuple_New(5);
+    PyTuple_SetItem(args, 0, PyLong_FromLong(handle));
+    PyTuple_SetItem(args, 1, PyLong_FromLong(kind));
+    PyTuple_SetItem(args, 2, coord_array);
+    PyTuple_SetItem(args, 3, PyLong_FromLong(num_points));
+    PyTuple_SetItem(args, 4, pull);
+
+    PyObject* result = PyObject_CallObject(register_forcing_callback_func, args);
+    Py_DECREF(args);
+
+    if (!result) { PyErr_Print(); return -1; }
+    int ret = PyLong_AsLong(result);
+    Py_DECREF(result);
+    return ret;
+}
+
+int set_forcing_substeps(ModelHandle handle, int num_substeps) {
+    if (!set_forcing_substeps_func) return -1;
+    ApiCall call(handle);
+
+    PyObject* args = PyTuple_New(2);
+    PyTuple_SetItem(args, 0, PyLong_FromLong(handle));
+    PyTuple_SetItem(args, 1, PyLong_FromLong(num_substeps));
+
+    PyObject* result = PyObject_CallObject(set_forcing_substeps_func, args);
+    Py_DECREF(args);
+
+    if (!result) { PyErr_Print(); return -1; }
+    int ret = PyLong_AsLong(result);
+    Py_DECREF(result);
+    return ret;
+}
+
+int set_locality_ordering(ModelHandle handle, int enabled) {
+    if (!set_locality_ordering_func) return -1;
+    ApiCall call(handle);
+
+    PyObject* args = PyTuple_New(2);
+    PyTuple_SetItem(args, 0, PyLong_FromLong(handle));
+    PyTuple_SetItem(args, 1, PyLong_FromLong(enabled));
+
+    PyObject* result = PyObject_CallObject(set_locality_ordering_func, args);
+    Py_DECREF(args);
+
+    if (!result) { PyErr_Print(); return -1; }
+    int ret = PyLong_AsLong(result);
+    Py_DECREF(result);
+    return ret;
+}
+
+int enable_speculation(ModelHandle handle, int enabled, double tolerance) {
+    if (!enable_speculation_func) return -1;
+    // Workers need the GIL between calls, which a host-owned interpreter keeps.
+    if (enabled && !main_thread_state) return -1;
+    ApiCall call(handle);
+
+    PyObject* args = PyTuple_New(3);
+    PyTuple_SetItem(args, 0, PyLong_FromLong(handle));
+    PyTuple_SetItem(args, 1, PyLong_FromLong(enabled));
+    PyTuple_SetItem(args, 2, PyFloat_FromDouble(tolerance));
+
+    PyObject* result = PyObject_CallObject(enable_speculation_func, args);
+    Py_DECREF(args);
+
+    if (!result) { PyErr_Print(); return -1; }
+    int ret = PyLong_AsLong(result);
+    Py_DECREF(result);
+    if (ret == 0) {
+        std::lock_guard<std::mutex> lock(speculation_mutex);
+        speculations[handle].enabled = enabled != 0;
+    }
+    return ret;
+}
+
+int get_speculation_stats(ModelHandle handle, int* committed, int* rolled_back) {
+    if (!get_speculation_stats_func) return -1;
+    ApiCall call(handle);
+
+    PyObject* args = PyTuple_New(1);
+    PyTuple_SetItem(args, 0, PyLong_FromLong(handle));
+
+    PyObject* result = PyObject_CallObject(get_speculation_stats_func, args);
+    Py_DECREF(args);
+
+    if (!result) { PyErr_Print(); return -1; }
+
+    if (PyTuple_Check(result) && PyTuple_Size(result) == 2) {
+        if (committed)   *committed   = (int)PyLong_AsLong(PyTuple_GetItem(result, 0));
+        if (rolled_back) *rolled_back = (int)PyLong_AsLong(PyTuple_GetItem(result, 1));
+        Py_DECREF(result);
+        return 0;
+    }
+    Py_DECREF(result);
+    return -1;
+}
+
+int set_active_set(ModelHandle handle, double threshold, double area_threshold,
+                   int buffer, int full_sweep_every) {
+    if (!set_active_set_func) return -1;
+    ApiCall call(handle);
+
+    PyObject* args = PyTuple_New(5);
+    PyTuple_SetItem(args, 0, PyLong_FromLong(handle));
+    PyTuple_SetItem(args, 1, PyFloat_FromDouble(threshold));
+    PyTuple_SetItem(args, 2, PyFloat_FromDouble(area_threshold));
+    PyTuple_SetItem(args, 3, PyLong_FromLong(buffer));
+    PyTuple_SetItem(args, 4, PyLong_FromLong(full_sweep_every));
+
+    PyObject* result = PyObject_CallObject(set_active_set_func, args);
+    Py_DECREF(args);
+
+    if (!result) { PyErr_Print(); return -1; }
+    int ret = PyLong_AsLong(result);
+    Py_DECREF(result);
+    return ret;
+}
+
+int get_active_set_stats(ModelHandle handle, int* steps, int* skipped, double* active_fraction) {
+    if (!get_active_set_stats_func) return -1;
+    ApiCall call(handle);
+
+    PyObject* args = PyTuple_New(1);
+    PyTuple_SetItem(args, 0, PyLong_FromLong(handle));
+
+    PyObject* result = PyObject_CallObject(get_active_set_stats_func, args);
+    Py_DECREF(args);
+
+    if (!result) { PyErr_Print(); return -1; }
+
+    if (PyTuple_Check(result) && PyTuple_Size(result) == 3) {
+        if (steps)           *steps           = (int)PyLong_AsLong(PyTuple_GetItem(result, 0));
+        if (skipped)         *skipped         = (int)PyLong_AsLong(PyTuple_GetItem(result, 1));
+        if (active_fraction) *active_fraction = PyFloat_AsDouble(PyTuple_GetItem(result, 2));
+        Py_DECREF(result);
+        return 0;
+    }
+    Py_DECREF(result);
+    return -1;
+}
+
+int set_catchment_parallel(ModelHandle handle, int enabled, int num_threads,
+                           double giant_fraction) {
+    if (!set_catchment_parallel_func) return -1;
+    ApiCall call(handle);
+
+    PyObject* args = PyTuple_New(4);
+    PyTuple_SetItem(args, 0, PyLong_FromLong(handle));
+    PyTuple_SetItem(args, 1, PyLong_FromLong(enabled));
+    PyTuple_SetItem(args, 2, PyLong_FromLong(num_threads));
+    PyTuple_SetItem(args, 3, PyFloat_FromDouble(giant_fraction));
+
+    PyObject* result = PyObject_CallObject(set_catchment_parallel_func, args);
+    Py_DECREF(args);
+
+    if (!result) { PyErr_Print(); return -1; }
+    int ret = PyLong_AsLong(result);
+    Py_DECREF(result);
+    return ret;
+}
+
+int get_catchment_stats(ModelHandle handle, int* solves, int* fallbacks, int* basins) {
+    if (!get_catchment_stats_func) return -1;
+    ApiCall call(handle);
+
+    PyObject* args = PyTuple_New(1);
+    PyTuple_SetItem(args, 0, PyLong_FromLong(handle));
+
+    PyObject* result = PyObject_CallObject(get_catchment_stats_func, args);
+    Py_DECREF(args);
+
+    if (!result) { PyErr_Print(); return -1; }
+
+    if (PyTuple_Check(result) && PyTuple_Size(result) == 3) {
+        if (solves)    *solves    = (int)PyLong_AsLong(PyTuple_GetItem(result, 0));
+        if (fallbacks) *fallbacks = (int)PyLong_AsLong(PyTuple_GetItem(result, 1));
+        if (basins)    *basins    = (int)PyLong_AsLong(PyTuple_GetItem(result, 2));
+        Py_DECREF(result);
+        return 0;
+    }
+    Py_DECREF(result);
+    return -1;
+}
+
+int set_incremental_depressions(ModelHandle handle, int enabled, double tolerance) {
+    if (!set_incremental_depressions_func) return -1;
+    ApiCall call(handle);
+
+    PyObject* args = PyTuple_New(3);
+    PyTuple_SetItem(args, 0, PyLong_FromLong(handle));
+    PyTuple_SetItem(args, 1, PyLong_FromLong(enabled));
+    PyTuple_SetItem(args, 2, PyFloat_FromDouble(tolerance));
+
+    PyObject* result = PyObject_CallObject(set_incremental_depressions_func, args);
+    Py_DECREF(args);
+
+    if (!result) { PyErr_Print(); return -1; }
+    int ret = PyLong_AsLong(result);
+    Py_DECREF(result);
+    return ret;
+}
+
+int get_depression_stats(ModelHandle handle, int* depressions, int* recomputed,
+                         int* full_floods) {
+    if (!get_depression_stats_func) return -1;
+    ApiCall call(handle);
+
+    PyObject* args = PyTuple_New(1);
+    PyTuple_SetItem(args, 0, PyLong_FromLong(handle));
+
+    PyObject* result = PyObject_CallObject(get_depression_stats_func, args);
+    Py_DECREF(args);
+
+    if (!result) { PyErr_Print(); return -1; }
+
+    if (PyTuple_Check(result) && PyTuple_Size(result) == 3) {
+        if (depressions) *depressions = (int)PyLong_AsLong(PyTuple_GetItem(result, 0));
+        if (recomputed)  *recomputed  = (int)PyLong_AsLong(PyTuple_GetItem(result, 1));
+        if (full_floods) *full_floods = (int)PyLong_AsLong(PyTuple_GetItem(result, 2));
+        Py_DECREF(result);
+        return 0;
+    }
+    Py_DECREF(result);
+    return -1;
+}
+
+int get_output_stats(ModelHandle handle, int* writes, double* seconds) {
+    if (!get_output_stats_func) return -1;
+    ApiCall call(handle);
+
+    PyObject* args = PyTuple_New(1);
+    PyTuple_SetItem(args, 0, PyLong_FromLong(handle));
+
+    PyObject* result = PyObject_CallObject(get_output_stats_func, args);
+    Py_DECREF(args);
+
+    if (!result) { PyErr_Print(); return -1; }
+
+    if (PyTuple_Check(result) && PyTuple_Size(result) == 2) {
+        if (writes)  *writes  = (int)PyLong_AsLong(PyTuple_GetItem(result, 0));
+        if (seconds) *seconds = PyFloat_AsDouble(PyTuple_GetItem(result, 1));
+        Py_DECREF(result);
+        return 0;
+    }
+    Py_DECREF(result);
+    return -1;
+}
+
+int gospl_set_gc_policy(int mode) {
+    if (!set_gc_policy_func) return -1;
+    ApiCall call;
+
+    PyObject* args = PyTuple_New(1);
+    PyTuple_SetItem(args, 0, PyLong_FromLong(mode));
+
+    PyObject* result = PyObject_CallObject(set_gc_policy_func, args);
+    Py_DECREF(args);
+
+    if (!result) { PyErr_Print(); return -1; }
+    int ret = PyLong_AsLong(result);
+    Py_DECREF(result);
+    return ret;
+}
+
+int gospl_collect_garbage() {
+    if (!collect_garbage_func) return -1;
+    ApiCall call;
+
+    PyObject* result = PyObject_CallObject(collect_garbage_func, nullptr);
+    if (!result) { PyErr_Print(); return -1; }
+    int ret = PyLong_AsLong(result);
+    Py_DECREF(result);
+    return ret;
+}
+
+int gospl_get_gc_stats(int* collections, int* in_step, double* total_pause,
+                       double* max_pause) {
+    if (!get_gc_stats_func) return -1;
+    ApiCall call;
+
+    PyObject* result = PyObject_CallObject(get_gc_stats_func, nullptr);
+    if (!result) { PyErr_Print(); return -1; }
+
+    if (PyTuple_Check(result) && PyTuple_Size(result) == 4) {
+        if (collections) *collections = (int)PyLong_AsLong(PyTuple_GetItem(result, 0));
+        if (in_step)     *in_step     = (int)PyLong_AsLong(PyTuple_GetItem(result, 1));
+        if (total_pause) *total_pause = PyFloat_AsDouble(PyTuple_GetItem(result, 2));
+        if (max_pause)   *max_pause   = PyFloat_AsDouble(PyTuple_GetItem(result, 3));
+        Py_DECREF(result);
+        return 0;
+    }
+    Py_DECREF(result);
+    return -1;
+}
+
+int gospl_log_configure(int level, int rank_filter, const char* path) {
+    if (level < GOSPL_LOG_ERROR || level > GOSPL_LOG_DEBUG) return -1;
+    Logger& log = logger();
+    FILE* out = nullptr;
+    if (path && *path) {
+        std::string name(path);
+        const size_t at = name.find("%r");
+        if (at != std::string::npos) name.replace(at, 2, std::to_string(log_rank()));
+        out = std::fopen(name.c_str(), "a");
+        if (!out) return -1;
+    }
+    {
+        std::lock_guard<std::mutex> drain(log.drain_mutex);
+        drain_log();
+        if (log.out) std::fclose(log.out);
+        log.out = out;
+    }
+    log.level.store(level);
+    log.rank_filter.store(rank_filter);
+    log.configured.store(true);
+    if (gospl_module && Py_IsInitialized()) {
+        ApiCall call;
+        configure_python_log(true);
+    }
+    return 0;
+}
+
+void gospl_log_set_rank(int rank) {
+    logger().rank.store(rank < 0 ? 0 : rank);
+}
+
+void gospl_log(int level, const char* source, const char* message) {
+    log_record(level, source, message);
+}
+
+int gospl_log_flush() {
+    Logger& log = logger();
+    std::lock_guard<std::mutex> drain(log.drain_mutex);
+    return (int)drain_log();
+}
+
+int gospl_log_get_stats(long long* written, long long* dropped) {
+    Logger& log = logger();
+    if (written) *written = log.written.load();
+    if (dropped) *dropped = log.dropped.load();
+    return 0;
+}
+
+int gospl_numpy_allocator_configure(size_t arena_bytes, int huge_pages,
+                                    GosplHostAlloc host_alloc, GosplHostFree host_free,
+                                    void* user_data) {
+    NumpyAllocator& a = numpy_allocator();
+    std::lock_guard<std::mutex> lock(a.mutex);
+    if (a.capsule || a.allocations || (host_free && !host_alloc)) return -1;
+    if (huge_pages) arena_bytes = (arena_bytes + kHugePage - 1) / kHugePage * kHugePage;
+    a.arena_bytes = arena_bytes;
+    a.huge_pages = huge_pages != 0;
+    a.host_alloc = host_alloc;
+    a.host_free = host_free;
+    a.host_data = user_data;
+    return 0;
+}
+
+int gospl_numpy_allocator_enable(int enabled) {
+    if (!gospl_module) return -1;
+    ApiCall call;
+    NumpyAllocator& a = numpy_allocator();
+    if (enabled && !a.capsule) {
+        a.capsule = PyCapsule_New(&numpy_handler, "mem_handler", nullptr);
+        if (!a.capsule) {
+            PyErr_Print();
+            return -1;
+        }
+    }
+    if (!a.capsule) return 0;
+    numpy_allocator_state = enabled ? 1 : 2;
+    sync_numpy_allocator();
+    return 0;
+}
+
+long long gospl_numpy_allocator_trim() {
+    NumpyAllocator& a = numpy_allocator();
+    std::lock_guard<std::mutex> lock(a.mutex);
+    long long released = 0;
+    for (int c = 0; c < kPoolClasses; ++c) {
+        const size_t block = size_t(1) << (c + kPoolMinShift);
+        std::vector<void*>& free_list = a.pool[c];
+        size_t kept = 0;
+        for (void* p : free_list) {
+            char* b = static_cast<char*>(p);
+            if (b >= a.arena && b < a.arena + a.arena_size) {
+                // Arena blocks stay listed; their pages go back to the system
+                if (!a.host_alloc && madvise(b, block, MADV_DONTNEED) == 0)
+                    released += (long long)block;
+                free_list[kept++] = p;
+            } else {
+                backing_free(a, b, block);
+                released += (long long)block;
+            }
+        }
+        free_list.resize(kept);
+    }
+    return released;
+}
+
+int gospl_numpy_allocator_get_stats(long long* allocations, long long* pool_hits,
+                                    long long* fallbacks, long long* bytes_in_use,
+                                    long long* peak_bytes, long long* arena_used) {
+    NumpyAllocator& a = numpy_allocator();
+    std::lock_guard<std::mutex> lock(a.mutex);
+    if (allocations) *allocations = a.allocations;
+    if (pool_hits) *pool_hits = a.pool_hits;
+    if (fallbacks) *fallbacks = a.fallbacks;
+    if (bytes_in_use) *bytes_in_use = a.in_use;
+    if (peak_bytes) *peak_bytes = a.peak;
+    if (arena_used) *arena_used = (long long)a.arena_used;
+    return 0;
+}
+
+int gospl_profiler_start(double hz, const char* path) {
+    if (!gospl_module || !path || !*path || !(hz >= 1.0 && hz <= 10000.0)) return -1;
+    Profiler& p = profiler();
+    if (p.sampler.joinable()) return -1;
+    p.interval = std::chrono::microseconds((long long)(1.0e6 / hz));
+    p.path = path;
+    p.stopping = false;
+    p.samples = 0;
+    p.distinct = 0;
+    p.sampling_ns = 0;
+    profiler_active = true;
+    p.sampler = std::thread(sample_loop);
+    return 0;
+}
+
+int gospl_profiler_stop() {
+    return stop_profiler();
+}
+
+int gospl_profiler_get_stats(long long* samples, long long* stacks, double* sampling_seconds) {
+    Profiler& p = profiler();
+    if (samples) *samples = p.samples.load();
+    if (stacks) *stacks = p.distinct.load();
+    if (sampling_seconds) *sampling_seconds = p.sampling_ns.load() * 1.0e-9;
+    return 0;
+}
+
+// ---------------------------------------------------------------------------
+
+int gospl_fork() {
+    if (!Py_IsInitialized()) return (int)fork();
+    if (profiler_active.load()) {
+        log_record(GOSPL_LOG_ERROR, "gospl_fork", "stop the profiler before forking");
+        return -1;
+    }
+    // No speculative interval may be running Python in a thread the child
+    // would not have.
+    join_all_speculations();
+    ApiCall call;
+    PyOS_BeforeFork();
+    pid_t pid = fork();
+    if (pid == 0)
+        PyOS_AfterFork_Child();
+    else
+        PyOS_AfterFork_Parent();
+    return (int)pid;
+}
+
 // ---------------------------------------------------------------------------
 
 int create_velocity_field(double t, double center_x, double center_y, double amplitude,
@@ -1,6 +1,8 @@
 #ifndef GOSPL_EXTENSIONS_H
 #define GOSPL_EXTENSIONS_H
 
+#include <stddef.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -21,6 +23,26 @@ extern "C" {
 // Handle type for model instances
 typedef int ModelHandle;
 
+/**
+ * Host forcing callback for register_forcing_callback(). Fills values at the
+ * registered points for the requested model time and returns 0, or non-zero
+ * to abort the run. Called without the Python GIL held.
+ *
+ * @param time       Model time in years
+ * @param num_points Number of registered points
+ * @param coords     Registered point coordinates (num_points * 3)
+ * @param values     Output buffer: num_points * 3 interleaved (vx, vy, vz) for
+ *                   GOSPL_FORCING_VELOCITY, num_points for GOSPL_FORCING_UPLIFT,
+ *                   all in m/yr
+ * @param user_data  Pointer given at registration
+ */
+typedef int (*ForcingCallback)(double time, int num_points, const double* coords,
+                               double* values, void* user_data);
+
+// Forcing kinds for register_forcing_callback()
+#define GOSPL_FORCING_VELOCITY 0
+#define GOSPL_FORCING_UPLIFT   1
+
 // Structure for velocity data
 struct VelocityData {
     double* coords;      // Array of coordinates (num_points * 3)
@@ -112,7 +134,8 @@ int apply_velocity_data(ModelHandle handle, const double* coords, const double*
  * Get current simulation time.
  * 
  * @param handle Model handle
- * @return Current time on success, -1.0 on error
+ * @return Current time on success (negative for runs starting in the past),
+ *         NaN on error
  */
 double get_current_time(ModelHandle handle);
 
@@ -138,6 +161,29 @@ double get_time_step(ModelHandle handle);
 int interpolate_elevation_to_points(ModelHandle handle, const double* coords, int num_points,
                                    double* elevations, int k, double power);
 
+/**
+ * Merge small concurrent interpolate_elevation_to_points() calls. Calls on the
+ * same handle with the same k and power that arrive within window_us of the
+ * first one are answered by a single batched query, which is issued early once
+ * max_points points are pending. Calls with at least max_points points bypass
+ * coalescing. A window of 0 (the default) disables coalescing.
+ *
+ * @param window_us  Collection window in microseconds (>= 0)
+ * @param max_points Batch size that triggers the query immediately (> 0)
+ * @return 0 on success, -1 on invalid arguments
+ */
+int configure_query_coalescing(int window_us, int max_points);
+
+/**
+ * Report how many coalescable queries were received and how many batched
+ * queries answered them.
+ *
+ * @param queries Output number of coalesced calls
+ * @param batches Output number of batched queries issued
+ * @return 0 on success
+ */
+int get_query_coalescing_stats(long* queries, long* batches);
+
 /**
  * Apply elevation data to the model's internal mesh.
  * Updates the goSPL mesh elevations using external (DES) topography values.
@@ -177,6 +223,31 @@ int set_surface_velocity(ModelHandle handle,
                          const double* vz_yr,
                          int num_points, int k, double power);
 
+/**
+ * Accumulate a time-weighted DES surface velocity sample (m/yr) on the GoSPL
+ * mesh. Call once per DES step with that step's duration dt_des (years); the
+ * next run_and_get_erosion() uses the time average of all samples as its
+ * velocity override and resets the accumulators. The IDW neighbour weights
+ * are reused while the coordinates are unchanged.
+ *
+ * @param handle     Model handle
+ * @param coords     DES surface node coordinates (num_points * 3)
+ * @param vx_yr      X-velocity at each node in m/yr (num_points)
+ * @param vy_yr      Y-velocity at each node in m/yr (num_points)
+ * @param vz_yr      Z-velocity (uplift) at each node in m/yr (num_points)
+ * @param num_points Number of DES surface nodes
+ * @param dt_des     Duration of the DES step in years (> 0)
+ * @param k          IDW nearest-neighbour count
+ * @param power      IDW power exponent
+ * @return 0 on success, -1 on error
+ */
+int accumulate_surface_velocity(ModelHandle handle,
+                                const double* coords,
+                                const double* vx_yr,
+                                const double* vy_yr,
+                                const double* vz_yr,
+                                int num_points, double dt_des, int k, double power);
+
 /**
  * Interpolate DES vertical velocities (m/yr) onto GoSPL mesh nodes and store
  * internally. Consumed by the next run_and_get_erosion() call, which runs GoSPL
@@ -199,6 +270,8 @@ int set_uplift_rate(ModelHandle handle, const double* coords, const double* vz_y
  * Uses native-mesh differencing (no extra IDW pass for the before/after trick).
  * If set_uplift_rate() was called, the stored upsub is applied and GoSPL runs
  * with skip_tectonics=True.
+ * The per-point erosion rate (erosion / dt) is kept on the C side for
+ * get_erosion_rate() and extrapolate_erosion().
  *
  * @param handle     Model handle
  * @param dt         Coupling interval in years
@@ -212,6 +285,67 @@ int set_uplift_rate(ModelHandle handle, const double* coords, const double* vz_y
 int run_and_get_erosion(ModelHandle handle, double dt, const double* coords,
                         int num_points, double* erosion, int k, double power);
 
+/**
+ * Copy the erosion rate (m/yr) at the query points of the last
+ * run_and_get_erosion() or run_and_get_erosion_sparse() call.
+ *
+ * @param handle     Model handle
+ * @param rate       Output rate array (num_points doubles)
+ * @param num_points Must equal num_points of the last erosion call
+ * @return 0 on success, -1 if no rate is stored or num_points differs
+ */
+int get_erosion_rate(ModelHandle handle, double* rate, int num_points);
+
+/**
+ * Extrapolate erosion over dt years from the last stored erosion rate
+ * (erosion[i] = rate[i] * dt) without calling into Python, so DES can apply
+ * smooth surface updates every mechanical step between GoSPL runs.
+ *
+ * @param handle     Model handle
+ * @param dt         Time span in years
+ * @param erosion    Output erosion array (num_points doubles)
+ * @param num_points Must equal num_points of the last erosion call
+ * @return Number of points written on success, -1 if no rate is stored or
+ *         num_points differs
+ */
+int extrapolate_erosion(ModelHandle handle, double dt, double* erosion, int num_points);
+
+/**
+ * Sparse variant of run_and_get_erosion(): run GoSPL for dt years and return
+ * only the query points whose |erosion| exceeds threshold, as (index, value)
+ * pairs. The total count is returned even when it exceeds capacity; in that
+ * case the first capacity pairs are written and the full result can be
+ * fetched with get_sparse_erosion() after enlarging the buffers. The stored
+ * erosion rate is zero for points at or below the threshold.
+ *
+ * @param handle     Model handle
+ * @param dt         Coupling interval in years
+ * @param coords     Query coordinates (num_points * 3)
+ * @param num_points Number of query points
+ * @param threshold  |erosion| threshold in metres
+ * @param indices    Output query point indices (capacity ints)
+ * @param values     Output erosion in metres (capacity doubles)
+ * @param capacity   Size of the indices/values buffers
+ * @param k          IDW nearest-neighbour count
+ * @param power      IDW power exponent
+ * @return Number of points above threshold on success, -1 on error
+ */
+int run_and_get_erosion_sparse(ModelHandle handle, double dt, const double* coords,
+                               int num_points, double threshold, int* indices,
+                               double* values, int capacity, int k, double power);
+
+/**
+ * Copy the result of the last run_and_get_erosion_sparse() call again,
+ * without rerunning GoSPL.
+ *
+ * @param handle   Model handle
+ * @param indices  Output query point indices (capacity ints)
+ * @param values   Output erosion in metres (capacity doubles)
+ * @param capacity Size of the indices/values buffers
+ * @return Number of points above threshold on success, -1 on error
+ */
+int get_sparse_erosion(ModelHandle handle, int* indices, double* values, int capacity);
+
 /**
  * Gently blend GoSPL's internal elevation field toward the DES elevation.
  * h_new[i] = h[i] + alpha * (h_des_on_mesh[i] - h[i])
@@ -230,6 +364,476 @@ int run_and_get_erosion(ModelHandle handle, double dt, const double* coords,
 int apply_drift_correction(ModelHandle handle, const double* coords, const double* des_elev,
                            int num_points, double alpha, int k, double power);
 
+/**
+ * Set the value-change tolerance used by set_surface_velocity() and
+ * set_uplift_rate(). DES points whose values changed by at most tol (m/yr)
+ * since the previous transfer count as unchanged: if none changed, the
+ * previously interpolated mesh fields are reused; otherwise only mesh nodes
+ * with a changed IDW neighbour are recomputed. The default 0.0 only skips
+ * exactly repeated values.
+ *
+ * @param handle Model handle
+ * @param tol    Non-negative tolerance in m/yr
+ * @return 0 on success, -1 on error
+ */
+int set_transfer_tolerance(ModelHandle handle, double tol);
+
+/**
+ * Report how often DES -> mesh transfers were skipped or partially updated.
+ *
+ * @param handle       Model handle
+ * @param skip_rate    Output fraction of transfers that reused the previous fields
+ * @param partial_rate Output fraction of transfers that updated a subset of nodes
+ * @return 0 on success, -1 on error
+ */
+int get_transfer_stats(ModelHandle handle, double* skip_rate, double* partial_rate);
+
+/**
+ * Declare the DES surface point set used by the sparse upload functions.
+ * Builds the DES -> mesh IDW table and its reverse neighbour map once; the
+ * sparse calls then only recompute mesh nodes near the changed points.
+ * Full set_surface_velocity()/set_uplift_rate() calls on the same coordinates
+ * share the table.
+ *
+ * @param handle     Model handle
+ * @param coords     DES surface node coordinates (num_points * 3)
+ * @param num_points Number of DES surface nodes
+ * @param k          IDW nearest-neighbour count
+ * @param power      IDW power exponent
+ * @return 0 on success, -1 on error
+ */
+int declare_surface_points(ModelHandle handle, const double* coords, int num_points,
+                           int k, double power);
+
+/**
+ * Sparse variant of set_surface_velocity(): update the velocities (m/yr) of
+ * num_changed points of the declared set; other points keep their last values.
+ *
+ * @param handle      Model handle
+ * @param indices     Indices into the declared point set (num_changed)
+ * @param vx_yr       New X-velocities in m/yr (num_changed)
+ * @param vy_yr       New Y-velocities in m/yr (num_changed)
+ * @param vz_yr       New Z-velocities (uplift) in m/yr (num_changed)
+ * @param num_changed Number of changed points
+ * @return 0 on success, -1 on error
+ */
+int set_surface_velocity_sparse(ModelHandle handle, const int* indices,
+                                const double* vx_yr, const double* vy_yr,
+                                const double* vz_yr, int num_changed);
+
+/**
+ * Sparse variant of set_uplift_rate(): update the vertical velocity (m/yr) of
+ * num_changed points of the declared set.
+ *
+ * @param handle      Model handle
+ * @param indices     Indices into the declared point set (num_changed)
+ * @param vz_yr       New vertical velocities in m/yr (num_changed)
+ * @param num_changed Number of changed points
+ * @return 0 on success, -1 on error
+ */
+int set_uplift_rate_sparse(ModelHandle handle, const int* indices, const double* vz_yr,
+                           int num_changed);
+
+/**
+ * Register plate IDs for parametric plate motion. Each GoSPL mesh node takes
+ * the ID of the nearest given point. Call once, and again only when the plate
+ * geometry changes.
+ *
+ * @param handle     Model handle
+ * @param coords     Point coordinates (num_points * 3)
+ * @param plate_ids  Non-negative plate ID per point (num_points)
+ * @param num_points Number of points
+ * @return 0 on success, -1 on error
+ */
+int register_plate_ids(ModelHandle handle, const double* coords, const int* plate_ids,
+                       int num_points);
+
+/**
+ * Set rigid plate motion for the next run_and_get_erosion() call from one
+ * Euler rotation vector per plate. Velocities are evaluated on the mesh as
+ * v = omega[plate_id] x r, so only num_plates * 3 values cross the interface.
+ * On global meshes all three components drive horizontal (tangential)
+ * advection; flat meshes accept only rotation about the vertical axis. The
+ * vertical rate comes from set_uplift_rate() (zero if it was not called).
+ *
+ * @param handle     Model handle
+ * @param omega      Cartesian rotation vectors in rad/yr (num_plates * 3),
+ *                   row i for plate ID i
+ * @param num_plates Number of plates
+ * @return 0 on success, -1 on error
+ */
+int set_euler_poles(ModelHandle handle, const double* omega, int num_plates);
+
+/**
+ * Let GoSPL pull forcing from the host at its own step times. While a
+ * callback is registered, run_and_get_erosion() splits each interval into
+ * set_forcing_substeps() steps, calls fn at the midpoint time of each step and
+ * interpolates the result onto the mesh in place of set_surface_velocity()
+ * (GOSPL_FORCING_VELOCITY) or set_uplift_rate() (GOSPL_FORCING_UPLIFT) input.
+ * The coordinates are copied; speculation is skipped while callbacks are set.
+ *
+ * @param handle     Model handle
+ * @param kind       GOSPL_FORCING_VELOCITY or GOSPL_FORCING_UPLIFT
+ * @param coords     Host point coordinates (num_points * 3)
+ * @param num_points Number of host points
+ * @param fn         Callback, or NULL to unregister this kind
+ * @param user_data  Passed through to fn
+ * @return 0 on success, -1 on error
+ */
+int register_forcing_callback(ModelHandle handle, int kind, const double* coords,
+                              int num_points, ForcingCallback fn, void* user_data);
+
+/**
+ * Set the number of forcing pulls (substeps) per coupling interval used while
+ * forcing callbacks are registered. Defaults to 1.
+ *
+ * @param handle       Model handle
+ * @param num_substeps Number of substeps, at least 1
+ * @return 0 on success, -1 on error
+ */
+int set_forcing_substeps(ModelHandle handle, int num_substeps);
+
+/**
+ * Process large neighbour searches (mesh <-> host point transfers and
+ * advection) in Morton (Z-curve) order of the query points, which keeps
+ * consecutive searches in the same KD-tree leaves. Results are unchanged.
+ * Off by default.
+ *
+ * @param handle  Model handle
+ * @param enabled Non-zero to enable, 0 to disable
+ * @return 0 on success, -1 on error
+ */
+int set_locality_ordering(ModelHandle handle, int enabled);
+
+/**
+ * Enable speculative execution of the next coupling interval.
+ * While enabled, each successful run_and_get_erosion() or
+ * run_and_get_erosion_sparse() starts a background thread that runs the next
+ * interval with the velocities just used. The next erosion call commits that
+ * result if the velocities set since then match within tolerance (max-norm)
+ * and dt, k and power are unchanged; otherwise the model state is rolled back
+ * and the interval is rerun. Any other call on the handle waits for the
+ * background run; calls that modify the model state discard it.
+ * Requires the interpreter to be owned by initialize_gospl_extensions().
+ *
+ * @param handle    Model handle
+ * @param enabled   Non-zero to enable, 0 to disable
+ * @param tolerance Non-negative velocity tolerance in m/yr
+ * @return 0 on success, -1 on error
+ */
+int enable_speculation(ModelHandle handle, int enabled, double tolerance);
+
+/**
+ * Report how many speculative intervals were committed or rolled back.
+ *
+ * @param handle      Model handle
+ * @param committed   Output number of committed speculations
+ * @param rolled_back Output number of rolled-back speculations
+ * @return 0 on success, -1 on error
+ */
+int get_speculation_stats(ModelHandle handle, int* committed, int* rolled_back);
+
+/**
+ * Enable active-set stepping. After each step, nodes whose elevation changed
+ * by more than threshold (m), whose drainage area changed by more than
+ * area_threshold (relative) or that receive flow from such nodes are active,
+ * plus buffer rings of neighbours; elevation edits between steps also
+ * activate nodes. Steps with no active node run GoSPL's tectonics only,
+ * and at most full_sweep_every - 1 such steps run in a row.
+ *
+ * @param handle           Model handle
+ * @param threshold        Elevation change threshold in metres; <= 0 disables
+ * @param area_threshold   Relative drainage area change threshold
+ * @param buffer           Neighbour rings added to the active set
+ * @param full_sweep_every Maximum interval (in steps) between full steps
+ * @return 0 on success, -1 on error
+ */
+int set_active_set(ModelHandle handle, double threshold, double area_threshold,
+                   int buffer, int full_sweep_every);
+
+/**
+ * Report active-set stepping counters.
+ *
+ * @param handle          Model handle
+ * @param steps           Output number of steps run
+ * @param skipped         Output number of steps run with tectonics only
+ * @param active_fraction Output fraction of active nodes after the last step
+ * @return 0 on success, -1 on error
+ */
+int get_active_set_stats(ModelHandle handle, int* steps, int* skipped, double* active_fraction);
+
+/**
+ * Solve GoSPL's water and sediment flux accumulation basin by basin. The
+ * receiver graph is split into drainage basins, which are swept on a thread
+ * pool largest first. GoSPL's global PETSc solve is used instead on
+ * distributed meshes, when one basin holds more than giant_fraction of the
+ * nodes, or when the library's native kernel is unavailable.
+ *
+ * @param handle         Model handle
+ * @param enabled        Non-zero to enable, 0 to disable
+ * @param num_threads    Worker threads; <= 0 uses all cores
+ * @param giant_fraction Largest-basin node fraction in (0, 1] above which the
+ *                       global solve is used
+ * @return 0 on success, -1 on error
+ */
+int set_catchment_parallel(ModelHandle handle, int enabled, int num_threads,
+                           double giant_fraction);
+
+/**
+ * Report catchment-parallel flow accumulation counters.
+ *
+ * @param handle    Model handle
+ * @param solves    Output number of per-basin solves
+ * @param fallbacks Output number of solves left to GoSPL's global solver
+ * @param basins    Output number of basins in the last flow graph
+ * @return 0 on success, -1 on error
+ */
+int get_catchment_stats(ModelHandle handle, int* solves, int* fallbacks, int* basins);
+
+/**
+ * Track the filled (depression-free) surface on demand. Each
+ * get_depression_stats() call refloods only the depressions around nodes that
+ * moved by more than tolerance since the previous call (erosion, uplift
+ * overrides, drift correction). Stepping does not update it: GoSPL fills pits
+ * itself and routes flow over its own filled surface.
+ *
+ * @param handle    Model handle
+ * @param enabled   Non-zero to enable, 0 to disable
+ * @param tolerance Elevation change (m) below which a node counts as unchanged
+ * @return 0 on success, -1 on error
+ */
+int set_incremental_depressions(ModelHandle handle, int enabled, double tolerance);
+
+/**
+ * Bring the depression state up to date with the current elevations and
+ * report its counters.
+ *
+ * @param handle      Model handle
+ * @param depressions Output number of depressions
+ * @param recomputed  Output number of depressions this update reflooded
+ * @param full_floods Output number of floods of the whole mesh
+ * @return 0 on success, -1 on error (including when disabled)
+ */
+int get_depression_stats(ModelHandle handle, int* depressions, int* recomputed,
+                         int* full_floods);
+
+/**
+ * Report the time goSPL spent writing its own output (HDF5/XDMF snapshots).
+ *
+ * @param handle  Model handle
+ * @param writes  Output number of output calls so far
+ * @param seconds Output wall time spent in them
+ * @return 0 on success, -1 on error
+ */
+int get_output_stats(ModelHandle handle, int* writes, double* seconds);
+
+/**
+ * Set the interpreter's garbage collector policy for stepping and transfer
+ * calls (run_processes_*, set_* / apply_* transfers, erosion queries). Applies
+ * to all models.
+ *
+ * @param mode 0 = interpreter default, 1 = no automatic collection inside
+ *             those calls (collect with gospl_collect_garbage()),
+ *             2 = freeze existing objects for the duration of each call
+ * @return 0 on success, -1 on error
+ */
+int gospl_set_gc_policy(int mode);
+
+/**
+ * Run a full garbage collection now. Call it at points where a pause does not
+ * matter, e.g. between coupling intervals.
+ *
+ * @return Number of unreachable objects found, or -1 on error
+ */
+int gospl_collect_garbage();
+
+/**
+ * Report garbage collector pauses since initialization.
+ *
+ * @param collections Output number of automatic collections
+ * @param in_step     Output automatic collections inside stepping/transfer calls
+ * @param total_pause Output total pause of all collections (s), including
+ *                    gospl_collect_garbage()
+ * @param max_pause   Output longest single pause (s)
+ * @return 0 on success, -1 on error
+ */
+int gospl_get_gc_stats(int* collections, int* in_step, double* total_pause,
+                       double* max_pause);
+
+// Log levels for gospl_log_configure() and gospl_log(), most severe first
+#define GOSPL_LOG_ERROR 0
+#define GOSPL_LOG_WARN  1
+#define GOSPL_LOG_INFO  2
+#define GOSPL_LOG_DEBUG 3
+
+/**
+ * Configure the library's log. Records from the library, from Python (error
+ * reports, verbose model output and, once configured, everything Python
+ * prints) and from gospl_log() are queued in a lock-free in-memory ring and
+ * written by a background thread as lines of the form
+ * "<seconds> rank=<r> <LEVEL> <source>: <message> key=value ...".
+ * May be called before initialize_gospl_extensions().
+ *
+ * @param level       Most verbose level written (GOSPL_LOG_*)
+ * @param rank_filter Only this rank writes records below GOSPL_LOG_ERROR;
+ *                    -1 lets every rank write
+ * @param path        Output file (appended; "%r" is replaced by the rank), or
+ *                    NULL for stderr
+ * @return 0 on success, -1 on error
+ */
+int gospl_log_configure(int level, int rank_filter, const char* path);
+
+/**
+ * Set the rank reported in log records. Defaults to the MPI launcher's rank
+ * variables (OMPI_COMM_WORLD_RANK, PMI_RANK, PMIX_RANK, SLURM_PROCID), else 0.
+ *
+ * @param rank Rank of this process
+ */
+void gospl_log_set_rank(int rank);
+
+/**
+ * Queue a log record. Never blocks: when the ring is full the record is
+ * dropped and counted. Messages longer than 223 bytes are truncated.
+ *
+ * @param level   GOSPL_LOG_* level
+ * @param source  Short origin tag (e.g. "driver")
+ * @param message Message text
+ */
+void gospl_log(int level, const char* source, const char* message);
+
+/**
+ * Write out all queued records now.
+ *
+ * @return Number of records written
+ */
+int gospl_log_flush();
+
+/**
+ * Report log counters.
+ *
+ * @param written Output number of records written
+ * @param dropped Output number of records dropped because the ring was full
+ * @return 0 on success
+ */
+int gospl_log_get_stats(long long* written, long long* dropped);
+
+/**
+ * Host allocator used for the numpy arena and large blocks. Returned memory
+ * must be aligned to at least 16 bytes.
+ */
+typedef void* (*GosplHostAlloc)(size_t size, void* user_data);
+typedef void (*GosplHostFree)(void* ptr, size_t size, void* user_data);
+
+/**
+ * Configure the numpy data allocator installed by
+ * gospl_numpy_allocator_enable(). Buffers of 4 KiB to 64 MiB are rounded up
+ * to a power of two and carved from one arena, with freed blocks reused per
+ * size class; larger buffers get their own mapping and smaller ones come
+ * from the system allocator (64-byte aligned, on the host's malloc heap).
+ * Must be called before the allocator is first enabled.
+ *
+ * @param arena_bytes Arena size (address space reserved on first use;
+ *                    default 1 GiB); 0 for no arena
+ * @param huge_pages  Back the arena and large blocks with huge pages (1) or
+ *                    not (0); falls back to transparent huge pages
+ * @param host_alloc  Optional host allocator supplying the arena and large
+ *                    blocks instead of anonymous mappings (NULL for none)
+ * @param host_free   Matching release function (may be NULL if the host
+ *                    reclaims the memory itself)
+ * @param user_data   Passed to host_alloc and host_free
+ * @return 0 on success, -1 if already in use or inconsistent
+ */
+int gospl_numpy_allocator_configure(size_t arena_bytes, int huge_pages,
+                                    GosplHostAlloc host_alloc, GosplHostFree host_free,
+                                    void* user_data);
+
+/**
+ * Install (1) or withdraw (0) the arena allocator as numpy's data memory
+ * handler for arrays created by the extensions. Arrays keep the allocator
+ * they were created with. Must be repeated after a re-initialization.
+ *
+ * @param enabled 1 to install, 0 to restore numpy's default
+ * @return 0 on success, -1 on error (e.g. interface not initialized)
+ */
+int gospl_numpy_allocator_enable(int enabled);
+
+/**
+ * Return the memory of the cached free blocks to the system (they stay
+ * reusable).
+ *
+ * @return Number of bytes released
+ */
+long long gospl_numpy_allocator_trim();
+
+/**
+ * Report numpy allocator statistics.
+ *
+ * @param allocations  Output number of buffers allocated
+ * @param pool_hits    Output number served from a size-class free list
+ * @param fallbacks    Output number of pooled blocks allocated outside the
+ *                     arena because it was full
+ * @param bytes_in_use Output bytes currently allocated
+ * @param peak_bytes   Output highest bytes_in_use
+ * @param arena_used   Output bytes of the arena handed out
+ * @return 0 on success
+ */
+int gospl_numpy_allocator_get_stats(long long* allocations, long long* pool_hits,
+                                    long long* fallbacks, long long* bytes_in_use,
+                                    long long* peak_bytes, long long* arena_used);
+
+/**
+ * Start the sampling profiler.
+ *
+ * A timer thread samples the Python stack of every thread inside the
+ * interface, rooted at the C function it entered through (wall-clock, so
+ * time spent in numpy or other native code shows at its Python call site).
+ * Identical stacks are counted and written as folded stacks, one
+ * "entry;frame;...;frame count" line each, for flamegraph.pl, speedscope and
+ * similar tools, when the profiler stops and at the latest in
+ * finalize_gospl_extensions(). Setting GOSPL_PROFILE=<path> (and optionally
+ * GOSPL_PROFILE_HZ, default 100) starts it from initialize_gospl_extensions().
+ *
+ * @param hz   Samples per second, 1 to 10000
+ * @param path Output file; "%r" is replaced by the MPI rank
+ * @return 0 on success, -1 if not initialized, already running or invalid
+ */
+int gospl_profiler_start(double hz, const char* path);
+
+/**
+ * Stop the sampling profiler and write its folded stacks.
+ *
+ * @return Number of distinct stacks written, -1 if the profiler was not
+ *         running or the file could not be written
+ */
+int gospl_profiler_stop();
+
+/**
+ * Report sampling profiler counters of the current or last run.
+ *
+ * @param samples          Output number of thread stacks sampled
+ * @param stacks           Output number of distinct stacks
+ * @param sampling_seconds Output time the sampler held the GIL
+ * @return 0 on success
+ */
+int gospl_profiler_get_stats(long long* samples, long long* stacks, double* sampling_seconds);
+
+/**
+ * fork() the process with the interpreter in a consistent state: pending
+ * speculative intervals are joined, and the GIL is held around fork() with
+ * PyOS_BeforeFork()/PyOS_AfterFork_Parent()/PyOS_AfterFork_Child(), as
+ * os.fork() does. Call it from the thread that initialized the interface,
+ * with no other thread inside the API and the profiler stopped. Without an
+ * interpreter it is a plain fork().
+ *
+ * MPI (initialized by PETSc when goSPL is imported) does not survive fork():
+ * the child must not communicate, so forked models are only usable on a
+ * single rank, and some MPI implementations refuse to fork at all.
+ *
+ * @return As fork(): 0 in the child, the child's pid in the parent, -1 on
+ *         error (including while the profiler runs)
+ */
+int gospl_fork();
+
 /**
  * Create a rotational velocity field for testing.
  * This is a utility function that generates synthetic velocity data.
@@ -0,0 +1,444 @@
+#ifndef GOSPL_MODEL_HPP
+#define GOSPL_MODEL_HPP
+
+/**
+ * Header-only C++17 façade over the gospl_extensions C API.
+ *
+ * - gospl::Session initializes the interface and finalizes it on scope exit.
+ * - gospl::Model owns a model handle (RAII, movable, not copyable).
+ * - Arrays are passed as gospl::span views, so std::vector, std::array,
+ *   C arrays and (pointer, size) pairs all work without copies. Coordinates
+ *   are flat (x, y, z) triples.
+ * - Results are written into caller views, or into buffers owned by the
+ *   Model that are sized on first use (or by reserve()) and reused after
+ *   that; the returned views stay valid until the next call of the same kind.
+ * - Failures throw gospl::InitializationError, gospl::ModelError or
+ *   gospl::SizeError, all derived from gospl::Error.
+ *
+ * The raw handle is available through Model::handle() for the tuning calls
+ * that have no wrapper here.
+ */
+
+#include "gospl_extensions.h"
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstddef>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace gospl {
+
+// -----------------------------------------------------------------------------
+// Errors
+
+/** Base class of all errors raised by the façade. */
+class Error : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+/** The interface (Python interpreter, goSPL modules) could not be set up. */
+class InitializationError : public Error {
+public:
+    using Error::Error;
+};
+
+/** A call into the model failed; the Python side has logged the cause. */
+class ModelError : public Error {
+public:
+    explicit ModelError(const std::string& call)
+        : Error("gospl: " + call + " failed"), call_(call) {}
+
+    /** Name of the C API function that failed. */
+    const std::string& call() const noexcept { return call_; }
+
+private:
+    std::string call_;
+};
+
+/** Array views of inconsistent or unsupported sizes. */
+class SizeError : public Error {
+public:
+    using Error::Error;
+};
+
+// -----------------------------------------------------------------------------
+// Views
+
+/**
+ * Non-owning view of contiguous elements (the subset of std::span used here).
+ */
+template <class T>
+class span {
+public:
+    using element_type = T;
+    using value_type = std::remove_cv_t<T>;
+    using size_type = std::size_t;
+    using iterator = T*;
+
+    constexpr span() noexcept = default;
+    constexpr span(T* data, size_type size) noexcept : data_(data), size_(size) {}
+
+    /** Any contiguous container or array whose elements convert to T. */
+    template <class C,
+              class = std::enable_if_t<!std::is_same<std::decay_t<C>, span>::value &&
+                                       std::is_convertible<decltype(std::data(std::declval<C&>())),
+                                                           T*>::value>>
+    constexpr span(C&& c) noexcept : data_(std::data(c)), size_(std::size(c)) {}
+
+    constexpr T* data() const noexcept { return data_; }
+    constexpr size_type size() const noexcept { return size_; }
+    constexpr bool empty() const noexcept { return size_ == 0; }
+    constexpr T& operator[](size_type i) const noexcept { return data_[i]; }
+    constexpr iterator begin() const noexcept { return data_; }
+    constexpr iterator end() const noexcept { return data_ + size_; }
+
+    constexpr span first(size_type n) const noexcept { return span(data_, n); }
+
+private:
+    T* data_ = nullptr;
+    size_type size_ = 0;
+};
+
+/** Points above the threshold of a sparse erosion call. */
+struct SparseErosion {
+    span<const int> indices;   ///< Query point indices
+    span<const double> values; ///< Erosion in metres
+};
+
+// -----------------------------------------------------------------------------
+// Session
+
+/**
+ * Initializes the interface for its lifetime. Create one before any Model and
+ * let it outlive them all.
+ */
+class Session {
+public:
+    Session() {
+        if (initialize_gospl_extensions() != 0)
+            throw InitializationError("gospl: initialize_gospl_extensions failed");
+    }
+    ~Session() { finalize_gospl_extensions(); }
+
+    Session(const Session&) = delete;
+    Session& operator=(const Session&) = delete;
+};
+
+// -----------------------------------------------------------------------------
+// Model
+
+class Model {
+public:
+    /** An empty Model; assign a created one to it. */
+    Model() noexcept = default;
+
+    /**
+     * Create an EnhancedModel from a goSPL configuration file.
+     *
+     * @param config_path Path to the goSPL YAML configuration
+     */
+    explicit Model(const std::string& config_path)
+        : handle_(create_enhanced_model(config_path.c_str())) {
+        if (handle_ < 0) throw ModelError("create_enhanced_model");
+    }
+
+    ~Model() { reset(); }
+
+    Model(const Model&) = delete;
+    Model& operator=(const Model&) = delete;
+
+    Model(Model&& other) noexcept { swap(other); }
+    Model& operator=(Model&& other) noexcept {
+        if (this != &other) {
+            reset();
+            swap(other);
+        }
+        return *this;
+    }
+
+    void swap(Model& other) noexcept {
+        std::swap(handle_, other.handle_);
+        std::swap(erosion_points_, other.erosion_points_);
+        field_.swap(other.field_);
+        erosion_.swap(other.erosion_);
+        sparse_indices_.swap(other.sparse_indices_);
+        sparse_values_.swap(other.sparse_values_);
+    }
+
+    /** Destroy the model now; the object is left empty. */
+    void reset() noexcept {
+        if (handle_ >= 0) destroy_model(handle_);
+        handle_ = -1;
+        erosion_points_ = 0;
+    }
+
+    ModelHandle handle() const noexcept { return handle_; }
+    explicit operator bool() const noexcept { return handle_ >= 0; }
+
+    /**
+     * Size the output buffers for num_points query points, so that the
+     * buffer-returning calls below never allocate during the run.
+     */
+    void reserve(std::size_t num_points) {
+        grow(field_, num_points);
+        grow(erosion_, num_points);
+        grow(sparse_indices_, num_points);
+        grow(sparse_values_, num_points);
+    }
+
+    // -- time stepping --------------------------------------------------------
+
+    double time() const { return number(get_current_time(valid()), "get_current_time"); }
+    double time_step() const { return value(get_time_step(valid()), "get_time_step"); }
+
+    /** Run for dt; returns the wall-clock time spent. */
+    double run_for(double dt, bool verbose = false, bool skip_tectonics = false) {
+        return value(run_processes_for_dt(valid(), dt, verbose, skip_tectonics),
+                     "run_processes_for_dt");
+    }
+
+    /** Run num_steps steps of dt; returns the number of steps completed. */
+    int run_steps(int num_steps, double dt, bool verbose = false, bool skip_tectonics = false) {
+        return count(run_processes_for_steps(valid(), num_steps, dt, verbose, skip_tectonics),
+                     "run_processes_for_steps");
+    }
+
+    /** Run until target_time; returns the number of steps completed. */
+    int run_until(double target_time, double dt, bool verbose = false,
+                  bool skip_tectonics = false) {
+        return count(run_processes_until_time(valid(), target_time, dt, verbose, skip_tectonics),
+                     "run_processes_until_time");
+    }
+
+    // -- field transfers ------------------------------------------------------
+
+    void apply_velocity(span<const double> coords, span<const double> velocities, double timer,
+                        int k = 3, double power = 1.0) {
+        const int n = points(coords, "apply_velocity_data");
+        expect(velocities, 3 * std::size_t(n), "apply_velocity_data", "velocities");
+        check(apply_velocity_data(valid(), coords.data(), velocities.data(), n, timer, k, power),
+              "apply_velocity_data");
+    }
+
+    void apply_elevation(span<const double> coords, span<const double> elevations, int k = 3,
+                         double power = 1.0) {
+        const int n = points(coords, "apply_elevation_data");
+        expect(elevations, n, "apply_elevation_data", "elevations");
+        check(apply_elevation_data(valid(), coords.data(), elevations.data(), n, k, power),
+              "apply_elevation_data");
+    }
+
+    /** Interpolate the elevation to coords into out (one value per point). */
+    void interpolate_elevation(span<const double> coords, span<double> out, int k = 3,
+                               double power = 1.0) {
+        const int n = points(coords, "interpolate_elevation_to_points");
+        expect(out, n, "interpolate_elevation_to_points", "out");
+        check(interpolate_elevation_to_points(valid(), coords.data(), n, out.data(), k, power),
+              "interpolate_elevation_to_points");
+    }
+
+    /** Interpolate the elevation to coords into the Model's field buffer. */
+    span<const double> interpolate_elevation(span<const double> coords, int k = 3,
+                                             double power = 1.0) {
+        span<double> out = buffer(field_, coords.size() / 3);
+        interpolate_elevation(coords, out, k, power);
+        return out;
+    }
+
+    void set_surface_velocity(span<const double> coords, span<const double> vx,
+                              span<const double> vy, span<const double> vz, int k = 3,
+                              double power = 1.0) {
+        const int n = points(coords, "set_surface_velocity");
+        expect3(vx, vy, vz, n, "set_surface_velocity");
+        check(::set_surface_velocity(valid(), coords.data(), vx.data(), vy.data(), vz.data(), n,
+                                     k, power),
+              "set_surface_velocity");
+    }
+
+    void accumulate_surface_velocity(span<const double> coords, span<const double> vx,
+                                     span<const double> vy, span<const double> vz,
+                                     double dt_des, int k = 3, double power = 1.0) {
+        const int n = points(coords, "accumulate_surface_velocity");
+        expect3(vx, vy, vz, n, "accumulate_surface_velocity");
+        check(::accumulate_surface_velocity(valid(), coords.data(), vx.data(), vy.data(),
+                                            vz.data(), n, dt_des, k, power),
+              "accumulate_surface_velocity");
+    }
+
+    void set_uplift_rate(span<const double> coords, span<const double> vz, int k = 3,
+                         double power = 1.0) {
+        const int n = points(coords, "set_uplift_rate");
+        expect(vz, n, "set_uplift_rate", "vz");
+        check(::set_uplift_rate(valid(), coords.data(), vz.data(), n, k, power),
+              "set_uplift_rate");
+    }
+
+    void apply_drift_correction(span<const double> coords, span<const double> des_elevations,
+                                double alpha, int k = 3, double power = 1.0) {
+        const int n = points(coords, "apply_drift_correction");
+        expect(des_elevations, n, "apply_drift_correction", "des_elevations");
+        check(::apply_drift_correction(valid(), coords.data(), des_elevations.data(), n, alpha,
+                                       k, power),
+              "apply_drift_correction");
+    }
+
+    // -- erosion --------------------------------------------------------------
+
+    /** Run for dt and write the net erosion (m) at coords into out. */
+    void run_and_get_erosion(double dt, span<const double> coords, span<double> out, int k = 3,
+                             double power = 1.0) {
+        const int n = points(coords, "run_and_get_erosion");
+        expect(out, n, "run_and_get_erosion", "out");
+        check(::run_and_get_erosion(valid(), dt, coords.data(), n, out.data(), k, power),
+              "run_and_get_erosion");
+        erosion_points_ = std::size_t(n);
+    }
+
+    /** Run for dt; the net erosion (m) at coords is in the Model's erosion buffer. */
+    span<const double> run_and_get_erosion(double dt, span<const double> coords, int k = 3,
+                                           double power = 1.0) {
+        span<double> out = buffer(erosion_, coords.size() / 3);
+        run_and_get_erosion(dt, coords, out, k, power);
+        return out;
+    }
+
+    /** Erosion over dt from the last stored rate, without calling into Python. */
+    span<const double> extrapolate_erosion(double dt) {
+        if (erosion_points_ == 0)
+            throw Error("gospl: extrapolate_erosion needs an erosion call on this Model");
+        span<double> out = buffer(erosion_, erosion_points_);
+        if (::extrapolate_erosion(valid(), dt, out.data(), int(out.size())) < 0)
+            throw ModelError("extrapolate_erosion");
+        return out;
+    }
+
+    /** Declare the surface point set used by the sparse calls. */
+    void declare_surface_points(span<const double> coords, int k = 3, double power = 1.0) {
+        const int n = points(coords, "declare_surface_points");
+        check(::declare_surface_points(valid(), coords.data(), n, k, power),
+              "declare_surface_points");
+        reserve(std::size_t(n));
+    }
+
+    void set_surface_velocity_sparse(span<const int> indices, span<const double> vx,
+                                     span<const double> vy, span<const double> vz) {
+        const int n = size(indices.size(), "set_surface_velocity_sparse");
+        expect3(vx, vy, vz, n, "set_surface_velocity_sparse");
+        check(::set_surface_velocity_sparse(valid(), indices.data(), vx.data(), vy.data(),
+                                            vz.data(), n),
+              "set_surface_velocity_sparse");
+    }
+
+    void set_uplift_rate_sparse(span<const int> indices, span<const double> vz) {
+        const int n = size(indices.size(), "set_uplift_rate_sparse");
+        expect(vz, n, "set_uplift_rate_sparse", "vz");
+        check(::set_uplift_rate_sparse(valid(), indices.data(), vz.data(), n),
+              "set_uplift_rate_sparse");
+    }
+
+    /**
+     * Run for dt and return the points whose |erosion| exceeds threshold.
+     * The result buffers grow when more points pass than they can hold.
+     */
+    SparseErosion run_and_get_erosion_sparse(double dt, span<const double> coords,
+                                             double threshold, int k = 3, double power = 1.0) {
+        const int n = points(coords, "run_and_get_erosion_sparse");
+        const int capacity = int(std::min(sparse_values_.size(), std::size_t(INT_MAX)));
+        const int found = ::run_and_get_erosion_sparse(valid(), dt, coords.data(), n, threshold,
+                                                       sparse_indices_.data(),
+                                                       sparse_values_.data(), capacity, k, power);
+        if (found < 0) throw ModelError("run_and_get_erosion_sparse");
+        erosion_points_ = std::size_t(n);
+        if (found > capacity) {
+            grow(sparse_indices_, std::size_t(found));
+            grow(sparse_values_, std::size_t(found));
+            if (::get_sparse_erosion(handle_, sparse_indices_.data(), sparse_values_.data(),
+                                     found) != found)
+                throw ModelError("get_sparse_erosion");
+        }
+        return {span<const int>(sparse_indices_.data(), std::size_t(found)),
+                span<const double>(sparse_values_.data(), std::size_t(found))};
+    }
+
+private:
+    ModelHandle valid() const {
+        if (handle_ < 0) throw Error("gospl: use of an empty Model");
+        return handle_;
+    }
+
+    static void check(int status, const char* call) {
+        if (status != 0) throw ModelError(call);
+    }
+
+    static double value(double result, const char* call) {
+        if (result < 0.0) throw ModelError(call);
+        return result;
+    }
+
+    // For results that may legitimately be negative; the call returns NaN on error.
+    static double number(double result, const char* call) {
+        if (std::isnan(result)) throw ModelError(call);
+        return result;
+    }
+
+    static int count(int result, const char* call) {
+        if (result < 0) throw ModelError(call);
+        return result;
+    }
+
+    static int size(std::size_t n, const char* call) {
+        if (n > std::size_t(INT_MAX))
+            throw SizeError(std::string("gospl: ") + call + ": too many points");
+        return int(n);
+    }
+
+    static int points(span<const double> coords, const char* call) {
+        if (coords.size() % 3 != 0)
+            throw SizeError(std::string("gospl: ") + call + ": coords must hold (x, y, z) triples");
+        return size(coords.size() / 3, call);
+    }
+
+    template <class T>
+    static void expect(span<T> view, std::size_t n, const char* call, const char* name) {
+        if (view.size() != n)
+            throw SizeError(std::string("gospl: ") + call + ": " + name + " holds " +
+                            std::to_string(view.size()) + " values, expected " +
+                            std::to_string(n));
+    }
+
+    static void expect3(span<const double> vx, span<const double> vy, span<const double> vz,
+                        int n, const char* call) {
+        expect(vx, n, call, "vx");
+        expect(vy, n, call, "vy");
+        expect(vz, n, call, "vz");
+    }
+
+    template <class T>
+    static void grow(std::vector<T>& buf, std::size_t n) {
+        if (buf.size() < n) buf.resize(n);
+    }
+
+    template <class T>
+    static span<T> buffer(std::vector<T>& buf, std::size_t n) {
+        grow(buf, n);
+        return span<T>(buf.data(), n);
+    }
+
+    ModelHandle handle_ = -1;
+    std::size_t erosion_points_ = 0;  // query points of the last erosion call
+    std::vector<double> field_;
+    std::vector<double> erosion_;
+    std::vector<int> sparse_indices_;
+    std::vector<double> sparse_values_;
+};
+
+}  // namespace gospl
+
+#endif  // GOSPL_MODEL_HPP
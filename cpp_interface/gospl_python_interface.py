@@ -17,10 +17,10 @@ from ctypes import c_double, c_int, c_char_p, c_void_p, POINTER, Structure
 sys.path.insert(0, os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
 
 try:
-    from gospl_model_ext import EnhancedModel
+    from gospl_model_ext import EnhancedModel, gc_policy, log
     # Only import DataDrivenTectonics for apply_velocity_data method
     from gospl_tectonics_ext import DataDrivenTectonics
-    print("Successfully imported gospl extensions for C++ interface")
+    log.info("gospl_python_interface", "imported gospl extensions")
 except ImportError as e:
     print(f"Failed to import gospl extensions: {e}")
     sys.exit(1)
@@ -40,6 +40,26 @@ class VelocityData(Structure):
     ]
 
 
+def _lease_from_server(config_path: str):
+    """
+    Lease a warm model from the server named by GOSPL_MODEL_SERVER, if set.
+
+    Returns:
+        RemoteModel proxy, or None to create the model in-process
+    """
+    socket_path = os.environ.get("GOSPL_MODEL_SERVER")
+    if not socket_path:
+        return None
+    try:
+        from gospl_model_ext.model_server import lease
+        return lease(socket_path, os.path.abspath(config_path))
+    except Exception as e:
+        log.warn("create_enhanced_model",
+                 f"model server unavailable ({e}); creating model locally",
+                 socket=socket_path)
+        return None
+
+
 def create_enhanced_model(config_path: str) -> int:
     """
     Create an EnhancedModel instance and return a handle to it.
@@ -53,14 +73,20 @@ def create_enhanced_model(config_path: str) -> int:
     global _models, _next_handle
     
     try:
-        # Create enhanced model (now has interpolate_elevation_to_points built-in)
-        model = EnhancedModel(config_path.decode() if isinstance(config_path, bytes) else config_path)
-        
-        # Only bind apply_velocity_data from DataDrivenTectonics as it's tectonics-specific
-        # interpolate_elevation_to_points is now directly available on EnhancedModel
-        model.apply_velocity_data = DataDrivenTectonics.apply_velocity_data.__get__(
-            model, type(model)
-        )
+        config_path = config_path.decode() if isinstance(config_path, bytes) else config_path
+        model = _lease_from_server(config_path)
+        if model is None:
+            # Create enhanced model (now has interpolate_elevation_to_points built-in)
+            model = EnhancedModel(config_path)
+
+            # Only bind apply_velocity_data from DataDrivenTectonics as it's tectonics-specific
+            # interpolate_elevation_to_points is now directly available on EnhancedModel
+            model.apply_velocity_data = DataDrivenTectonics.apply_velocity_data.__get__(
+                model, type(model)
+            )
+
+            # Share read-only mesh data with other handles on the same mesh
+            model.share_mesh_data()
         
         # Store model and return handle
         handle = _next_handle
@@ -70,7 +96,7 @@ def create_enhanced_model(config_path: str) -> int:
         return handle
         
     except Exception as e:
-        print(f"Error creating enhanced model: {e}")
+        log.error("create_enhanced_model", e)
         return -1
 
 
@@ -90,6 +116,8 @@ def destroy_model(handle: int) -> int:
         if handle in _models:
             # Clean up model if needed
             model = _models[handle]
+            if isinstance(model, EnhancedModel):
+                model.release_shared_mesh()
             if hasattr(model, 'destroy'):
                 model.destroy()
             del _models[handle]
@@ -120,11 +148,12 @@ def run_processes_for_dt(handle: int, dt: float, verbose: bool = False, skip_tec
             return -1.0
             
         model = _models[handle]
+        model.cancel_speculation()
         elapsed = model.runProcessesForDt(dt, verbose, skip_tectonics)
         return elapsed
         
     except Exception as e:
-        print(f"Error in run_processes_for_dt: {e}")
+        log.error("run_processes_for_dt", e)
         return -1.0
 
 
@@ -149,11 +178,12 @@ def run_processes_for_steps(handle: int, num_steps: int, dt: float, verbose: boo
             return -1
             
         model = _models[handle]
+        model.cancel_speculation()
         elapsed_times = model.runProcessesForSteps(num_steps, dt, verbose, skip_tectonics)
         return len(elapsed_times)
         
     except Exception as e:
-        print(f"Error in run_processes_for_steps: {e}")
+        log.error("run_processes_for_steps", e)
         return -1
 
 
@@ -178,11 +208,12 @@ def run_processes_until_time(handle: int, target_time: float, dt: float, verbose
             return -1
             
         model = _models[handle]
+        model.cancel_speculation()
         elapsed_times = model.runProcessesUntilTime(target_time, dt, verbose, skip_tectonics)
         return len(elapsed_times)
         
     except Exception as e:
-        print(f"Error in run_processes_until_time: {e}")
+        log.error("run_processes_until_time", e)
         return -1
 
 
@@ -222,11 +253,12 @@ def apply_velocity_data(handle: int, coords, velocities,
         }
         
         # Apply velocity data
+        model.cancel_speculation()
         model.apply_velocity_data(veldata, timer=timer, k=k, power=power)
         return 0
         
     except Exception as e:
-        print(f"Error in apply_velocity_data: {e}")
+        log.error("apply_velocity_data", e)
         return -1
 
 
@@ -269,7 +301,7 @@ def apply_elevation_data(handle: int, coords, elevations,
         return 0
         
     except Exception as e:
-        print(f"Error in apply_elevation_data: {e}")
+        log.error("apply_elevation_data", e)
         return -1
 
 
@@ -281,19 +313,19 @@ def get_current_time(handle: int) -> float:
         handle: Model handle
         
     Returns:
-        Current time, or -1.0 on error
+        Current time (may be negative), or NaN on error
     """
     global _models
     
     try:
         if handle not in _models:
-            return -1.0
+            return float('nan')
             
         model = _models[handle]
-        return model.tNow
+        return model.get_committed_time()
         
     except Exception:
-        return -1.0
+        return float('nan')
 
 
 def get_time_step(handle: int) -> float:
@@ -352,7 +384,7 @@ def interpolate_elevation_to_points(handle: int, coords, k: int = 3, power: floa
         return elevations
         
     except Exception as e:
-        print(f"Error in interpolate_elevation_to_points: {e}")
+        log.error("interpolate_elevation_to_points", e)
         return None
 
 
@@ -389,7 +421,44 @@ def set_surface_velocity(handle: int, coords, vx_yr, vy_yr, vz_yr,
                                    k=k, power=power)
         return 0
     except Exception as e:
-        print(f"Error in set_surface_velocity: {e}")
+        log.error("set_surface_velocity", e)
+        return -1
+
+
+def accumulate_surface_velocity(handle: int, coords, vx_yr, vy_yr, vz_yr,
+                                num_points: int, dt_des: float,
+                                k: int = 3, power: float = 1.0) -> int:
+    """
+    Add a dt_des-weighted DES surface velocity sample to the model's mesh-side
+    accumulators. The next run_and_get_erosion() consumes the time average.
+
+    Args:
+        handle:     Model handle
+        coords:     Coordinates array (num_points * 3)
+        vx_yr:      X-velocity array (num_points,) in m/yr
+        vy_yr:      Y-velocity array (num_points,) in m/yr
+        vz_yr:      Z-velocity (uplift) array (num_points,) in m/yr
+        num_points: Number of DES surface nodes
+        dt_des:     Duration of the DES step in years
+        k:          IDW neighbours (default 3)
+        power:      IDW power exponent (default 1.0)
+
+    Returns:
+        0 on success, -1 on error
+    """
+    model = _models.get(handle)
+    if model is None:
+        return -1
+    try:
+        coords_array = np.asarray(coords).reshape(num_points, 3)
+        model.accumulate_surface_velocity(coords_array,
+                                          np.asarray(vx_yr).reshape(num_points),
+                                          np.asarray(vy_yr).reshape(num_points),
+                                          np.asarray(vz_yr).reshape(num_points),
+                                          dt_des, k=k, power=power)
+        return 0
+    except Exception as e:
+        log.error("accumulate_surface_velocity", e)
         return -1
 
 
@@ -419,7 +488,7 @@ def set_uplift_rate(handle: int, coords, vz_yr,
         model.set_uplift_rate(coords_array, vz_array, k=k, power=power)
         return 0
     except Exception as e:
-        print(f"Error in set_uplift_rate: {e}")
+        log.error("set_uplift_rate", e)
         return -1
 
 
@@ -446,10 +515,56 @@ def run_and_get_erosion(handle: int, dt: float, coords, num_points: int,
         coords_array = np.asarray(coords).reshape(num_points, 3)
         return model.run_and_get_erosion(dt, coords_array, k=k, power=power)
     except Exception as e:
-        print(f"Error in run_and_get_erosion: {e}")
+        log.error("run_and_get_erosion", e)
+        return None
+
+
+def run_and_get_erosion_sparse(handle: int, dt: float, coords, num_points: int,
+                               threshold: float, k: int = 3, power: float = 1.0):
+    """
+    Run GoSPL for dt years and return only the query points whose |erosion|
+    exceeds threshold.
+
+    Args:
+        handle:     Model handle
+        dt:         Coupling interval in years
+        coords:     Query coordinates (num_points * 3)
+        num_points: Number of query points
+        threshold:  |erosion| threshold in metres
+        k:          IDW neighbours (default 3)
+        power:      IDW power exponent (default 1.0)
+
+    Returns:
+        (indices, values) tuple of int32/float64 numpy arrays, or None on error
+    """
+    model = _models.get(handle)
+    if model is None:
+        return None
+    try:
+        coords_array = np.asarray(coords).reshape(num_points, 3)
+        return model.run_and_get_erosion_sparse(dt, coords_array, threshold,
+                                                k=k, power=power)
+    except Exception as e:
+        log.error("run_and_get_erosion_sparse", e)
         return None
 
 
+def get_sparse_erosion(handle: int):
+    """
+    Return the result of the last run_and_get_erosion_sparse() call again.
+
+    Args:
+        handle: Model handle
+
+    Returns:
+        (indices, values) tuple of numpy arrays, or None on error
+    """
+    model = _models.get(handle)
+    if model is None:
+        return None
+    return getattr(model, '_last_sparse_erosion', None)
+
+
 def apply_drift_correction(handle: int, coords, des_elev, num_points: int,
                            alpha: float = 0.1, k: int = 3, power: float = 1.0) -> int:
     """
@@ -476,10 +591,539 @@ def apply_drift_correction(handle: int, coords, des_elev, num_points: int,
         model.apply_drift_correction(coords_array, elev_array, alpha=alpha, k=k, power=power)
         return 0
     except Exception as e:
-        print(f"Error in apply_drift_correction: {e}")
+        log.error("apply_drift_correction", e)
+        return -1
+
+
+def set_transfer_tolerance(handle: int, tol: float) -> int:
+    """
+    Set the value-change tolerance for set_surface_velocity/set_uplift_rate.
+
+    Args:
+        handle: Model handle
+        tol:    Tolerance in field units (m/yr); 0.0 skips only exact repeats
+
+    Returns:
+        0 on success, -1 on error
+    """
+    model = _models.get(handle)
+    if model is None:
+        return -1
+    try:
+        model.set_transfer_tolerance(tol)
+        return 0
+    except Exception as e:
+        log.error("set_transfer_tolerance", e)
+        return -1
+
+
+def get_transfer_stats(handle: int):
+    """
+    Get value-change detection rates for DES -> mesh transfers.
+
+    Args:
+        handle: Model handle
+
+    Returns:
+        (skip_rate, partial_rate) tuple of floats, or None on error
+    """
+    model = _models.get(handle)
+    if model is None:
+        return None
+    try:
+        stats = model.get_transfer_stats()
+        return (float(stats['skip_rate']), float(stats['partial_rate']))
+    except Exception as e:
+        log.error("get_transfer_stats", e)
+        return None
+
+
+def declare_surface_points(handle: int, coords, num_points: int,
+                           k: int = 3, power: float = 1.0) -> int:
+    """
+    Declare the DES point set addressed by the sparse upload functions.
+
+    Args:
+        handle:     Model handle
+        coords:     Coordinates array (num_points * 3)
+        num_points: Number of DES surface nodes
+        k:          IDW neighbours (default 3)
+        power:      IDW power exponent (default 1.0)
+
+    Returns:
+        0 on success, -1 on error
+    """
+    model = _models.get(handle)
+    if model is None:
+        return -1
+    try:
+        coords_array = np.asarray(coords).reshape(num_points, 3)
+        model.declare_surface_points(coords_array, k=k, power=power)
+        return 0
+    except Exception as e:
+        log.error("declare_surface_points", e)
+        return -1
+
+
+def set_surface_velocity_sparse(handle: int, indices, vx_yr, vy_yr, vz_yr,
+                                num_changed: int) -> int:
+    """
+    Update the velocities of a subset of the declared DES points.
+
+    Args:
+        handle:      Model handle
+        indices:     Indices into the declared point set (num_changed,)
+        vx_yr:       X-velocity array (num_changed,) in m/yr
+        vy_yr:       Y-velocity array (num_changed,) in m/yr
+        vz_yr:       Z-velocity (uplift) array (num_changed,) in m/yr
+        num_changed: Number of changed points
+
+    Returns:
+        0 on success, -1 on error
+    """
+    model = _models.get(handle)
+    if model is None:
+        return -1
+    try:
+        model.set_surface_velocity_sparse(np.asarray(indices).reshape(num_changed),
+                                          np.asarray(vx_yr).reshape(num_changed),
+                                          np.asarray(vy_yr).reshape(num_changed),
+                                          np.asarray(vz_yr).reshape(num_changed))
+        return 0
+    except Exception as e:
+        log.error("set_surface_velocity_sparse", e)
+        return -1
+
+
+def set_uplift_rate_sparse(handle: int, indices, vz_yr, num_changed: int) -> int:
+    """
+    Update the vertical velocity of a subset of the declared DES points.
+
+    Args:
+        handle:      Model handle
+        indices:     Indices into the declared point set (num_changed,)
+        vz_yr:       Vertical velocity array (num_changed,) in m/yr
+        num_changed: Number of changed points
+
+    Returns:
+        0 on success, -1 on error
+    """
+    model = _models.get(handle)
+    if model is None:
+        return -1
+    try:
+        model.set_uplift_rate_sparse(np.asarray(indices).reshape(num_changed),
+                                     np.asarray(vz_yr).reshape(num_changed))
+        return 0
+    except Exception as e:
+        log.error("set_uplift_rate_sparse", e)
+        return -1
+
+
+def enable_speculation(handle: int, enabled: int, tolerance: float) -> int:
+    """
+    Enable or disable speculative execution of the next coupling interval.
+
+    Args:
+        handle:    Model handle
+        enabled:   Non-zero to enable, 0 to disable
+        tolerance: Velocity tolerance (m/yr) for committing a speculation
+
+    Returns:
+        0 on success, -1 on error
+    """
+    model = _models.get(handle)
+    if model is None:
+        return -1
+    try:
+        model.enable_speculation(bool(enabled), tolerance)
+        return 0
+    except Exception as e:
+        log.error("enable_speculation", e)
+        return -1
+
+
+def speculate_next_interval(handle: int, dt: float, k: int = 3, power: float = 1.0) -> int:
+    """
+    Run the next coupling interval ahead of time with the current velocities.
+
+    Args:
+        handle: Model handle
+        dt:     Coupling interval in years
+        k:      IDW neighbours (default 3)
+        power:  IDW power exponent (default 1.0)
+
+    Returns:
+        0 on success, -1 on error
+    """
+    model = _models.get(handle)
+    if model is None:
+        return -1
+    try:
+        model.speculate_next_interval(dt, k=k, power=power)
+        return 0
+    except Exception as e:
+        log.error("speculate_next_interval", e)
+        return -1
+
+
+def get_speculation_stats(handle: int):
+    """
+    Get the number of committed and rolled-back speculative intervals.
+
+    Args:
+        handle: Model handle
+
+    Returns:
+        (committed, rolled_back) tuple of ints, or None on error
+    """
+    model = _models.get(handle)
+    if model is None:
+        return None
+    try:
+        stats = model.get_speculation_stats()
+        return (int(stats['committed']), int(stats['rolled_back']))
+    except Exception as e:
+        log.error("get_speculation_stats", e)
+        return None
+
+
+def register_plate_ids(handle: int, coords, plate_ids, num_points: int) -> int:
+    """
+    Assign plate IDs to the mesh nodes from the nearest given point.
+
+    Args:
+        handle:     Model handle
+        coords:     Coordinates array (num_points * 3)
+        plate_ids:  Plate ID array (num_points,)
+        num_points: Number of points
+
+    Returns:
+        0 on success, -1 on error
+    """
+    model = _models.get(handle)
+    if model is None:
+        return -1
+    try:
+        model.register_plate_ids(np.asarray(coords).reshape(num_points, 3),
+                                 np.asarray(plate_ids).reshape(num_points))
+        return 0
+    except Exception as e:
+        log.error("register_plate_ids", e)
+        return -1
+
+
+def set_euler_poles(handle: int, omega, num_plates: int) -> int:
+    """
+    Set rigid plate motion from per-plate Euler rotation vectors.
+
+    Args:
+        handle:     Model handle
+        omega:      Rotation vectors in rad/yr (num_plates * 3)
+        num_plates: Number of plates
+
+    Returns:
+        0 on success, -1 on error
+    """
+    model = _models.get(handle)
+    if model is None:
+        return -1
+    try:
+        model.set_euler_poles(np.asarray(omega).reshape(num_plates, 3))
+        return 0
+    except Exception as e:
+        log.error("set_euler_poles", e)
+        return -1
+
+
+def register_forcing_callback(handle: int, kind: int, coords, num_points: int, pull) -> int:
+    """
+    Register a host forcing callback pulled during stepping.
+
+    Args:
+        handle:     Model handle
+        kind:       0 for (vx, vy, vz) velocity, 1 for vertical rate
+        coords:     Host point coordinates (num_points * 3)
+        num_points: Number of host points
+        pull:       Callable(time) returning the forcing at the host points,
+                    or None to unregister
+
+    Returns:
+        0 on success, -1 on error
+    """
+    model = _models.get(handle)
+    if model is None:
+        return -1
+    try:
+        coords_array = None if pull is None else np.asarray(coords).reshape(num_points, 3)
+        model.register_forcing(kind, coords_array, pull)
+        return 0
+    except Exception as e:
+        log.error("register_forcing_callback", e)
+        return -1
+
+
+def set_forcing_substeps(handle: int, num_substeps: int) -> int:
+    """
+    Set how many forcing pulls each coupling interval is split into.
+
+    Args:
+        handle:       Model handle
+        num_substeps: Number of substeps (>= 1)
+
+    Returns:
+        0 on success, -1 on error
+    """
+    model = _models.get(handle)
+    if model is None:
+        return -1
+    try:
+        model.set_forcing_substeps(num_substeps)
+        return 0
+    except Exception as e:
+        log.error("set_forcing_substeps", e)
+        return -1
+
+
+def set_locality_ordering(handle: int, enabled: int) -> int:
+    """
+    Enable or disable Morton ordering of large neighbour searches.
+
+    Args:
+        handle:  Model handle
+        enabled: Non-zero to enable, 0 to disable
+
+    Returns:
+        0 on success, -1 on error
+    """
+    model = _models.get(handle)
+    if model is None:
+        return -1
+    try:
+        model.set_locality_ordering(bool(enabled))
+        return 0
+    except Exception as e:
+        log.error("set_locality_ordering", e)
+        return -1
+
+
+def set_active_set(handle: int, threshold: float, area_threshold: float,
+                   buffer: int, full_sweep_every: int) -> int:
+    """
+    Configure active-set stepping.
+
+    Args:
+        handle:           Model handle
+        threshold:        Elevation change threshold in metres; <= 0 disables
+        area_threshold:   Relative drainage area change threshold
+        buffer:           Neighbour rings added to the active set
+        full_sweep_every: Maximum interval between full steps
+
+    Returns:
+        0 on success, -1 on error
+    """
+    model = _models.get(handle)
+    if model is None:
+        return -1
+    try:
+        if threshold <= 0.0:
+            model.set_active_set(None)
+        else:
+            model.set_active_set(threshold, area_threshold, buffer, full_sweep_every)
+        return 0
+    except Exception as e:
+        log.error("set_active_set", e)
+        return -1
+
+
+def get_active_set_stats(handle: int):
+    """
+    Get active-set stepping counters.
+
+    Args:
+        handle: Model handle
+
+    Returns:
+        (steps, skipped, active_fraction) tuple, or None on error
+    """
+    model = _models.get(handle)
+    if model is None:
+        return None
+    try:
+        stats = model.get_active_set_stats()
+        return (int(stats['steps']), int(stats['skipped']), float(stats['active_fraction']))
+    except Exception as e:
+        log.error("get_active_set_stats", e)
+        return None
+
+
+def set_catchment_parallel(handle: int, enabled: int, num_threads: int,
+                           giant_fraction: float) -> int:
+    """
+    Configure catchment-parallel flow accumulation.
+
+    Args:
+        handle:         Model handle
+        enabled:        Non-zero to enable, 0 to disable
+        num_threads:    Worker threads; <= 0 uses all cores
+        giant_fraction: Largest-basin node fraction above which the global
+                        solve is used
+
+    Returns:
+        0 on success, -1 on error
+    """
+    model = _models.get(handle)
+    if model is None:
+        return -1
+    try:
+        model.set_catchment_parallel(bool(enabled),
+                                     num_threads if num_threads > 0 else None,
+                                     giant_fraction)
+        return 0
+    except Exception as e:
+        log.error("set_catchment_parallel", e)
+        return -1
+
+
+def get_catchment_stats(handle: int):
+    """
+    Get catchment-parallel flow accumulation counters.
+
+    Args:
+        handle: Model handle
+
+    Returns:
+        (solves, fallbacks, basins) tuple of ints, or None on error
+    """
+    model = _models.get(handle)
+    if model is None:
+        return None
+    try:
+        stats = model.get_catchment_stats()
+        return (int(stats['solves']), int(stats['fallbacks']), int(stats['basins']))
+    except Exception as e:
+        log.error("get_catchment_stats", e)
+        return None
+
+
+def set_incremental_depressions(handle: int, enabled: int, tolerance: float) -> int:
+    """
+    Configure incremental depression filling.
+
+    Args:
+        handle:    Model handle
+        enabled:   Non-zero to enable, 0 to disable
+        tolerance: Elevation change (m) below which a node counts as unchanged
+
+    Returns:
+        0 on success, -1 on error
+    """
+    model = _models.get(handle)
+    if model is None:
+        return -1
+    try:
+        model.set_incremental_depressions(bool(enabled), tolerance)
+        return 0
+    except Exception as e:
+        log.error("set_incremental_depressions", e)
+        return -1
+
+
+def get_depression_stats(handle: int):
+    """
+    Update the depression state and get its counters.
+
+    Args:
+        handle: Model handle
+
+    Returns:
+        (depressions, recomputed, full_floods) tuple of ints, or None on error
+        or when disabled
+    """
+    model = _models.get(handle)
+    if model is None:
+        return None
+    try:
+        stats = model.get_depression_stats()
+        if stats is None:
+            return None
+        return (int(stats['depressions']), int(stats['recomputed']), int(stats['full']))
+    except Exception as e:
+        log.error("get_depression_stats", e)
+        return None
+
+
+def get_output_stats(handle: int):
+    """
+    Get counters of goSPL's own output (visModel).
+
+    Args:
+        handle: Model handle
+
+    Returns:
+        (writes, seconds) tuple, or None on error
+    """
+    model = _models.get(handle)
+    if model is None:
+        return None
+    try:
+        stats = model.get_output_stats()
+        return (int(stats['writes']), float(stats['seconds']))
+    except Exception as e:
+        log.error("get_output_stats", e)
+        return None
+
+
+def set_gc_policy(mode: int) -> int:
+    """
+    Set the garbage collector policy for stepping and transfer calls.
+
+    Args:
+        mode: 0 = interpreter default, 1 = disabled, 2 = frozen
+
+    Returns:
+        0 on success, -1 on error
+    """
+    try:
+        if not 0 <= mode < len(gc_policy.MODES):
+            raise ValueError(f"unknown GC mode {mode}")
+        gc_policy.set_mode(gc_policy.MODES[mode])
+        return 0
+    except Exception as e:
+        log.error("set_gc_policy", e)
         return -1
 
 
+def collect_garbage() -> int:
+    """
+    Run a full garbage collection.
+
+    Returns:
+        Number of unreachable objects found, or -1 on error
+    """
+    try:
+        return int(gc_policy.collect())
+    except Exception as e:
+        log.error("collect_garbage", e)
+        return -1
+
+
+def get_gc_stats():
+    """
+    Get garbage collector pause statistics.
+
+    Returns:
+        (collections, in_step, total_pause, max_pause) tuple, or None on error
+    """
+    try:
+        stats = gc_policy.stats()
+        return (int(stats['collections']), int(stats['in_step']),
+                float(stats['total_pause']), float(stats['max_pause']))
+    except Exception as e:
+        log.error("get_gc_stats", e)
+        return None
+
+
 # C-compatible function exports using ctypes
 def export_c_functions():
     """Export functions with C-compatible signatures"""
@@ -1,12 +1,28 @@
 #include "gospl_extensions.h"
+#include "gospl_model.hpp"
+#include <Python.h>
+#include <atomic>
+#include <chrono>
+#include <fstream>
 #include <iostream>
+#include <string>
+#include <thread>
 #include <vector>
+#include <cstdlib>
+#include <cstdio>
+#include <cmath>
+#include <sys/wait.h>
+#include <unistd.h>
 
 /**
  * Simple test program for the gospl_extensions C++ interface.
  * This tests basic functionality without requiring a full goSPL configuration.
  */
 
+static void host_free(void* ptr, size_t, void*) {
+    std::free(ptr);
+}
+
 int main() {
     std::cout << "Testing gospl_extensions C++ interface" << std::endl;
     std::cout << std::string(40, '=') << std::endl;
@@ -67,9 +83,156 @@ int main() {
     } else {
         std::cout << "⚠️  Model creation failed (expected without valid config)" << std::endl;
     }
+
+    // Model time can be negative, so an unknown handle must read as NaN
+    if (std::isnan(get_current_time(12345))) {
+        std::cout << "✅ Unknown handle time reported as NaN" << std::endl;
+    } else {
+        std::cerr << "❌ Unknown handle time not reported as NaN" << std::endl;
+    }
     
-    // Test 4: Cleanup
-    std::cout << "\n4. Testing cleanup..." << std::endl;
+    // Test 4: Erosion extrapolation needs a prior run_and_get_erosion() call
+    std::cout << "\n4. Testing erosion extrapolation without a stored rate..." << std::endl;
+    std::vector<double> extrapolated(num_points);
+    if (extrapolate_erosion(12345, 1000.0, extrapolated.data(), num_points) == -1) {
+        std::cout << "✅ Unknown handle rejected" << std::endl;
+    } else {
+        std::cerr << "❌ Extrapolation succeeded without a stored rate" << std::endl;
+    }
+    
+    // Test 5: Query coalescing settings are validated
+    std::cout << "\n5. Testing query coalescing configuration..." << std::endl;
+    if (configure_query_coalescing(-1, 1024) == -1 && configure_query_coalescing(200, 0) == -1 &&
+        configure_query_coalescing(0, 4096) == 0) {
+        std::cout << "✅ Coalescing configuration validated" << std::endl;
+    } else {
+        std::cerr << "❌ Invalid coalescing configuration accepted" << std::endl;
+    }
+    
+    // Test 6: numpy allocator settings are validated and fixed once installed
+    std::cout << "\n6. Testing numpy allocator configuration..." << std::endl;
+    long long allocations = -1;
+    if (gospl_numpy_allocator_configure(1 << 26, 0, nullptr, host_free, nullptr) == -1 &&
+        gospl_numpy_allocator_configure(1 << 26, 0, nullptr, nullptr, nullptr) == 0 &&
+        gospl_numpy_allocator_enable(1) == 0 &&
+        gospl_numpy_allocator_configure(1 << 27, 0, nullptr, nullptr, nullptr) == -1 &&
+        gospl_numpy_allocator_get_stats(&allocations, nullptr, nullptr, nullptr, nullptr,
+                                        nullptr) == 0 && allocations >= 0 &&
+        gospl_numpy_allocator_enable(0) == 0) {
+        std::cout << "✅ Allocator configuration validated" << std::endl;
+    } else {
+        std::cerr << "❌ Unexpected numpy allocator behaviour" << std::endl;
+    }
+    
+    // Test 7: The C++ façade reports failures as typed exceptions
+    std::cout << "\n7. Testing gospl::Model errors..." << std::endl;
+    {
+        gospl::Model empty;
+        std::vector<double> bad_coords(4), out(1);
+        bool size_error = false, empty_error = false, model_error = false;
+        try {
+            empty.interpolate_elevation(bad_coords, out);
+        } catch (const gospl::SizeError&) {
+            size_error = true;
+        }
+        try {
+            empty.interpolate_elevation(gospl::span<const double>(bad_coords.data(), 3), out);
+        } catch (const gospl::ModelError&) {
+        } catch (const gospl::Error&) {
+            empty_error = true;
+        }
+        try {
+            gospl::Model model("nonexistent_config.yml");
+            gospl::Model moved = std::move(model);
+            model_error = !model && moved;
+        } catch (const gospl::ModelError& e) {
+            model_error = e.call() == "create_enhanced_model";
+        }
+        if (size_error && empty_error && model_error) {
+            std::cout << "✅ Size, empty-model and creation errors reported" << std::endl;
+        } else {
+            std::cerr << "❌ Unexpected gospl::Model error handling" << std::endl;
+        }
+    }
+    
+    // Test 8: The sampling profiler starts once and writes its stacks on stop
+    std::cout << "\n8. Testing sampling profiler..." << std::endl;
+    {
+        const char* profile = "test_interface_profile.folded";
+        long long samples = -1, stacks = -1;
+        bool started = gospl_profiler_start(0.0, profile) == -1 &&
+                       gospl_profiler_start(1000.0, profile) == 0 &&
+                       gospl_profiler_start(1000.0, profile) == -1;
+        int written = gospl_profiler_stop();
+        FILE* f = std::fopen(profile, "r");
+        if (f) std::fclose(f);
+        std::remove(profile);
+        if (started && written >= 0 && f && gospl_profiler_stop() == -1 &&
+            gospl_profiler_get_stats(&samples, &stacks, nullptr) == 0 && stacks == written) {
+            std::cout << "✅ Profiler wrote " << written << " stacks from " << samples
+                      << " samples" << std::endl;
+        } else {
+            std::cerr << "❌ Unexpected sampling profiler behaviour" << std::endl;
+        }
+
+        // Python work on two native threads, whose thread states come and go
+        // with every call, is sampled under the calling entry point. A short
+        // switch interval makes the workers yield the GIL inside their calls.
+        auto set_switch_interval = [](const char* seconds) {
+            PyGILState_STATE gil = PyGILState_Ensure();
+            PyRun_SimpleString((std::string("import sys; sys.setswitchinterval(") + seconds + ")").c_str());
+            PyGILState_Release(gil);
+        };
+        set_switch_interval("1e-6");
+        const std::string expected = "get_current_time;get_current_time (gospl_python_interface.py:";
+        bool found = false;
+        for (int attempt = 0; attempt < 5 && !found; ++attempt) {
+            std::atomic<bool> stop{false};
+            bool ok = gospl_profiler_start(2000.0, profile) == 0;
+            std::vector<std::thread> workers;
+            for (int t = 0; t < 2; ++t)
+                workers.emplace_back([&stop] {
+                    while (!stop.load()) get_current_time(12345);
+                });
+            std::this_thread::sleep_for(std::chrono::milliseconds(200));
+            stop = true;
+            for (std::thread& w : workers) w.join();
+            ok = gospl_profiler_stop() > 0 && ok;
+            std::ifstream in(profile);
+            for (std::string line; ok && std::getline(in, line);)
+                if (line.compare(0, expected.size(), expected) == 0) found = true;
+            in.close();
+            std::remove(profile);
+        }
+        set_switch_interval("0.005");
+        if (found) {
+            std::cout << "✅ Profiler sampled Python frames of native threads" << std::endl;
+        } else {
+            std::cerr << "❌ No \"" << expected << "\" stack in the profile" << std::endl;
+        }
+    }
+    
+    // Test 9: Forked children can still call into the interpreter
+    std::cout << "\n9. Testing fork..." << std::endl;
+    {
+        bool refused = gospl_profiler_start(100.0, "test_interface_fork.folded") == 0 &&
+                       gospl_fork() == -1;
+        gospl_profiler_stop();
+        std::remove("test_interface_fork.folded");
+        pid_t pid = gospl_fork();
+        if (pid == 0) _exit(std::isnan(get_current_time(12345)) ? 0 : 1);
+        int status = -1;
+        if (pid > 0) waitpid(pid, &status, 0);
+        if (refused && pid > 0 && WIFEXITED(status) && WEXITSTATUS(status) == 0 &&
+            std::isnan(get_current_time(12345))) {
+            std::cout << "✅ Forked child used the interpreter" << std::endl;
+        } else {
+            std::cerr << "❌ Unexpected fork behaviour" << std::endl;
+        }
+    }
+
+    // Test 10: Cleanup
+    std::cout << "\n10. Testing cleanup..." << std::endl;
     finalize_gospl_extensions();
     std::cout << "✅ Cleanup completed" << std::endl;
     
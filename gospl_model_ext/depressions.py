@@ -0,0 +1,218 @@
+"""
+Depression filling kept up to date across steps.
+
+A priority flood from the outlet nodes gives the filled (depression-free)
+surface: every node is raised to the lowest level at which water can leave it
+towards an outlet. Nodes raised above their elevation form depressions, each
+with a spill level. Between short steps most depressions are unchanged, so
+update() only refloods the nodes whose elevation changed and the depressions
+around them (new pits are changed nodes themselves). The region grows while its new levels leave
+the surroundings stale: nodes flooded through it that now sit below its
+level, or neighbours it now offers a lower way out. A full flood is the last
+resort.
+"""
+
+import heapq
+
+import numpy as np
+
+# Region refloods per update before falling back to a full flood.
+_MAX_PASSES = 8
+
+
+class DepressionFiller:
+    """
+    Filled surface and depressions of a mesh.
+
+    :param neighbours: (N, D) neighbour indices, negative for padding
+    :param elevation:  (N,) node elevations
+    :param outlets:    (N,) bool mask of nodes that drain out of the mesh
+    :param tolerance:  elevation change below which a node counts as unchanged
+
+    After each update, ``touched`` marks the nodes that were reflooded.
+    """
+
+    def __init__(self, neighbours, elevation, outlets, tolerance=1.0e-6):
+        self.neighbours = np.asarray(neighbours, dtype=np.int64)
+        self.tolerance = float(tolerance)
+        self.stats = {'updates': 0, 'recomputed': 0, 'full': 0, 'last_recomputed': 0}
+        self._rebuild(np.array(elevation, dtype=np.float64), np.asarray(outlets, dtype=bool))
+
+    # -- full flood -----------------------------------------------------------
+
+    def _rebuild(self, elevation, outlets):
+        self.elevation = elevation
+        self._given_outlets = outlets.copy()
+        self.outlets = outlets.copy()
+        self.filled = elevation.copy()
+        n = elevation.shape[0]
+        self.parent = np.full(n, -1, dtype=np.int64)
+        self.touched = np.ones(n, dtype=bool)
+        region = np.ones(n, dtype=bool)
+        seeds = np.nonzero(outlets)[0]
+        if seeds.size == 0:
+            # A closed mesh drains through its lowest node.
+            seeds = np.array([int(np.argmin(elevation))])
+            self.outlets[seeds] = True
+        self._flood(region, seeds)
+        self.label = np.full(n, -1, dtype=np.int64)
+        self._next_label = 0
+        self._label_depressions(np.arange(n))
+        self.stats['full'] += 1
+
+    def _flood(self, region, seeds):
+        """Priority flood of *region* from *seeds*, whose filled values are kept.
+        Each reached node records the neighbour it was flooded from."""
+        done = ~region
+        done[seeds] = True
+        heap = [(self.filled[s], int(s)) for s in seeds]
+        heapq.heapify(heap)
+        ngb = self.neighbours
+        z = self.elevation
+        while heap:
+            level, i = heapq.heappop(heap)
+            for j in ngb[i]:
+                if j < 0 or done[j]:
+                    continue
+                done[j] = True
+                self.parent[j] = i
+                self.filled[j] = z[j] if z[j] > level else level
+                heapq.heappush(heap, (self.filled[j], int(j)))
+        # Nodes the flood cannot reach keep their elevation.
+        unreached = region & ~done
+        self.filled[unreached] = z[unreached]
+        self.parent[unreached] = -1
+
+    def _label_depressions(self, nodes):
+        """Give new depression IDs to the flooded nodes among *nodes*, together
+        with any flooded node outside them that belongs to the same lake."""
+        flooded = self.filled > self.elevation
+        self.label[nodes] = -1
+        seen = np.zeros(flooded.shape[0], dtype=bool)
+        for start in nodes[flooded[nodes]]:
+            if seen[start]:
+                continue
+            level = self.filled[start]
+            stack = [start]
+            seen[start] = True
+            while stack:
+                i = stack.pop()
+                self.label[i] = self._next_label
+                for j in self.neighbours[i]:
+                    if (j >= 0 and not seen[j] and flooded[j]
+                            and self.filled[j] == level):
+                        seen[j] = True
+                        stack.append(j)
+            self._next_label += 1
+
+    # -- incremental update -------------------------------------------------
+
+    @property
+    def count(self):
+        """Number of depressions."""
+        labels = self.label[self.label >= 0]
+        return int(np.unique(labels).size)
+
+    def _ring(self, region):
+        ngb = self.neighbours[region]
+        ring = np.zeros(region.shape[0], dtype=bool)
+        ring[ngb[ngb >= 0]] = True
+        return ring & ~region
+
+    def update(self, elevation, outlets=None):
+        """
+        Bring the filled surface up to date with new elevations.
+
+        :param elevation: (N,) new node elevations
+        :param outlets:   optional new outlet mask; a change forces a full flood
+        :return: number of depressions recomputed
+        """
+        elevation = np.asarray(elevation, dtype=np.float64)
+        self.stats['updates'] += 1
+        if outlets is not None and not np.array_equal(np.asarray(outlets, dtype=bool),
+                                                      self._given_outlets):
+            before = self.count
+            self._rebuild(elevation.copy(), np.asarray(outlets, dtype=bool))
+            return self._record(max(before, self.count))
+
+        changed = np.abs(elevation - self.elevation) > self.tolerance
+        self.elevation = elevation.copy()
+        self.touched = changed
+        # Nodes outside depressions keep filled == elevation.
+        dry = self.label < 0
+        self.filled[dry] = elevation[dry]
+        np.maximum(self.filled, elevation, out=self.filled)
+        if not changed.any():
+            return self._record(0)
+
+        before = self.filled.copy()
+        region = self._close(changed)
+        for _ in range(_MAX_PASSES):
+            inner = region & self.outlets
+            seeds = np.nonzero(self._ring(region) | inner)[0]
+            self.filled[region] = np.inf
+            self.filled[inner] = elevation[inner]
+            self._flood(region, seeds)
+            grow = self._dependents(region) | self._lowered(region, before)
+            if not grow.any():
+                self.touched = region
+                gone = np.unique(self.label[region & (self.label >= 0)])
+                self._label_depressions(np.nonzero(region)[0])
+                new = np.unique(self.label[region & (self.label >= 0)])
+                return self._record(int(max(gone.size, new.size)))
+            region = self._close(region | grow)
+
+        count = self.count
+        self._rebuild(elevation.copy(), self._given_outlets)
+        return self._record(max(count, self.count))
+
+    def _close(self, region):
+        """Add every depression inside or next to *region*."""
+        near = region | self._ring(region)
+        ids = np.unique(self.label[near & (self.label >= 0)])
+        return region | np.isin(self.label, ids)
+
+    def _dependents(self, region):
+        """
+        Nodes outside *region* that an earlier flood reached through it and
+        that do not lie above the new level of the region node they hang
+        from. Their levels may have depended on the old region; nodes above
+        the new level keep filled == elevation, and so does everything
+        flooded through them. A node exactly at the level may be the stale
+        seed the level itself came from.
+        """
+        n = region.shape[0]
+        child = np.nonzero(self.parent >= 0)[0]
+        child = child[np.argsort(self.parent[child], kind='stable')]
+        first = np.searchsorted(self.parent[child], np.arange(n + 1))
+
+        out = np.zeros(n, dtype=bool)
+        frontier = np.nonzero(region)[0]
+        bound = self.filled[frontier]
+        while frontier.size:
+            counts = first[frontier + 1] - first[frontier]
+            offset = np.arange(counts.sum()) - np.repeat(np.cumsum(counts) - counts, counts)
+            kids = child[np.repeat(first[frontier], counts) + offset]
+            bound = np.repeat(bound, counts)
+            keep = ~region[kids] & ~out[kids] & (self.elevation[kids] <= bound)
+            frontier, bound = kids[keep], bound[keep]
+            out[frontier] = True
+        return out
+
+    def _lowered(self, region, before):
+        """Ring nodes that can now drain through the region below their level."""
+        ring = np.nonzero(self._ring(region) & ~self.outlets)[0]
+        out = np.zeros(region.shape[0], dtype=bool)
+        if ring.size == 0:
+            return out
+        ngb = self.neighbours[ring]
+        valid = ngb >= 0
+        lowest = np.where(valid, self.filled[np.where(valid, ngb, 0)], np.inf).min(axis=1)
+        expected = np.maximum(self.elevation[ring], lowest)
+        out[ring[expected < before[ring]]] = True
+        return out
+
+    def _record(self, recomputed):
+        self.stats['recomputed'] += recomputed
+        self.stats['last_recomputed'] = recomputed
+        return recomputed
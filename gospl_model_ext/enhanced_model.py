@@ -1,9 +1,15 @@
+import copy
+import os
+import weakref
 import numpy as np
-from time import process_time
+from time import perf_counter, process_time
 
 # Import from gospl package
 from gospl.model import Model
 
+from . import log
+from .gc_policy import paused
+
 # Additional imports for extended functionality
 try:
     from gospl.mesher.tectonics import Tectonics as _Tectonics
@@ -16,12 +22,20 @@ except ImportError:
     GOSPL_AVAILABLE = False
 
 
+class _SpeculativeOutput(Exception):
+    """Raised when goSPL would write output during a speculative interval."""
+
+
 class EnhancedModel(Model):
     """
     Extends Model with a method to run processes for a specific time step dt,
     similar to how DataDrivenTectonics extends Tectonics.
     """
 
+    # Above this fraction of touched mesh nodes a full DES -> mesh transfer is
+    # cheaper than a partial update.
+    _PARTIAL_TRANSFER_FRACTION = 0.5
+
     def run_one_step(self, dt):
         """
         Run goSPL processes for one time step of duration dt.
@@ -129,6 +143,7 @@ class EnhancedModel(Model):
             if dt_was_modified:
                 self.dt = original_dt
 
+    @paused
     def runProcessesForDt(self, dt=None, verbose=False, skip_tectonics=False):
         """
         Run goSPL processes for a specific time step dt instead of the full simulation.
@@ -149,9 +164,8 @@ class EnhancedModel(Model):
             dt = self.dt
             
         if verbose:
-            print(f"Running processes for dt={dt} from t={self.tNow}")
-            if skip_tectonics:
-                print("  (skipping tectonics operations)")
+            log.info('runProcessesForDt', 'step start', dt=dt, t=self.tNow,
+                     skip_tectonics=skip_tectonics)
         
         # Store originals to restore after the coupling interval
         original_dt   = self.dt
@@ -172,11 +186,17 @@ class EnhancedModel(Model):
                     # Replace with a no-op function
                     setattr(self, method_name, lambda *args, **kwargs: None)
 
+        # With active-set stepping, quiescent steps run in goSPL's fast mode
+        quiescent = self._active_set_begin()
+        original_fast = getattr(self, 'fast', False)
+
         try:
             # Use the coupling interval as GoSPL's timestep so runProcesses()
             # takes exactly one step of length dt (one GoSPL step per coupling event).
             self.dt   = dt
             self.tEnd = self.tNow + dt
+            if quiescent:
+                self.fast = True
 
             # Record start time
             tstep = process_time()
@@ -185,9 +205,11 @@ class EnhancedModel(Model):
 
             # Calculate elapsed time
             elapsed_time = process_time() - tstep
+            self._active_set_end(quiescent)
 
             if verbose:
-                print(f"  Completed step in {elapsed_time:.3f} seconds, new t={self.tNow}")
+                log.info('runProcessesForDt', 'step done', elapsed=elapsed_time,
+                         t=self.tNow, quiescent=quiescent)
 
             return elapsed_time
 
@@ -195,6 +217,8 @@ class EnhancedModel(Model):
             # Restore dt and tEnd; tNow is intentionally left advanced
             self.dt   = original_dt
             self.tEnd = original_tEnd
+            if quiescent:
+                self.fast = original_fast
 
             # Restore tectonics methods if they were disabled
             if skip_tectonics:
@@ -221,9 +245,8 @@ class EnhancedModel(Model):
         elapsed_times = []
         
         if verbose:
-            print(f"Running {num_steps} steps with dt={dt}")
-            if skip_tectonics:
-                print("  (skipping tectonics operations)")
+            log.info('runProcessesForSteps', 'run start', steps=num_steps, dt=dt,
+                     skip_tectonics=skip_tectonics)
         
         for step in range(num_steps):
             step_start_time = self.tNow
@@ -231,7 +254,8 @@ class EnhancedModel(Model):
             elapsed_times.append(elapsed)
             
             if verbose:
-                print(f"Step {step+1}/{num_steps}: t={step_start_time:.1f} -> {self.tNow:.1f}")
+                log.info('runProcessesForSteps', 'step', step=step + 1, steps=num_steps,
+                         t_start=step_start_time, t=self.tNow)
         
         return elapsed_times
 
@@ -254,16 +278,16 @@ class EnhancedModel(Model):
         
         if target_time <= self.tNow:
             if verbose:
-                print(f"Target time {target_time} is not greater than current time {self.tNow}")
+                log.info('runProcessesUntilTime', 'target already reached',
+                         target=target_time, t=self.tNow)
             return []
         
         elapsed_times = []
         step = 0
         
         if verbose:
-            print(f"Running from t={self.tNow} to t={target_time} with dt={dt}")
-            if skip_tectonics:
-                print("  (skipping tectonics operations)")
+            log.info('runProcessesUntilTime', 'run start', t=self.tNow, target=target_time,
+                     dt=dt, skip_tectonics=skip_tectonics)
         
         while self.tNow < target_time:
             # Adjust dt for final step if necessary
@@ -276,10 +300,12 @@ class EnhancedModel(Model):
             
             step += 1
             if verbose:
-                print(f"Step {step}: t={step_start_time:.1f} -> {self.tNow:.1f}")
+                log.info('runProcessesUntilTime', 'step', step=step,
+                         t_start=step_start_time, t=self.tNow)
         
         return elapsed_times
 
+    @paused
     def interpolate_elevation_to_points(self, src_pts, k=3, power=1.0):
         """
         Interpolate model elevation field to external points using inverse distance weighting.
@@ -307,14 +333,14 @@ class EnhancedModel(Model):
             raise ValueError("src_pts contains no points")
         
         # Get global elevation values as numpy array
-        h_values = self.hGlobal.getArray()
+        h_values = self._committed_elevation()
         
         # Limit k to available mesh nodes
         k = max(1, min(int(k), self.mCoords.shape[0]))
         
-        # Build KDTree from mesh coordinates for efficient nearest neighbor search
-        tree = spatial.cKDTree(self.mCoords, leafsize=10)
-        distances, idx = tree.query(src_pts, k=k)
+        # Reuse the cached KD-tree of mesh coordinates
+        tree = self._get_mesh_tree()
+        distances, idx = self._knn(tree, src_pts, k)
         
         # Handle single neighbor case
         if k == 1:
@@ -340,6 +366,7 @@ class EnhancedModel(Model):
         
         return h_interp
 
+    @paused
     def apply_elevation_data(self, elevdata, k=3, power=1.0):
         """
         Apply external elevation data to the model's global elevation field.
@@ -365,6 +392,7 @@ class EnhancedModel(Model):
         :param k: number of nearest neighbors for IDW interpolation (default: 3)
         :param power: inverse distance power exponent (default: 1.0)
         """
+        self.cancel_speculation()
         # Import scipy.spatial here to avoid requiring it at module level
         try:
             from scipy import spatial
@@ -398,8 +426,8 @@ class EnhancedModel(Model):
         k = max(1, min(int(k), nsrc))
 
         # Interpolate elevation data to ALL mesh nodes (global arrays)
-        tree = spatial.cKDTree(src_pts, leafsize=10)
-        distances, idx = tree.query(self.mCoords, k=k)
+        tree = self._spatial_index(src_pts)
+        distances, idx = self._knn(tree, self.mCoords, k, mesh_order=True)
 
         if k == 1:
             distances = distances[:, None]
@@ -435,6 +463,7 @@ class EnhancedModel(Model):
 
         return
 
+    @paused
     def get_elevation_at_points(self, src_pts, k=3, power=1.0):
         """
         Convenience method that combines getting current elevations and interpolating them.
@@ -453,13 +482,374 @@ class EnhancedModel(Model):
     # Redesigned coupling API (v2)
     # ------------------------------------------------------------------
 
+    # Point sets smaller than this keep a cKDTree on global meshes too.
+    _SPHERE_INDEX_MIN_POINTS = 4096
+
+    def _use_sphere_index(self, npoints):
+        """True if a global-mesh search over *npoints* points should use the
+        cube-sphere index (requires its native kernel, see sphere_index)."""
+        from . import sphere_index
+        return (not getattr(self, 'flatModel', True)
+                and npoints >= self._SPHERE_INDEX_MIN_POINTS
+                and sphere_index.available())
+
+    def _spatial_index(self, points):
+        """Return a k-nearest index over *points* for a DES <-> mesh transfer."""
+        if self._use_sphere_index(points.shape[0]):
+            from .sphere_index import CubeSphereIndex
+            return CubeSphereIndex(points)
+        from scipy.spatial import cKDTree
+        return cKDTree(points, leafsize=10)
+
     def _get_mesh_tree(self):
-        """Return a cached cKDTree of GoSPL mesh coordinates (built once)."""
+        """Return the cached neighbour index of GoSPL mesh coordinates (built once)."""
         if not hasattr(self, '_mesh_kdtree') or self._mesh_kdtree is None:
-            from scipy.spatial import cKDTree
-            self._mesh_kdtree = cKDTree(self.mCoords, leafsize=10)
+            spherical = self._use_sphere_index(self.mCoords.shape[0])
+            if getattr(self, '_mesh_fp', None) is not None:
+                from . import mesh_store
+                self._mesh_kdtree = mesh_store.get_tree(self._mesh_fp, spherical=spherical)
+            else:
+                from .mesh_cache import cached_tree
+                self._mesh_kdtree = cached_tree(self.mCoords, spherical=spherical)
         return self._mesh_kdtree
 
+    def share_mesh_data(self):
+        """
+        Replace mCoords and the mesh KD-tree with process-wide shared copies.
+
+        Models on the same mesh then hold one read-only coordinate array and
+        one KD-tree between them (see mesh_store). The reference is dropped by
+        release_shared_mesh() or when the model is garbage collected.
+        """
+        if getattr(self, '_mesh_fp', None) is not None:
+            return
+        from . import mesh_store
+        fp, coords = mesh_store.acquire(self.mCoords)
+        self.mCoords = coords
+        self._mesh_fp = fp
+        self._mesh_kdtree = None
+        self._mesh_release = weakref.finalize(self, mesh_store.release, fp)
+
+    def release_shared_mesh(self):
+        """Drop this model's reference to the shared mesh data, if any."""
+        release = getattr(self, '_mesh_release', None)
+        if release is not None:
+            release()
+
+    # Query sets smaller than this are searched in their given order.
+    _LOCALITY_MIN_POINTS = 4096
+
+    def set_locality_ordering(self, enabled=True):
+        """
+        Process large neighbour searches in Morton (Z-curve) order.
+
+        Query points are sorted along a space-filling curve before the KD-tree
+        search and results are scattered back, so the search and the
+        following gathers touch memory in spatially coherent order. Inputs and
+        outputs keep their caller ordering.
+
+        :param enabled: True to enable, False to search in input order
+        """
+        self.locality_ordering = bool(enabled)
+
+    def _mesh_node_order(self):
+        """Return the (cached) Morton order of the mesh nodes."""
+        order = getattr(self, '_mesh_order', None)
+        if order is None or order.shape[0] != self.mCoords.shape[0]:
+            from .ordering import morton_order
+            order = morton_order(self.mCoords)
+            self._mesh_order = order
+        return order
+
+    def _knn(self, tree, pts, k, mesh_order=False):
+        """
+        tree.query(pts, k) with optional locality ordering of the queries.
+
+        :param mesh_order: *pts* are the mesh nodes (or a small displacement of
+                           them), so the cached mesh order can be reused
+        """
+        if (not getattr(self, 'locality_ordering', False)
+                or pts.shape[0] < self._LOCALITY_MIN_POINTS):
+            return tree.query(pts, k=k)
+        if mesh_order:
+            order = self._mesh_node_order()
+        else:
+            from .ordering import morton_order
+            order = morton_order(pts)
+        d, i = tree.query(pts[order], k=k)
+        dists = np.empty_like(d)
+        idxs  = np.empty_like(i)
+        dists[order] = d
+        idxs[order]  = i
+        return dists, idxs
+
+    def _src_to_mesh_weights(self, src_pts, k=3, power=1.0):
+        """
+        Return the IDW neighbour table from DES points onto GoSPL mesh nodes.
+
+        The table (neighbour indices and normalised weights, both (M, k)) is
+        cached and only rebuilt when the DES coordinates, k or power change, so
+        repeated transfers from an unchanged DES surface skip the KD-tree build
+        and query.
+
+        The table of the point set given to declare_surface_points() is kept
+        apart and returned for matching requests without touching the cache.
+
+        :param src_pts: (N, 3) DES surface node coordinates
+        :param k:       number of IDW neighbours
+        :param power:   IDW power exponent
+        :return:        dict with 'pts', 'k', 'power', 'idxs' and 'weights'
+        """
+        k = max(1, min(int(k), src_pts.shape[0]))
+        declared = getattr(self, '_declared_table', None)
+        if self._idw_table_matches(declared, src_pts, k, power):
+            return declared
+        cache = getattr(self, '_src_idw_cache', None)
+        if self._idw_table_matches(cache, src_pts, k, power):
+            return cache
+
+        cache = self._build_idw_table(src_pts, k, power)
+        self._src_idw_cache = cache
+        # Fields transferred through the previous table are no longer valid.
+        self._last_transfer = {}
+        return cache
+
+    @staticmethod
+    def _idw_table_matches(table, src_pts, k, power):
+        return (table is not None and table['k'] == k and table['power'] == power
+                and table['pts'].shape == src_pts.shape
+                and np.array_equal(table['pts'], src_pts))
+
+    def _build_idw_table(self, src_pts, k, power):
+        """Build an uncached DES -> mesh IDW table (see _src_to_mesh_weights())."""
+        src_tree = self._spatial_index(src_pts)
+        dists, idxs = self._knn(src_tree, self.mCoords, k, mesh_order=True)
+        if k == 1:
+            dists = dists[:, None]
+            idxs  = idxs[:, None]
+        eps = 1.0e-20
+        weights = 1.0 / np.maximum(dists, eps) ** power
+        onIDs = np.where(dists[:, 0] < eps)[0]
+        if onIDs.size > 0:
+            weights[onIDs] = 0.0
+            weights[onIDs, 0] = 1.0
+        weights /= weights.sum(axis=1, keepdims=True)
+        return {'pts': src_pts.copy(), 'k': k, 'power': power,
+                'idxs': idxs, 'weights': weights}
+
+    def _transfer_to_mesh(self, field, src_pts, values, k=3, power=1.0):
+        """
+        IDW-transfer DES values onto the mesh, skipping work when they are unchanged.
+
+        The incoming (N, c) values are compared against the previous transfer of
+        the same *field* in one vectorised pass (max-norm of the differences per
+        DES point). If no point changed by more than self.transfer_tol, the
+        previously interpolated mesh values are reused as-is. Otherwise only the
+        mesh nodes with at least one changed IDW neighbour are recomputed; a full
+        transfer is done when the coordinates changed or too many nodes are hit.
+
+        :param field:   cache key ('velocity', 'uplift', ...)
+        :param src_pts: (N, 3) DES surface node coordinates
+        :param values:  (N, c) DES values
+        :param k:       number of IDW neighbours
+        :param power:   IDW power exponent
+        :return:        (M, c) mesh values; owned by the transfer cache, read-only
+        """
+        table = self._src_to_mesh_weights(src_pts, k=k, power=power)
+        idxs, weights = table['idxs'], table['weights']
+        stats = self._get_transfer_stats()
+        stats['transfers'] += 1
+
+        # Transfers from the declared points keep the sparse uploads' fields.
+        if table is getattr(self, '_declared_table', None):
+            store = self._declared_fields
+        else:
+            if not hasattr(self, '_last_transfer'):
+                self._last_transfer = {}
+            store = self._last_transfer
+        last = store.get(field)
+        if last is not None and last['src'].shape == values.shape:
+            change = np.abs(values - last['src']).max(axis=1)
+            changed = change > getattr(self, 'transfer_tol', 0.0)
+            if not changed.any():
+                stats['skipped'] += 1
+                return last['mesh']
+
+            rows = np.flatnonzero(changed[idxs].any(axis=1))
+            if rows.size <= self._PARTIAL_TRANSFER_FRACTION * idxs.shape[0]:
+                # Only accept the changed points so sub-tolerance drift on the
+                # others cannot accumulate across calls.
+                last['src'][changed] = values[changed]
+                last['mesh'][rows] = np.einsum('mk,mkc->mc', weights[rows],
+                                               last['src'][idxs[rows]])
+                stats['partial'] += 1
+                stats['nodes_updated'] += rows.size
+                return last['mesh']
+
+        mesh = np.einsum('mk,mkc->mc', weights, values[idxs])
+        store[field] = {'src': values.copy(), 'mesh': mesh}
+        stats['full'] += 1
+        stats['nodes_updated'] += mesh.shape[0]
+        return mesh
+
+    def _get_transfer_stats(self):
+        if not hasattr(self, '_transfer_stats') or self._transfer_stats is None:
+            self._transfer_stats = {'transfers': 0, 'skipped': 0, 'partial': 0,
+                                    'full': 0, 'sparse': 0, 'nodes_updated': 0}
+        return self._transfer_stats
+
+    def set_transfer_tolerance(self, tol):
+        """
+        Set the change-detection tolerance used by set_surface_velocity() and
+        set_uplift_rate().
+
+        DES points whose values moved by at most *tol* (field units, e.g. m/yr)
+        since the last transfer are treated as unchanged. The default of 0.0
+        only skips exactly repeated values, which leaves results bit-identical.
+
+        :param tol: non-negative tolerance
+        """
+        tol = float(tol)
+        if tol < 0.0 or tol != tol:
+            raise ValueError(f"transfer tolerance must be non-negative, got {tol}")
+        self.transfer_tol = tol
+
+    def get_transfer_stats(self):
+        """
+        Return value-change detection counters for DES -> mesh transfers.
+
+        :return: dict with 'transfers', 'skipped', 'partial', 'full', 'sparse',
+                 'nodes_updated', and the derived 'skip_rate' and 'partial_rate'
+        """
+        stats = dict(self._get_transfer_stats())
+        n = max(stats['transfers'], 1)
+        stats['skip_rate']    = stats['skipped'] / n
+        stats['partial_rate'] = stats['partial'] / n
+        return stats
+
+    def declare_surface_points(self, src_pts, k=3, power=1.0):
+        """
+        Declare the DES point set addressed by the sparse upload methods.
+
+        Builds the DES -> mesh IDW table for *src_pts* plus its reverse map
+        (for every DES point, the mesh nodes that use it as an IDW neighbour),
+        so set_surface_velocity_sparse() and set_uplift_rate_sparse() only touch
+        mesh nodes near the changed points. Fields already transferred from the
+        same points are kept; otherwise they start from zero. The declared
+        table and fields are kept apart from the dense transfer cache, so dense
+        transfers from other points do not invalidate them.
+
+        :param src_pts: (N, 3) DES surface node coordinates
+        :param k:       number of IDW neighbours (default 3)
+        :param power:   IDW power exponent (default 1.0)
+        """
+        src_pts = np.asarray(src_pts, dtype=np.float64)
+        if src_pts.ndim != 2 or src_pts.shape[1] != 3 or src_pts.shape[0] == 0:
+            raise ValueError("src_pts must be of shape (N, 3) with N > 0")
+        k = max(1, min(int(k), src_pts.shape[0]))
+        if self._idw_table_matches(getattr(self, '_declared_table', None), src_pts, k, power):
+            return
+
+        fields = {}
+        cache = getattr(self, '_src_idw_cache', None)
+        if self._idw_table_matches(cache, src_pts, k, power):
+            table = dict(cache)
+            fields = {f: {'src': last['src'].copy(), 'mesh': last['mesh'].copy()}
+                      for f, last in getattr(self, '_last_transfer', {}).items()}
+        else:
+            table = self._build_idw_table(src_pts, k, power)
+
+        idxs = table['idxs']
+        nsrc = src_pts.shape[0]
+        order = np.argsort(idxs.ravel(), kind='stable')
+        rev_ptr = np.zeros(nsrc + 1, dtype=np.int64)
+        np.cumsum(np.bincount(idxs.ravel(), minlength=nsrc), out=rev_ptr[1:])
+        table['rev_ptr']  = rev_ptr
+        table['rev_rows'] = order // idxs.shape[1]
+
+        nmesh = idxs.shape[0]
+        for field, ncomp in (('velocity', 3), ('uplift', 1)):
+            last = fields.get(field)
+            if last is None or last['src'].shape != (nsrc, ncomp):
+                fields[field] = {'src':  np.zeros((nsrc, ncomp)),
+                                 'mesh': np.zeros((nmesh, ncomp))}
+        self._declared_table  = table
+        self._declared_fields = fields
+
+    def _sparse_transfer_to_mesh(self, field, indices, values):
+        """
+        Apply (indices, values) updates to a declared DES field and recompute
+        only the mesh nodes whose IDW neighbours include a changed point.
+
+        :param field:   cache key ('velocity' or 'uplift')
+        :param indices: (n,) indices into the declared DES point set
+        :param values:  (n, c) new values at those points
+        :return:        (M, c) mesh values; owned by the transfer cache, read-only
+        """
+        table = getattr(self, '_declared_table', None)
+        if table is None:
+            raise RuntimeError("declare_surface_points() must be called before sparse uploads")
+        indices = np.asarray(indices, dtype=np.int64).reshape(-1)
+        nsrc = table['pts'].shape[0]
+        if indices.size and (indices.min() < 0 or indices.max() >= nsrc):
+            raise IndexError(f"sparse indices must lie in [0, {nsrc})")
+
+        last = self._declared_fields[field]
+        last['src'][indices] = values
+
+        # Gather the reverse-map segments of all changed points in one pass.
+        rev_ptr = table['rev_ptr']
+        starts = rev_ptr[indices]
+        lens   = rev_ptr[indices + 1] - starts
+        offs   = np.repeat(starts - np.cumsum(lens) + lens, lens) + np.arange(lens.sum())
+        rows   = np.unique(table['rev_rows'][offs])
+        if rows.size > 0:
+            idxs = table['idxs'][rows]
+            last['mesh'][rows] = np.einsum('mk,mkc->mc', table['weights'][rows],
+                                           last['src'][idxs])
+
+        stats = self._get_transfer_stats()
+        stats['transfers'] += 1
+        stats['sparse'] += 1
+        stats['nodes_updated'] += rows.size
+        return last['mesh']
+
+    @paused
+    def set_surface_velocity_sparse(self, indices, vx_yr, vy_yr, vz_yr):
+        """
+        Sparse variant of set_surface_velocity() for the declared DES point set.
+
+        Only the listed points change; all others keep their last uploaded
+        velocities. Cost scales with the number of mesh nodes near the changed
+        points rather than with the whole surface.
+
+        :param indices: (n,) indices into the points given to declare_surface_points()
+        :param vx_yr:   (n,) new x-velocity in m/yr
+        :param vy_yr:   (n,) new y-velocity in m/yr
+        :param vz_yr:   (n,) new z-velocity (uplift) in m/yr
+        """
+        vel = np.column_stack((np.asarray(vx_yr, dtype=np.float64).reshape(-1),
+                               np.asarray(vy_yr, dtype=np.float64).reshape(-1),
+                               np.asarray(vz_yr, dtype=np.float64).reshape(-1)))
+        mesh_vel = self._sparse_transfer_to_mesh('velocity', indices, vel)
+        self._vx_override    = mesh_vel[:, 0]
+        self._vy_override    = mesh_vel[:, 1]
+        self._vz_override    = None
+        self._upsub_override = mesh_vel[:, 2]
+
+    @paused
+    def set_uplift_rate_sparse(self, indices, vz_yr):
+        """
+        Sparse variant of set_uplift_rate() for the declared DES point set.
+
+        :param indices: (n,) indices into the points given to declare_surface_points()
+        :param vz_yr:   (n,) new vertical velocity in m/yr
+        """
+        vz = np.asarray(vz_yr, dtype=np.float64).reshape(-1, 1)
+        mesh_vz = self._sparse_transfer_to_mesh('uplift', indices, vz)
+        self._upsub_override = mesh_vz[:, 0]
+
+    @paused
     def set_surface_velocity(self, src_pts, vx_yr, vy_yr, vz_yr, k=3, power=1.0):
         """
         Interpolate all three DES surface velocity components (m/yr) onto the GoSPL
@@ -469,6 +859,9 @@ class EnhancedModel(Model):
         - vx_yr, vy_yr are stored as _vx_override, _vy_override and applied as
           semi-Lagrangian horizontal advection of hGlobal before GoSPL runs.
 
+        Repeated or nearly repeated velocities reuse the previous mesh fields
+        (see set_transfer_tolerance()).
+
         :param src_pts: (N, 3) DES surface node coordinates
         :param vx_yr:   (N,)  x-velocity at each DES node in m/yr
         :param vy_yr:   (N,)  y-velocity at each DES node in m/yr
@@ -476,28 +869,82 @@ class EnhancedModel(Model):
         :param k:       number of IDW neighbours (default 3)
         :param power:   IDW power exponent (default 1.0)
         """
-        from scipy.spatial import cKDTree
         src_pts = np.asarray(src_pts, dtype=np.float64)
-        vx_yr   = np.asarray(vx_yr,   dtype=np.float64)
-        vy_yr   = np.asarray(vy_yr,   dtype=np.float64)
-        vz_yr   = np.asarray(vz_yr,   dtype=np.float64)
+        vel = np.column_stack((np.asarray(vx_yr, dtype=np.float64),
+                               np.asarray(vy_yr, dtype=np.float64),
+                               np.asarray(vz_yr, dtype=np.float64)))
+        mesh_vel = self._transfer_to_mesh('velocity', src_pts, vel, k=k, power=power)
+        self._vx_override    = mesh_vel[:, 0]
+        self._vy_override    = mesh_vel[:, 1]
+        self._vz_override    = None
+        self._upsub_override = mesh_vel[:, 2]
+
+    @paused
+    def accumulate_surface_velocity(self, src_pts, vx_yr, vy_yr, vz_yr, dt_des, k=3, power=1.0):
+        """
+        Add a time-weighted DES surface velocity sample to mesh-side accumulators.
+
+        Each call interpolates the velocities onto the mesh (reusing the IDW
+        table while the DES coordinates are unchanged, without replacing the
+        tables of set_surface_velocity() and the sparse uploads when they
+        move) and adds dt_des times the
+        result. The next run_and_get_erosion() uses the time average over all
+        accumulated samples as its velocity override and resets the
+        accumulators, so the host does not need its own averaging buffers.
+
+        :param src_pts: (N, 3) DES surface node coordinates
+        :param vx_yr:   (N,)  x-velocity at each DES node in m/yr
+        :param vy_yr:   (N,)  y-velocity at each DES node in m/yr
+        :param vz_yr:   (N,)  z-velocity (uplift) at each DES node in m/yr
+        :param dt_des:  duration of the DES step the sample represents (years)
+        :param k:       number of IDW neighbours (default 3)
+        :param power:   IDW power exponent (default 1.0)
+        """
+        if dt_des <= 0 or dt_des != dt_des:
+            raise ValueError(f"dt_des must be positive, got {dt_des}")
+        src_pts = np.asarray(src_pts, dtype=np.float64)
+        vel = np.column_stack((np.asarray(vx_yr, dtype=np.float64),
+                               np.asarray(vy_yr, dtype=np.float64),
+                               np.asarray(vz_yr, dtype=np.float64)))
+        table = self._accumulation_weights(src_pts, k=k, power=power)
+
+        if getattr(self, '_vel_accum', None) is None:
+            self._vel_accum = np.zeros((table['idxs'].shape[0], 3))
+            self._vel_accum_time = 0.0
+        self._vel_accum += dt_des * np.einsum('mk,mkc->mc', table['weights'], vel[table['idxs']])
+        self._vel_accum_time += dt_des
+
+    def _accumulation_weights(self, src_pts, k=3, power=1.0):
+        """
+        IDW table for an accumulated velocity sample.
+
+        Reuses the declared or dense transfer table when the points match;
+        otherwise the table is kept in its own cache, so samples from moving
+        DES points do not evict the shared table or its transferred fields.
+        """
         k = max(1, min(int(k), src_pts.shape[0]))
-        src_tree = cKDTree(src_pts, leafsize=10)
-        dists, idxs = src_tree.query(self.mCoords, k=k)
-        if k == 1:
-            dists = dists[:, None]
-            idxs  = idxs[:, None]
-        eps = 1.0e-20
-        weights = 1.0 / np.maximum(dists, eps) ** power
-        onIDs = np.where(dists[:, 0] < eps)[0]
-        if onIDs.size > 0:
-            weights[onIDs] = 0.0
-            weights[onIDs, 0] = 1.0
-        weights /= weights.sum(axis=1, keepdims=True)
-        self._upsub_override = (weights * vz_yr[idxs]).sum(axis=1)
-        self._vx_override    = (weights * vx_yr[idxs]).sum(axis=1)
-        self._vy_override    = (weights * vy_yr[idxs]).sum(axis=1)
+        for name in ('_declared_table', '_src_idw_cache', '_accum_idw_cache'):
+            table = getattr(self, name, None)
+            if self._idw_table_matches(table, src_pts, k, power):
+                return table
+        table = self._build_idw_table(src_pts, k, power)
+        self._accum_idw_cache = table
+        return table
+
+    def _consume_velocity_accumulators(self):
+        """Turn accumulated velocity samples into overrides and reset them."""
+        acc = getattr(self, '_vel_accum', None)
+        if acc is None:
+            return
+        mean_vel = acc / self._vel_accum_time
+        self._vx_override    = mean_vel[:, 0]
+        self._vy_override    = mean_vel[:, 1]
+        self._vz_override    = None
+        self._upsub_override = mean_vel[:, 2]
+        self._vel_accum      = None
+        self._vel_accum_time = 0.0
 
+    @paused
     def set_uplift_rate(self, src_pts, vz_yr, k=3, power=1.0):
         """
         Interpolate DES vertical velocities (m/yr) onto GoSPL mesh nodes and store
@@ -510,24 +957,72 @@ class EnhancedModel(Model):
         :param k:       number of IDW neighbours (default 3)
         :param power:   IDW power exponent (default 1.0)
         """
-        from scipy.spatial import cKDTree
         src_pts = np.asarray(src_pts, dtype=np.float64)
         vz_yr   = np.asarray(vz_yr,   dtype=np.float64)
-        k = max(1, min(int(k), src_pts.shape[0]))
-        src_tree = cKDTree(src_pts, leafsize=10)
-        dists, idxs = src_tree.query(self.mCoords, k=k)
-        if k == 1:
-            dists = dists[:, None]
-            idxs  = idxs[:, None]
-        eps = 1.0e-20
-        weights = 1.0 / np.maximum(dists, eps) ** power
-        onIDs = np.where(dists[:, 0] < eps)[0]
-        if onIDs.size > 0:
-            weights[onIDs] = 0.0
-            weights[onIDs, 0] = 1.0
-        weights /= weights.sum(axis=1, keepdims=True)
-        self._upsub_override = (weights * vz_yr[idxs]).sum(axis=1)  # (M,) m/yr, full mesh
+        mesh_vz = self._transfer_to_mesh('uplift', src_pts, vz_yr[:, None], k=k, power=power)
+        self._upsub_override = mesh_vz[:, 0]  # (M,) m/yr, full mesh
+
+    def register_plate_ids(self, src_pts, plate_ids):
+        """
+        Assign a plate ID to every mesh node for set_euler_poles().
+
+        Each mesh node takes the ID of its nearest source point. Call once,
+        and again only when the plate geometry changes.
+
+        :param src_pts:   (N, 3) coordinates carrying plate IDs
+        :param plate_ids: (N,) non-negative integer plate IDs
+        """
+        src_pts   = np.asarray(src_pts, dtype=np.float64)
+        plate_ids = np.asarray(plate_ids).reshape(-1)
+        if src_pts.ndim != 2 or src_pts.shape[1] != 3 or src_pts.shape[0] == 0:
+            raise ValueError("src_pts must be of shape (N, 3) with N > 0")
+        if plate_ids.shape[0] != src_pts.shape[0]:
+            raise ValueError("plate_ids must have one entry per source point")
+        if plate_ids.min() < 0:
+            raise ValueError("plate IDs must be non-negative")
 
+        _, nearest = self._spatial_index(src_pts).query(self.mCoords, k=1)
+        self._plate_ids = plate_ids.astype(np.int64)[nearest]
+
+    def set_euler_poles(self, omega):
+        """
+        Set rigid plate motion from one Euler rotation vector per plate.
+
+        Velocities are evaluated analytically on the mesh nodes as
+        v = omega[plate_id] x r, so each interval only transfers the plate
+        rotation vectors. Rigid rotation is tangential: on global meshes all
+        three Cartesian components are applied as horizontal advection, like
+        goSPL's own 3-D plate velocities. The vertical rate is left to
+        set_uplift_rate() (zero if none was set).
+
+        Flat meshes only admit rotation about the vertical axis; rotation
+        vectors with x or y components are rejected there.
+
+        :param omega: (P, 3) Cartesian rotation vectors in rad/yr, row i for
+                      plate ID i
+        """
+        plate_ids = getattr(self, '_plate_ids', None)
+        if plate_ids is None:
+            raise RuntimeError("register_plate_ids() must be called before set_euler_poles()")
+        omega = np.asarray(omega, dtype=np.float64)
+        if omega.ndim != 2 or omega.shape[1] != 3:
+            raise ValueError("omega must be of shape (num_plates, 3)")
+        if plate_ids.max() >= omega.shape[0]:
+            raise ValueError(f"plate ID {plate_ids.max()} has no Euler pole "
+                             f"({omega.shape[0]} given)")
+        flat = getattr(self, 'flatModel', True)
+        if flat and np.any(omega[:, :2] != 0.0):
+            raise ValueError("flat meshes only support Euler poles about the "
+                             "vertical axis (omega = (0, 0, w))")
+
+        vel = np.cross(omega[plate_ids], self.mCoords)
+        self._vx_override = vel[:, 0]
+        self._vy_override = vel[:, 1]
+        self._vz_override = None if flat else vel[:, 2]
+        if getattr(self, '_upsub_override', None) is None:
+            self._upsub_override = np.zeros(self.mCoords.shape[0])
+
+    @paused
     def run_and_get_erosion(self, dt, query_pts, k=3, power=1.0):
         """
         Run GoSPL for *dt* years and return net erosion (metres) at *query_pts*.
@@ -543,7 +1038,8 @@ class EnhancedModel(Model):
           5. One IDW pass: interpolate delta_h to query_pts.
 
         When no velocity override is set, GoSPL runs normally with its config-file
-        tectonics (skip_tectonics=False).
+        tectonics (skip_tectonics=False). Velocities accumulated with
+        accumulate_surface_velocity() take precedence and are consumed here.
 
         :param dt:         coupling interval in years
         :param query_pts:  (N, 3) coordinates at which to return erosion
@@ -551,9 +1047,755 @@ class EnhancedModel(Model):
         :param power:      IDW power exponent (default 1.0)
         :return:           (N,) array of net erosion in metres (negative = erosion)
         """
+        delta_h = self._take_speculation(dt, k=k, power=power)
+        if delta_h is None:
+            delta_h = self._run_coupled_interval(dt, k=k, power=power)
+        return self._gather_to_points(delta_h, query_pts, k=k, power=power)
+
+    @paused
+    def run_and_get_erosion_sparse(self, dt, query_pts, threshold, k=3, power=1.0):
+        """
+        Sparse variant of run_and_get_erosion(): return only the query points
+        whose |erosion| exceeds *threshold*.
+
+        The threshold is applied while gathering, with a count pass followed by
+        a fill pass into exactly sized output arrays. The result is also kept as
+        self._last_sparse_erosion so callers with too small a buffer can fetch
+        it again without rerunning GoSPL.
+
+        :param dt:         coupling interval in years
+        :param query_pts:  (N, 3) coordinates at which to evaluate erosion
+        :param threshold:  non-negative |erosion| threshold in metres
+        :param k:          IDW neighbours (default 3)
+        :param power:      IDW power exponent (default 1.0)
+        :return:           (indices, values): (n,) int32 query indices and
+                           (n,) float64 erosion in metres
+        """
+        if threshold < 0.0 or threshold != threshold:
+            raise ValueError(f"threshold must be non-negative, got {threshold}")
+        delta_h = self._take_speculation(dt, k=k, power=power)
+        if delta_h is None:
+            delta_h = self._run_coupled_interval(dt, k=k, power=power)
+        self._last_sparse_erosion = self._gather_to_points(
+            delta_h, query_pts, k=k, power=power, threshold=threshold)
+        return self._last_sparse_erosion
+
+    # ------------------------------------------------------------------
+    # Active-set stepping
+    # ------------------------------------------------------------------
+
+    def set_active_set(self, threshold=1.0e-6, area_threshold=1.0e-2, buffer=1,
+                       full_sweep_every=10):
+        """
+        Skip the surface processes of steps in which no mesh node is active.
+
+        After each step a node is active when its elevation changed by more
+        than *threshold*, its drainage area changed by more than
+        *area_threshold* (relative), or it receives flow from an active node;
+        the set is then grown by *buffer* rings of mesh neighbours. Elevation
+        edits between steps (DES transfers, drift correction) also activate
+        the nodes they touch. While the set is empty, runProcessesForDt() runs
+        goSPL in fast mode (tectonics only), and at least every
+        *full_sweep_every* steps a full step runs regardless.
+
+        goSPL's erosion, deposition and hillslope phases are global implicit
+        solves, so steps with any active node still process the whole mesh.
+
+        :param threshold:        elevation change in metres per step; None
+                                 disables active-set stepping
+        :param area_threshold:   relative drainage area change
+        :param buffer:           rings of mesh neighbours added to the set
+        :param full_sweep_every: maximum interval between full steps
+        """
+        if threshold is None:
+            self._active_cfg = None
+            self._active_state = None
+            return
+        threshold, area_threshold = float(threshold), float(area_threshold)
+        if not threshold > 0.0 or not area_threshold > 0.0:
+            raise ValueError("active-set thresholds must be positive")
+        if int(buffer) < 0 or int(full_sweep_every) < 1:
+            raise ValueError("buffer must be >= 0 and full_sweep_every >= 1")
+        self._active_cfg = {'threshold': threshold, 'area_threshold': area_threshold,
+                            'buffer': int(buffer),
+                            'full_sweep_every': int(full_sweep_every)}
+        # No history yet: the first step is a full one.
+        self._active_state = {'mask': None, 'h_end': None, 'h_start': None,
+                              'fa_start': None, 'since_full': 0}
+
+    def _flow_area(self):
+        vec = getattr(self, 'FAG', None)
+        return vec.getArray().copy() if vec is not None and hasattr(vec, 'getArray') else None
+
+    def _active_set_begin(self):
+        """Record the pre-step state; return True if the step is quiescent."""
+        cfg = getattr(self, '_active_cfg', None)
+        if cfg is None:
+            return False
+        state = self._active_state
+        h = self.hGlobal.getArray()
+        if state['h_end'] is None or state['h_end'].shape != h.shape:
+            quiescent = False
+        else:
+            edited = np.abs(h - state['h_end']) > cfg['threshold']
+            if edited.any():
+                state['mask'] = state['mask'] | self._grow_active_set(edited)
+            quiescent = (not state['mask'].any()
+                         and state['since_full'] + 1 < cfg['full_sweep_every'])
+        state['h_start'] = h.copy()
+        state['fa_start'] = None if quiescent else self._flow_area()
+        return quiescent
+
+    def _active_set_end(self, quiescent):
+        """Derive the active set from the step that just ran."""
+        cfg = getattr(self, '_active_cfg', None)
+        if cfg is None:
+            return
+        state = self._active_state
+        stats = self._get_active_set_stats()
+        h = self.hGlobal.getArray()
+        active = np.abs(h - state['h_start']) > cfg['threshold']
+        if quiescent:
+            state['since_full'] += 1
+            stats['skipped'] += 1
+        else:
+            fa0, fa = state['fa_start'], self._flow_area()
+            if fa0 is not None and fa is not None and fa0.shape == fa.shape:
+                scale = np.maximum(np.maximum(np.abs(fa0), np.abs(fa)), 1.0e-300)
+                active |= np.abs(fa - fa0) > cfg['area_threshold'] * scale
+            if state['mask'] is not None and not state['mask'].any():
+                stats['sweeps'] += 1
+            state['since_full'] = 0
+        state['mask'] = self._grow_active_set(active)
+        state['h_end'] = h.copy()
+        stats['steps'] += 1
+        stats['active_fraction'] = float(state['mask'].mean()) if state['mask'].size else 0.0
+
+    def _grow_active_set(self, active):
+        """Add flow receivers of active nodes and *buffer* neighbour rings."""
+        loc = getattr(self, 'locIDs', None)
+        if loc is None:
+            return active
+        local = active[loc]
+        rcv = getattr(self, 'rcvID', None)
+        if rcv is not None:
+            r = np.asarray(rcv)[local].ravel()
+            local[r[(r >= 0) & (r < local.size)]] = True
+        ngb = getattr(self, 'FVmesh_ngbID', None)
+        if ngb is not None:
+            ngb = np.asarray(ngb)
+            for _ in range(self._active_cfg['buffer']):
+                n = ngb[local].ravel()
+                local[n[(n >= 0) & (n < local.size)]] = True
+        grown = active.copy()
+        grown[loc] |= local
+        return grown
+
+    def _get_active_set_stats(self):
+        if getattr(self, '_active_set_stats', None) is None:
+            self._active_set_stats = {'steps': 0, 'skipped': 0, 'sweeps': 0,
+                                      'active_fraction': 1.0}
+        return self._active_set_stats
+
+    def get_active_set_stats(self):
+        """
+        Return active-set stepping counters.
+
+        :return: dict with 'steps', 'skipped' (run in fast mode), 'sweeps'
+                 (full steps forced after quiescent ones) and the
+                 'active_fraction' of nodes after the last step
+        """
+        return dict(self._get_active_set_stats())
+
+    # ------------------------------------------------------------------
+    # Catchment-parallel flow accumulation
+    # ------------------------------------------------------------------
+
+    def set_catchment_parallel(self, enabled=True, threads=None, giant_fraction=0.5):
+        """
+        Solve goSPL's flow accumulation systems basin by basin in parallel.
+
+        goSPL accumulates water and sediment fluxes by solving
+        (I - W^T) x = b with PETSc on the flow matrix built by matrixFlow().
+        When enabled, those solves are split into the drainage basins of the
+        receiver graph (see catchments) and swept on a thread pool, largest
+        basin first. The PETSc solve is kept when the native kernel is not
+        installed, on distributed meshes, when one basin holds more than
+        *giant_fraction* of the nodes, or if the receiver graph has a cycle.
+
+        :param enabled:        True to enable, False for goSPL's global solves
+        :param threads:        worker threads (default: all cores)
+        :param giant_fraction: largest-basin share of the nodes above which
+                               the global solve is used
+        """
+        if not enabled:
+            self._catchment_cfg = None
+            self._flow_graph = None
+            return
+        giant_fraction = float(giant_fraction)
+        if not 0.0 < giant_fraction <= 1.0:
+            raise ValueError(f"giant_fraction must be in (0, 1], got {giant_fraction}")
+        self._catchment_cfg = {'threads': None if threads is None else max(1, int(threads)),
+                               'giant_fraction': giant_fraction}
+
+    def matrixFlow(self, *args, **kwargs):
+        """goSPL's matrixFlow(), remembering the receiver graph of the matrix."""
+        result = super().matrixFlow(*args, **kwargs)
+        if getattr(self, '_catchment_cfg', None) is not None:
+            rcv = getattr(self, 'rcvID', None)
+            wght = getattr(self, 'wghtVal', None)
+            self._flow_graph = None if rcv is None or wght is None else {
+                'matrix': getattr(self, 'fMati', None),
+                'rcv': np.array(rcv, dtype=np.int64),
+                'wght': np.array(wght, dtype=np.float64),
+                'basins': None}
+        return result
+
+    def _solve_KSP(self, guess, matrix, vector1, vector2):
+        """Per-basin solve of flow-matrix systems, else goSPL's KSP solve."""
+        graph = getattr(self, '_flow_graph', None)
+        if (graph is not None and graph['matrix'] is not None
+                and matrix is graph['matrix']
+                and getattr(self, '_catchment_cfg', None) is not None
+                and self._catchment_solve(graph, vector1, vector2)):
+            return vector2
+        return super()._solve_KSP(guess, matrix, vector1, vector2)
+
+    def _catchment_solve(self, graph, vector1, vector2):
+        from . import catchments
+        stats = self._get_catchment_stats()
+        rhs = vector1.getArray()
+        loc = getattr(self, 'locIDs', None)
+        n = graph['rcv'].shape[0]
+        if (not catchments.available() or loc is None or len(loc) != n
+                or rhs.shape[0] != n):
+            stats['fallbacks'] += 1
+            return False
+
+        if graph['basins'] is None:
+            graph['basins'] = catchments.Catchments(graph['rcv'], graph['wght'])
+        basins = graph['basins']
+        stats['basins'] = int(basins.count)
+        stats['largest_fraction'] = basins.largest_fraction
+        if basins.largest_fraction > self._catchment_cfg['giant_fraction']:
+            stats['fallbacks'] += 1
+            return False
+
+        x = basins.accumulate(rhs[loc], threads=self._catchment_cfg['threads'])
+        if x is None:
+            stats['fallbacks'] += 1
+            return False
+        vector2.getArray()[loc] = x
+        stats['solves'] += 1
+        return True
+
+    def _get_catchment_stats(self):
+        if getattr(self, '_catchment_stats', None) is None:
+            self._catchment_stats = {'solves': 0, 'fallbacks': 0, 'basins': 0,
+                                     'largest_fraction': 0.0}
+        return self._catchment_stats
+
+    def get_catchment_stats(self):
+        """
+        Return catchment-parallel solve counters.
+
+        :return: dict with 'solves' (per-basin), 'fallbacks' (global PETSc),
+                 and 'basins' and 'largest_fraction' of the last flow graph
+        """
+        return dict(self._get_catchment_stats())
+
+    # ------------------------------------------------------------------
+    # Incremental depression filling
+    # ------------------------------------------------------------------
+
+    def set_incremental_depressions(self, enabled=True, tolerance=1.0e-6):
+        """
+        Track the filled surface and its depressions on demand.
+
+        Each get_depression_stats() call brings a persistent priority-flood
+        state (see depressions) up to date with the current elevations,
+        reflooding only the depressions around nodes that moved by more than
+        *tolerance* since the previous call, whether through erosion, uplift
+        overrides or drift correction.
+
+        The state is not updated while stepping: goSPL fills pits itself
+        inside flowAccumulation() and routes flow over its own filled surface,
+        so a per-step update would only add cost.
+
+        :param enabled:   True to enable, False to drop the state
+        :param tolerance: elevation change in metres below which a node is
+                          treated as unchanged
+        """
+        self._depressions = None
+        if not enabled:
+            self._depression_cfg = None
+            return
+        tolerance = float(tolerance)
+        if not tolerance >= 0.0:
+            raise ValueError(f"tolerance must be >= 0, got {tolerance}")
+        self._depression_cfg = {'tolerance': tolerance}
+
+    def _update_depressions(self):
+        from .depressions import DepressionFiller
+        loc = getattr(self, 'locIDs', None)
+        ngb = getattr(self, 'FVmesh_ngbID', None)
+        h = self.hGlobal.getArray()
+        if loc is None or ngb is None or len(loc) != h.shape[0]:
+            # Needs the whole mesh on this rank.
+            return
+        z = h[loc]
+        outlets = z < getattr(self, 'sealevel', -np.inf)
+        borders = getattr(self, 'idBorders', None)
+        if borders is not None:
+            outlets[np.asarray(borders, dtype=np.int64)] = True
+
+        filler = getattr(self, '_depressions', None)
+        if filler is None or filler.elevation.shape != z.shape:
+            self._depressions = DepressionFiller(ngb, z, outlets,
+                                                 self._depression_cfg['tolerance'])
+        else:
+            filler.update(z, outlets)
+
+    def get_depression_stats(self):
+        """
+        Update the depression state to the current elevations and return its
+        counters.
+
+        :return: dict with 'depressions' (current count), 'recomputed'
+                 (depressions reflooded by this update),
+                 'total_recomputed', 'updates' and 'full' (floods of the
+                 whole mesh); None when disabled or the mesh is distributed
+        """
+        if getattr(self, '_depression_cfg', None) is None:
+            return None
+        self._update_depressions()
+        filler = getattr(self, '_depressions', None)
+        if filler is None:
+            return None
+        stats = filler.stats
+        return dict(depressions=filler.count, recomputed=stats['last_recomputed'],
+                    total_recomputed=stats['recomputed'], updates=stats['updates'],
+                    full=stats['full'])
+
+    # ------------------------------------------------------------------
+    # Output timing
+    # ------------------------------------------------------------------
+
+    def visModel(self, *args, **kwargs):
+        """goSPL's visModel() (HDF5/XDMF output), timed for get_output_stats()."""
+        start = perf_counter()
+        try:
+            return super().visModel(*args, **kwargs)
+        finally:
+            stats = self._get_output_stats()
+            stats['writes'] += 1
+            stats['seconds'] += perf_counter() - start
+
+    def _get_output_stats(self):
+        if getattr(self, '_output_stats', None) is None:
+            self._output_stats = {'writes': 0, 'seconds': 0.0}
+        return self._output_stats
+
+    def get_output_stats(self):
+        """
+        Return counters of goSPL's own output.
+
+        :return: dict with 'writes' (visModel() calls) and 'seconds' (wall
+                 time spent in them)
+        """
+        return dict(self._get_output_stats())
+
+    # ------------------------------------------------------------------
+    # Speculative execution of the next coupling interval
+    # ------------------------------------------------------------------
+
+    _SNAPSHOT_SCALAR_TYPES = (bool, int, float, complex, str, bytes, type(None), np.generic)
+    _SNAPSHOT_CONTAINER_TYPES = (list, tuple, dict, set)
+
+    def _state_attributes(self):
+        """
+        Yield (name, value) for the attributes a goSPL step may change.
+
+        goSPL keeps all of its evolving state in public instance attributes:
+        PETSc vectors (elevation, erosion/deposition, flow accumulation), numpy
+        arrays (stratigraphic layers, flexure, forcing fields) and plain values
+        (time, tectonic/rain/sea-level record indices, output counters).
+        Private attributes and the coupling configuration in _COUPLING_STATE
+        belong to this class and are not rolled back.
+        """
+        for name, value in list(self.__dict__.items()):
+            if name.startswith('_') or name in self._COUPLING_STATE or callable(value):
+                continue
+            yield name, value
+
+    def _snapshot_state(self):
+        """
+        Capture the evolving model state so it can be restored later.
+
+        PETSc vectors and writable arrays are copied by value, plain values
+        kept and containers deep-copied. Everything else (DMs, solvers,
+        scatters, read-only or shared arrays, values that cannot be copied) is
+        kept by reference. The names of all attributes present are recorded so
+        a restore only removes attributes created afterwards.
+        """
+        snap = {'vecs': {}, 'arrays': {}, 'scalars': {}, 'objects': {}, 'refs': {},
+                'names': set()}
+        for name, value in self._state_attributes():
+            snap['names'].add(name)
+            if hasattr(value, 'getArray'):
+                snap['vecs'][name] = (value, value.getArray().copy())
+            elif isinstance(value, np.ndarray) and value.flags.writeable:
+                snap['arrays'][name] = value.copy()
+            elif isinstance(value, self._SNAPSHOT_SCALAR_TYPES):
+                snap['scalars'][name] = value
+            elif isinstance(value, self._SNAPSHOT_CONTAINER_TYPES):
+                try:
+                    snap['objects'][name] = copy.deepcopy(value)
+                except Exception:
+                    snap['refs'][name] = value
+            else:
+                snap['refs'][name] = value
+        return snap
+
+    def _restore_state(self, snap):
+        """
+        Restore a state captured by _snapshot_state().
+
+        Attributes created after the snapshot are removed. The snapshot itself
+        is left intact and can be restored again.
+        """
+        for name, _ in self._state_attributes():
+            if name not in snap['names']:
+                delattr(self, name)
+        for name, (vec, values) in snap['vecs'].items():
+            setattr(self, name, vec)
+            vec.getArray()[:] = values
+        for name, values in snap['arrays'].items():
+            current = self.__dict__.get(name)
+            if (isinstance(current, np.ndarray) and current.flags.writeable
+                    and current.shape == values.shape and current.dtype == values.dtype):
+                current[...] = values
+            else:
+                setattr(self, name, values.copy())
+        for name, value in snap['scalars'].items():
+            setattr(self, name, value)
+        for name, value in snap['objects'].items():
+            setattr(self, name, copy.deepcopy(value))
+        for name, value in snap['refs'].items():
+            setattr(self, name, value)
+
+    def enable_speculation(self, enabled=True, tolerance=0.0):
+        """
+        Configure speculative execution of the next coupling interval.
+
+        While enabled, the C interface calls speculate_next_interval() in the
+        background after each run_and_get_erosion(). The next erosion call
+        commits the speculative result if its velocities match the speculated
+        ones within *tolerance* (max-norm, m/yr) and dt is unchanged; otherwise
+        the state is rolled back and the interval is rerun.
+
+        Rollback restores every attribute a goSPL step changes (see
+        _snapshot_state()), including stratigraphy, flexure and forcing record
+        indices. Intervals in which goSPL would write output are not
+        speculated, since written files cannot be taken back.
+
+        :param enabled:   True to enable, False to disable (drops any pending
+                          speculation)
+        :param tolerance: non-negative velocity tolerance in m/yr
+        """
+        tolerance = float(tolerance)
+        if tolerance < 0.0 or tolerance != tolerance:
+            raise ValueError(f"speculation tolerance must be non-negative, got {tolerance}")
+        self.speculation_tol = tolerance
+        self.speculation_enabled = bool(enabled)
+        if not enabled:
+            self.cancel_speculation()
+
+    def speculate_next_interval(self, dt, k=3, power=1.0):
+        """
+        Run the next coupling interval ahead of time with extrapolated forcing.
+
+        The velocities of the interval just completed are held constant
+        (zero-order extrapolation) for the next one. The model state is
+        snapshotted first so the run can be rolled back if the real forcing
+        differs; the resulting delta_h is kept until the next erosion call.
+
+        :param dt:    coupling interval in years
+        :param k:     IDW neighbours (default 3)
+        :param power: IDW power exponent (default 1.0)
+        """
+        # Callback forcing is pulled at step time; never call the host early.
+        if not getattr(self, 'speculation_enabled', False) or getattr(self, '_forcing', None):
+            return
+        self.cancel_speculation()
+        # Output written within the interval could not be undone on rollback.
+        if getattr(self, 'saveTime', np.inf) <= self.tNow + dt:
+            return
+        velocity = getattr(self, '_last_applied_velocity', None)
+        snap = self._snapshot_state()
+        if velocity is not None:
+            (self._vx_override, self._vy_override, self._vz_override,
+             self._upsub_override) = velocity
+        # Any output goSPL still attempts aborts the speculation.
+        vis_model = self.__dict__.get('visModel')
+        self.visModel = self._refuse_speculative_output
+        try:
+            delta_h = self._run_coupled_interval(dt, k=k, power=power)
+        except _SpeculativeOutput:
+            self._restore_state(snap)
+            return
+        except Exception:
+            self._restore_state(snap)
+            raise
+        finally:
+            if vis_model is None:
+                del self.visModel
+            else:
+                self.visModel = vis_model
+        self._speculation = {'snapshot': snap, 'dt': dt, 'k': k, 'power': power,
+                             'velocity': velocity, 'delta_h': delta_h}
+
+    @staticmethod
+    def _refuse_speculative_output(*args, **kwargs):
+        raise _SpeculativeOutput()
+
+    def cancel_speculation(self):
+        """Roll back a pending speculative interval, if any."""
+        spec = getattr(self, '_speculation', None)
+        if spec is None:
+            return
+        self._speculation = None
+        self._restore_state(spec['snapshot'])
+        self._last_applied_velocity = spec['velocity']
+        self._get_speculation_stats()['rolled_back'] += 1
+
+    def _take_speculation(self, dt, k=3, power=1.0):
+        """
+        Validate a pending speculation against the real forcing.
+
+        :return: the speculative delta_h if it was committed, else None (after
+                 rolling the state back)
+        """
+        spec = getattr(self, '_speculation', None)
+        if spec is None:
+            return None
+
+        self._consume_velocity_accumulators()
+        upsub = getattr(self, '_upsub_override', None)
+        if upsub is None:
+            current = None
+        else:
+            vx = getattr(self, '_vx_override', None)
+            vy = getattr(self, '_vy_override', None)
+            vz = getattr(self, '_vz_override', None)
+            current = (vx, vy, vz, upsub)
+
+        if (spec['dt'] == dt and spec['k'] == k and spec['power'] == power
+                and self._velocities_match(spec['velocity'], current)):
+            self._speculation = None
+            self._vx_override = None
+            self._vy_override = None
+            self._vz_override = None
+            self._upsub_override = None
+            self._last_applied_velocity = spec['velocity']
+            self._get_speculation_stats()['committed'] += 1
+            return spec['delta_h']
+
+        self.cancel_speculation()
+        return None
+
+    def _velocities_match(self, speculated, current):
+        if speculated is None or current is None:
+            return speculated is None and current is None
+        tol = getattr(self, 'speculation_tol', 0.0)
+        for a, b in zip(speculated, current):
+            if (a is None) != (b is None):
+                return False
+            if a is not None and np.abs(a - b).max() > tol:
+                return False
+        return True
+
+    def _committed_elevation(self):
+        """hGlobal values as of the last committed interval."""
+        spec = getattr(self, '_speculation', None)
+        if spec is not None and 'hGlobal' in spec['snapshot']['vecs']:
+            return spec['snapshot']['vecs']['hGlobal'][1]
+        return self.hGlobal.getArray()
+
+    def get_committed_time(self):
+        """
+        Return the model time as of the last committed interval.
+
+        A pending speculation has already advanced tNow; callers outside the
+        coupling loop should see the time the DES side has accepted.
+        """
+        spec = getattr(self, '_speculation', None)
+        if spec is not None and 'tNow' in spec['snapshot']['scalars']:
+            return spec['snapshot']['scalars']['tNow']
+        return self.tNow
+
+    def _get_speculation_stats(self):
+        if not hasattr(self, '_speculation_stats') or self._speculation_stats is None:
+            self._speculation_stats = {'committed': 0, 'rolled_back': 0}
+        return self._speculation_stats
+
+    def get_speculation_stats(self):
+        """
+        Return counts of committed and rolled-back speculative intervals.
+
+        :return: dict with 'committed' and 'rolled_back'
+        """
+        return dict(self._get_speculation_stats())
+
+    # Per-job coupling state dropped by reset_coupling_state(); caches that
+    # depend only on the mesh (IDW tables, KD-tree) are kept.
+    _COUPLING_STATE = ('_vx_override', '_vy_override', '_vz_override',
+                       '_upsub_override', '_vel_accum', '_speculation', '_speculation_stats',
+                       '_transfer_stats', '_last_applied_velocity', '_forcing',
+                       '_plate_ids', '_last_sparse_erosion', '_declared_table',
+                       '_declared_fields', 'speculation_enabled',
+                       'speculation_tol', 'transfer_tol', 'forcing_substeps',
+                       'locality_ordering', '_active_cfg', '_active_state', '_active_set_stats',
+                       '_depression_cfg', '_depressions', '_output_stats')
+
+    def reset_coupling_state(self):
+        """
+        Forget everything a coupled job configured on this instance.
+
+        Used by the model server before handing an instance to the next job,
+        together with _restore_state() of the initial snapshot.
+        """
+        for name in self._COUPLING_STATE:
+            if name in self.__dict__:
+                delattr(self, name)
+        self._vel_accum_time = 0.0
+        self._last_transfer = {}
+
+    def set_output_dir(self, path):
+        """
+        Redirect goSPL output (HDF5 and XDMF files) to *path*.
+
+        Every path attribute under the current output directory is moved
+        under *path*, and the h5/ and xmf/ subdirectories goSPL writes into
+        are created.
+
+        :param path: new output directory
+        """
+        old = getattr(self, 'outputDir', None)
+        path = str(path)
+        if old:
+            for name, value in list(self.__dict__.items()):
+                if (name != 'outputDir' and isinstance(value, str)
+                        and (value == old or value.startswith(old + '/'))):
+                    setattr(self, name, path + value[len(old):])
+        self.outputDir = path
+        for sub in ('h5', 'xmf'):
+            os.makedirs(os.path.join(path, sub), exist_ok=True)
+
+    # ------------------------------------------------------------------
+    # Host-provided forcing callbacks
+    # ------------------------------------------------------------------
+
+    # Callback kinds and the number of values they return per host point.
+    _FORCING_KINDS = {0: ('velocity', 3), 1: ('uplift', 1)}
+
+    def register_forcing(self, kind, src_pts, pull):
+        """
+        Register a forcing source that is pulled at GoSPL's own step times.
+
+        While a source is registered, each coupling interval is split into
+        forcing_substeps steps (default 1) and *pull* is called at the midpoint
+        of every step; its values replace set_surface_velocity() (kind 0) or
+        set_uplift_rate() (kind 1) input for that step.
+
+        :param kind:    0 for (vx, vy, vz) velocity, 1 for vertical rate only
+        :param src_pts: (N, 3) host point coordinates the callback samples
+        :param pull:    callable(time) returning (N, c) values in m/yr, or
+                        None to unregister the kind
+        """
+        if kind not in self._FORCING_KINDS:
+            raise ValueError(f"unknown forcing kind {kind}")
+        name, _ = self._FORCING_KINDS[kind]
+        self.cancel_speculation()
+        if not hasattr(self, '_forcing') or self._forcing is None:
+            self._forcing = {}
+        if pull is None:
+            self._forcing.pop(name, None)
+            return
+        src_pts = np.asarray(src_pts, dtype=np.float64)
+        if src_pts.ndim != 2 or src_pts.shape[1] != 3 or src_pts.shape[0] == 0:
+            raise ValueError("src_pts must be of shape (N, 3) with N > 0")
+        self._forcing[name] = {'pts': src_pts.copy(), 'pull': pull}
+
+    def set_forcing_substeps(self, num_substeps):
+        """
+        Set how many steps each coupling interval is split into while forcing
+        callbacks are registered (one forcing pull per step).
+
+        :param num_substeps: number of substeps, at least 1
+        """
+        num_substeps = int(num_substeps)
+        if num_substeps < 1:
+            raise ValueError(f"num_substeps must be at least 1, got {num_substeps}")
+        self.forcing_substeps = num_substeps
+
+    def _pull_forcing(self, time, k=3, power=1.0):
+        """Fetch every registered forcing at *time* and store it as overrides."""
+        velocity = self._forcing.get('velocity')
+        if velocity is not None:
+            vel = np.asarray(velocity['pull'](time), dtype=np.float64).reshape(-1, 3)
+            self.set_surface_velocity(velocity['pts'], vel[:, 0], vel[:, 1], vel[:, 2],
+                                      k=k, power=power)
+        uplift = self._forcing.get('uplift')
+        if uplift is not None:
+            vz = np.asarray(uplift['pull'](time), dtype=np.float64).reshape(-1)
+            self.set_uplift_rate(uplift['pts'], vz, k=k, power=power)
+
+    def _run_coupled_interval(self, dt, k=3, power=1.0):
+        """
+        Run one coupling interval of *dt* years and return delta_h.
+
+        With registered forcing callbacks the interval is subcycled and the
+        forcing is pulled at the midpoint of every substep.
+
+        :return: (M,) elevation change in PETSc global ordering with the
+                 tectonic uplift stripped (erosion + diffusion only)
+        """
+        if not getattr(self, '_forcing', None):
+            return self._run_forced_step(dt, k=k, power=power)
+
+        nsub = max(1, int(getattr(self, 'forcing_substeps', 1)))
+        h = dt / nsub
+        delta_h = None
+        for _ in range(nsub):
+            self._pull_forcing(self.tNow + 0.5 * h, k=k, power=power)
+            step = self._run_forced_step(h, k=k, power=power)
+            delta_h = step if delta_h is None else delta_h + step
+        return delta_h
+
+    def _run_forced_step(self, dt, k=3, power=1.0):
+        """
+        Apply stored velocity overrides, run GoSPL for *dt* and return delta_h.
+
+        :return: (M,) elevation change in PETSc global ordering with the
+                 tectonic uplift stripped (erosion + diffusion only)
+        """
         eps = 1.0e-20
+        self._consume_velocity_accumulators()
         has_vel   = hasattr(self, '_upsub_override') and self._upsub_override is not None
         has_horiz = has_vel and (hasattr(self, '_vx_override') and self._vx_override is not None)
+        vz = getattr(self, '_vz_override', None) if has_horiz else None
+
+        # Remember the forcing of this interval; speculation extrapolates from it.
+        if has_vel:
+            self._last_applied_velocity = (
+                self._vx_override.copy() if has_horiz else None,
+                self._vy_override.copy() if has_horiz else None,
+                vz.copy() if vz is not None else None,
+                self._upsub_override.copy(),
+            )
+        else:
+            self._last_applied_velocity = None
 
         # --- Horizontal advection ---
         if has_horiz:
@@ -563,6 +1805,8 @@ class EnhancedModel(Model):
                 nodeVel = np.zeros((self.lpoints, 3), dtype=np.float64)
                 nodeVel[:, 0] = self._vx_override[self.locIDs]
                 nodeVel[:, 1] = self._vy_override[self.locIDs]
+                if vz is not None:
+                    nodeVel[:, 2] = vz[self.locIDs]
                 self.hdisp = nodeVel
                 getfacevelocity(self.lpoints, nodeVel)
                 old_dt = self.dt
@@ -575,9 +1819,11 @@ class EnhancedModel(Model):
                 displaced = self.mCoords.copy()
                 displaced[:, 0] -= self._vx_override * dt
                 displaced[:, 1] -= self._vy_override * dt
+                if vz is not None:
+                    displaced[:, 2] -= vz * dt
                 mesh_tree = self._get_mesh_tree()
                 k_adv = max(1, min(int(k), self.mCoords.shape[0]))
-                adv_dists, adv_idxs = mesh_tree.query(displaced, k=k_adv)
+                adv_dists, adv_idxs = self._knn(mesh_tree, displaced, k_adv, mesh_order=True)
                 if k_adv == 1:
                     adv_dists = adv_dists[:, None]
                     adv_idxs  = adv_idxs[:, None]
@@ -593,6 +1839,7 @@ class EnhancedModel(Model):
                     self.hLocal.getArray()[:] = h[self.locIDs]
             self._vx_override = None
             self._vy_override = None
+            self._vz_override = None
 
         # --- Vertical uplift: set self.upsub for GoSPL's native applyTectonics ---
         old_upsub   = getattr(self, 'upsub', None)
@@ -624,27 +1871,57 @@ class EnhancedModel(Model):
             self.upsub          = old_upsub
             self._upsub_override = None
 
-        # Single IDW pass: native-mesh delta_h → query_pts
+        return delta_h
+
+    def _gather_to_points(self, delta_h, query_pts, k=3, power=1.0, threshold=None):
+        """
+        Single IDW pass: native-mesh delta_h -> query_pts.
+
+        :param delta_h:   (M,) elevation change in PETSc global ordering
+        :param query_pts: (N, 3) query coordinates
+        :param k:         IDW neighbours
+        :param power:     IDW power exponent
+        :param threshold: if given, return only points with |value| > threshold
+        :return:          (N,) values, or (indices, values) when thresholded
+        """
+        eps = 1.0e-20
         query_pts = np.asarray(query_pts, dtype=np.float64)
+        # delta_h is in PETSc global ordering; idxs indexes mCoords.
+        # Remap through glbIDs so delta_h[glbIDs[idxs]] gives the correct
+        # elevation change for the mCoords node referenced by each idxs entry.
+        delta_h_mcoords = delta_h[self.glbIDs]  # mCoords-ordered delta_h
+        if threshold is not None:
+            # An IDW value is a convex combination of its neighbours, so it can
+            # only exceed the threshold next to a mesh node that does.
+            active = np.abs(delta_h_mcoords) > threshold
+            if not active.any():
+                return np.empty(0, dtype=np.int32), np.empty(0, dtype=np.float64)
+
         tree = self._get_mesh_tree()
         k_q = max(1, min(int(k), self.mCoords.shape[0]))
-        dists, idxs = tree.query(query_pts, k=k_q)
+        dists, idxs = self._knn(tree, query_pts, k_q)
         if k_q == 1:
             dists = dists[:, None]
             idxs  = idxs[:, None]
+        rows = None
+        if threshold is not None:
+            rows = np.flatnonzero(active[idxs].any(axis=1))
+            dists, idxs = dists[rows], idxs[rows]
         weights = 1.0 / np.maximum(dists, eps) ** power
         onIDs = np.where(dists[:, 0] < eps)[0]
         if onIDs.size > 0:
             weights[onIDs] = 0.0
             weights[onIDs, 0] = 1.0
         weights /= weights.sum(axis=1, keepdims=True)
-        # delta_h is in PETSc global ordering; idxs indexes mCoords.
-        # Remap through glbIDs so delta_h[glbIDs[idxs]] gives the correct
-        # elevation change for the mCoords node referenced by each idxs entry.
-        delta_h_mcoords = delta_h[self.glbIDs]  # mCoords-ordered delta_h
         result = (weights * delta_h_mcoords[idxs]).sum(axis=1)
-        return result
+        if threshold is None:
+            return result
 
+        # Only candidate points were interpolated; keep those above threshold.
+        keep = np.abs(result) > threshold
+        return rows[keep].astype(np.int32), result[keep]
+
+    @paused
     def apply_drift_correction(self, src_pts, des_elevation, alpha=0.1, k=3, power=1.0):
         """
         Blend hGlobal gently toward the DES elevation without a full reset.
@@ -660,12 +1937,12 @@ class EnhancedModel(Model):
         :param k:             IDW neighbours (default 3)
         :param power:         IDW power exponent (default 1.0)
         """
-        from scipy.spatial import cKDTree
+        self.cancel_speculation()
         src_pts       = np.asarray(src_pts,       dtype=np.float64)
         des_elevation = np.asarray(des_elevation, dtype=np.float64)
         k = max(1, min(int(k), src_pts.shape[0]))
-        src_tree = cKDTree(src_pts, leafsize=10)
-        dists, idxs = src_tree.query(self.mCoords, k=k)
+        src_tree = self._spatial_index(src_pts)
+        dists, idxs = self._knn(src_tree, self.mCoords, k, mesh_order=True)
         if k == 1:
             dists = dists[:, None]
             idxs  = idxs[:, None]
@@ -0,0 +1,153 @@
+"""
+Garbage collector policy for coupling steps.
+
+The cyclic garbage collector runs whenever allocation counts cross its
+thresholds, which in a coupled run means at arbitrary points inside steps and
+transfers. A full collection walks every tracked object of the interpreter,
+so those pauses show up directly in step times. This module keeps them out of
+the sections marked with @paused:
+
+- 'default': the interpreter's own behaviour (nothing is changed);
+- 'disable': automatic collection is off inside paused sections; garbage
+  accumulates until collect() at a quiet point chosen by the host, or the
+  first automatic collection after the section;
+- 'freeze':  objects that exist when a section starts are moved to the
+  permanent generation for its duration, so collections inside it only scan
+  what the section allocated.
+
+Pause statistics are gathered through gc.callbacks in every mode.
+"""
+
+import gc
+import threading
+import time
+from functools import wraps
+
+MODES = ('default', 'disable', 'freeze')
+
+_lock = threading.Lock()
+_mode = 'default'
+_depth = 0           # paused sections currently running (all threads)
+_was_enabled = True  # gc state restored when the outermost section exits
+_explicit = False    # inside collect()
+_started = None
+
+
+def _new_stats():
+    return {'collections': 0, 'explicit': 0, 'in_step': 0, 'collected': 0,
+            'total_pause': 0.0, 'max_pause': 0.0}
+
+
+_stats = _new_stats()
+
+
+def _on_gc(phase, info):
+    global _started
+    if phase == 'start':
+        _started = time.perf_counter()
+        return
+    if _started is None:
+        return
+    pause = time.perf_counter() - _started
+    _started = None
+    _stats['explicit' if _explicit else 'collections'] += 1
+    if _depth and not _explicit:
+        _stats['in_step'] += 1
+    _stats['collected'] += info.get('collected', 0)
+    _stats['total_pause'] += pause
+    _stats['max_pause'] = max(_stats['max_pause'], pause)
+
+
+def set_mode(mode):
+    """
+    Select how collection is handled inside paused sections.
+
+    :param mode: one of MODES
+    """
+    global _mode
+    if mode not in MODES:
+        raise ValueError(f"GC mode must be one of {MODES}, got {mode!r}")
+    with _lock:
+        if _depth:
+            raise RuntimeError("cannot change the GC policy while a step is running")
+        _mode = mode
+
+
+def get_mode():
+    return _mode
+
+
+def _enter():
+    global _depth, _was_enabled
+    with _lock:
+        _depth += 1
+        if _depth > 1:
+            return
+        if _mode == 'disable':
+            _was_enabled = gc.isenabled()
+            gc.disable()
+        elif _mode == 'freeze':
+            gc.freeze()
+
+
+def _exit():
+    global _depth
+    with _lock:
+        _depth -= 1
+        if _depth:
+            return
+        if _mode == 'disable':
+            if _was_enabled:
+                gc.enable()
+        elif _mode == 'freeze':
+            gc.unfreeze()
+
+
+def paused(func):
+    """Run *func* as a section in which the GC policy applies."""
+    @wraps(func)
+    def wrapper(*args, **kwargs):
+        _enter()
+        try:
+            return func(*args, **kwargs)
+        finally:
+            _exit()
+    return wrapper
+
+
+def collect(generation=2):
+    """
+    Collect garbage now, at a point the host knows to be quiet.
+
+    :param generation: oldest generation to collect (0-2)
+    :return: number of unreachable objects found
+    """
+    global _explicit
+    _explicit = True
+    try:
+        return gc.collect(generation)
+    finally:
+        _explicit = False
+
+
+def stats():
+    """
+    Return collection counters.
+
+    :return: dict with 'collections' (automatic), 'explicit' (collect()),
+             'in_step' (automatic collections inside paused sections),
+             'collected' objects, and 'total_pause' and 'max_pause' in seconds
+             over both kinds, plus the current 'mode'
+    """
+    out = dict(_stats)
+    out['mode'] = _mode
+    return out
+
+
+def reset_stats():
+    global _stats
+    _stats = _new_stats()
+
+
+if _on_gc not in gc.callbacks:
+    gc.callbacks.append(_on_gc)
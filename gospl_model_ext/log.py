@@ -0,0 +1,109 @@
+"""
+Log records of the extension, routed to the native logger when available.
+
+Under the C++ interface (libgospl_extensions) records go to its buffered
+logger, which applies level and per-rank filtering, queues them in an
+in-memory ring and writes them from a background thread. The library can also
+route sys.stdout and sys.stderr through it, so prints from goSPL itself stop
+hitting the console line by line. Used from plain Python, records are printed.
+
+Records carry a source (the API call or method) and a message, followed by
+key=value fields:
+
+    log.info('runProcessesForDt', 'step done', dt=1000.0, t=5000.0)
+"""
+
+import sys
+
+ERROR, WARN, INFO, DEBUG = 0, 1, 2, 3
+_NAMES = ('ERROR', 'WARN', 'INFO', 'DEBUG')
+
+# Set by libgospl_extensions on initialization: emit(level, source, text).
+_native_emit = None
+
+# Most verbose level emitted; kept in sync with the native logger.
+level = INFO
+
+_saved_streams = None
+
+
+def _field(value):
+    if isinstance(value, float):
+        return repr(value)
+    text = str(value)
+    return f'"{text}"' if not text or ' ' in text or '=' in text else text
+
+
+def emit(lvl, source, message, **fields):
+    """Emit a record at level *lvl* (ERROR ... DEBUG)."""
+    if lvl > level:
+        return
+    text = str(message)
+    if fields:
+        text = ' '.join([text] + [f"{k}={_field(v)}" for k, v in fields.items()])
+    if _native_emit is not None:
+        _native_emit(lvl, str(source), text)
+    else:
+        print(f"{_NAMES[lvl]} {source}: {text}")
+
+
+def error(source, message, **fields):
+    emit(ERROR, source, message, **fields)
+
+
+def warn(source, message, **fields):
+    emit(WARN, source, message, **fields)
+
+
+def info(source, message, **fields):
+    emit(INFO, source, message, **fields)
+
+
+def debug(source, message, **fields):
+    emit(DEBUG, source, message, **fields)
+
+
+class _Stream:
+    """File-like object turning written lines into records."""
+
+    def __init__(self, lvl, source, original):
+        self._level = lvl
+        self._source = source
+        self._original = original
+        self._partial = ''
+
+    def write(self, text):
+        lines = (self._partial + text).split('\n')
+        self._partial = lines.pop()
+        for line in lines:
+            if line.strip():
+                emit(self._level, self._source, line)
+        return len(text)
+
+    def flush(self):
+        pass
+
+    def isatty(self):
+        return False
+
+    def __getattr__(self, name):
+        return getattr(self._original, name)
+
+
+def route_prints(enabled=True):
+    """
+    Send sys.stdout (INFO) and sys.stderr (ERROR) through the native logger.
+
+    :param enabled: False restores the original streams
+    """
+    global _saved_streams
+    if enabled and _saved_streams is None and _native_emit is not None:
+        _saved_streams = (sys.stdout, sys.stderr)
+        sys.stdout = _Stream(INFO, 'stdout', sys.stdout)
+        sys.stderr = _Stream(ERROR, 'stderr', sys.stderr)
+    elif not enabled and _saved_streams is not None:
+        for stream in (sys.stdout, sys.stderr):
+            if isinstance(stream, _Stream) and stream._partial.strip():
+                emit(stream._level, stream._source, stream._partial)
+        sys.stdout, sys.stderr = _saved_streams
+        _saved_streams = None
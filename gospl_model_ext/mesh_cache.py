@@ -0,0 +1,190 @@
+"""
+Memory-mappable on-disk cache for derived mesh structures.
+
+Derived structures (the mesh KD-tree or cube-sphere index) are identical on every run
+with the same mesh, so they are written once to ``GOSPL_MESH_CACHE_DIR`` and
+memory-mapped by later model creations instead of being rebuilt. Caching is
+off when the variable is unset.
+
+File layout: an 8-byte magic, little-endian u64 pickle length and buffer
+count, a (offset, nbytes) u64 pair per buffer, the pickle itself and then the
+out-of-band pickle buffers, each 64-byte aligned. Loading maps the file and
+hands the buffers to pickle without copying them.
+
+A cache file is only loaded when it and its directory are owned by the
+current user (or root) and writable by no one else, and its pickle may only
+reference the index classes and numpy globals in _LOADABLE.
+"""
+
+import hashlib
+import io
+import os
+import pickle
+import stat
+import struct
+import tempfile
+
+import numpy as np
+
+from . import log
+
+CACHE_VERSION = 1
+
+_MAGIC = b'GOSPLMC1'
+_U64 = struct.Struct('<Q')
+_ALIGN = 64
+
+# Globals a cache file may reference.
+_LOADABLE = frozenset((
+    ('scipy.spatial._ckdtree', 'cKDTree'),
+    ('gospl_model_ext.sphere_index', 'CubeSphereIndex'),
+    ('numpy', 'ndarray'), ('numpy', 'dtype'),
+    ('numpy.core.multiarray', '_reconstruct'), ('numpy.core.multiarray', 'scalar'),
+    ('numpy._core.multiarray', '_reconstruct'), ('numpy._core.multiarray', 'scalar'),
+    ('numpy.core.numeric', '_frombuffer'), ('numpy._core.numeric', '_frombuffer'),
+))
+
+
+def cache_dir():
+    """Return the cache directory, or None when caching is disabled."""
+    return os.environ.get('GOSPL_MESH_CACHE_DIR') or None
+
+
+def cache_key(fingerprint, **options):
+    """Combine a mesh fingerprint and the options a structure depends on."""
+    h = hashlib.blake2b(digest_size=16)
+    h.update(f"v{CACHE_VERSION}:{fingerprint}".encode())
+    for name in sorted(options):
+        h.update(f";{name}={options[name]!r}".encode())
+    return h.hexdigest()
+
+
+def _aligned(n):
+    return (n + _ALIGN - 1) // _ALIGN * _ALIGN
+
+
+def save(path, obj):
+    """Write *obj* atomically in the memory-mappable cache format."""
+    buffers = []
+    meta = pickle.dumps(obj, protocol=5, buffer_callback=buffers.append)
+    raws = [b.raw() for b in buffers]
+
+    offset = _aligned(len(_MAGIC) + _U64.size * (2 + 2 * len(raws)) + len(meta))
+    layout = []
+    for r in raws:
+        layout.append((offset, r.nbytes))
+        offset = _aligned(offset + r.nbytes)
+
+    directory = os.path.dirname(os.path.abspath(path))
+    fd, tmp = tempfile.mkstemp(dir=directory, prefix='.tmp-')
+    try:
+        with os.fdopen(fd, 'wb') as f:
+            f.write(_MAGIC)
+            f.write(_U64.pack(len(meta)))
+            f.write(_U64.pack(len(raws)))
+            for off, n in layout:
+                f.write(_U64.pack(off))
+                f.write(_U64.pack(n))
+            f.write(meta)
+            for (off, _), r in zip(layout, raws):
+                f.seek(off)
+                f.write(r)
+            f.truncate(offset)
+        os.chmod(tmp, 0o644)
+        os.replace(tmp, path)
+    except BaseException:
+        if os.path.exists(tmp):
+            os.unlink(tmp)
+        raise
+
+
+class _Unpickler(pickle.Unpickler):
+    """Unpickler that only loads the globals in _LOADABLE."""
+
+    def find_class(self, module, name):
+        if (module, name) not in _LOADABLE:
+            raise pickle.UnpicklingError(f"global {module}.{name} is not allowed")
+        return super().find_class(module, name)
+
+
+def _check_trusted(st, what, path):
+    """Raise ValueError unless *st* is owned by us (or root) and not writable by others."""
+    if st.st_uid not in (os.geteuid(), 0):
+        raise ValueError(f"{what} {path} is owned by uid {st.st_uid}")
+    if st.st_mode & (stat.S_IWGRP | stat.S_IWOTH) and not (
+            stat.S_ISDIR(st.st_mode) and st.st_mode & stat.S_ISVTX):
+        raise ValueError(f"{what} {path} is writable by other users")
+
+
+def load(path):
+    """Map a cache file and rebuild its object on top of the mapping."""
+    directory = os.path.dirname(os.path.abspath(path))
+    _check_trusted(os.stat(directory), "cache directory", directory)
+    with open(path, 'rb') as f:
+        st = os.fstat(f.fileno())
+        _check_trusted(st, "cache file", path)
+        data = np.memmap(f, dtype=np.uint8, mode='r')
+
+    def u64(pos):
+        return _U64.unpack(bytes(data[pos:pos + _U64.size]))[0]
+
+    if bytes(data[:len(_MAGIC)]) != _MAGIC:
+        raise ValueError(f"{path} is not a mesh cache file")
+    pos = len(_MAGIC)
+    meta_len, nbuf = u64(pos), u64(pos + _U64.size)
+    pos += 2 * _U64.size
+    buffers = []
+    for _ in range(nbuf):
+        off, n = u64(pos), u64(pos + _U64.size)
+        pos += 2 * _U64.size
+        if off + n > data.shape[0]:
+            raise ValueError(f"{path} is truncated")
+        buffers.append(memoryview(data[off:off + n]))
+    meta = bytes(data[pos:pos + meta_len])
+    return _Unpickler(io.BytesIO(meta), buffers=buffers).load()
+
+
+def cached_tree(coords, fingerprint=None, leafsize=10, spherical=False):
+    """
+    Return a nearest-neighbour index over *coords*, mapped from the cache
+    when possible.
+
+    :param coords:      (M, 3) mesh coordinates
+    :param fingerprint: mesh fingerprint if already known
+    :param leafsize:    cKDTree leaf size
+    :param spherical:   build a CubeSphereIndex instead of a cKDTree
+    """
+    from scipy.spatial import cKDTree
+
+    def build():
+        if spherical:
+            from .sphere_index import CubeSphereIndex
+            return CubeSphereIndex(coords)
+        return cKDTree(coords, leafsize=leafsize)
+
+    directory = cache_dir()
+    if directory is None:
+        return build()
+
+    if fingerprint is None:
+        from .mesh_store import mesh_fingerprint
+        fingerprint = mesh_fingerprint(coords)
+    if spherical:
+        name = f"sphere-{cache_key(fingerprint)}.bin"
+    else:
+        name = f"kdtree-{cache_key(fingerprint, leafsize=leafsize)}.bin"
+    path = os.path.join(directory, name)
+    try:
+        tree = load(path)
+        if tree.n == coords.shape[0] and tree.m == coords.shape[1]:
+            return tree
+    except (OSError, ValueError, EOFError, pickle.UnpicklingError):
+        pass
+
+    tree = build()
+    try:
+        os.makedirs(directory, exist_ok=True)
+        save(path, tree)
+    except OSError as e:
+        log.warn('mesh_cache', f"could not write cache: {e}", path=path)
+    return tree
@@ -0,0 +1,77 @@
+"""
+Process-wide store of read-only mesh data shared across EnhancedModel handles.
+
+Several models on the same mesh (A/B comparisons, forcing scenarios) would
+otherwise each hold their own copy of the mesh coordinates and their own
+KD-tree. Entries are keyed by a fingerprint of the coordinates and reference
+counted, so memory scales with the number of distinct meshes.
+"""
+
+import hashlib
+import threading
+
+import numpy as np
+
+_entries = {}
+_lock = threading.Lock()
+
+
+def mesh_fingerprint(coords):
+    """Return a hex digest identifying a coordinate array."""
+    coords = np.ascontiguousarray(coords, dtype=np.float64)
+    h = hashlib.blake2b(digest_size=16)
+    h.update(str(coords.shape).encode())
+    h.update(coords.data)
+    return h.hexdigest()
+
+
+def acquire(coords):
+    """
+    Register a reference to the mesh with these coordinates.
+
+    :param coords: (M, 3) mesh coordinates
+    :return: (fingerprint, shared read-only coordinate array)
+    """
+    fp = mesh_fingerprint(coords)
+    with _lock:
+        entry = _entries.get(fp)
+        if entry is None:
+            shared = np.array(coords, dtype=np.float64, order='C')
+            shared.setflags(write=False)
+            entry = {'coords': shared, 'trees': {}, 'refs': 0}
+            _entries[fp] = entry
+        entry['refs'] += 1
+        return fp, entry['coords']
+
+
+def release(fp):
+    """Drop one reference; the entry is freed with its last reference."""
+    with _lock:
+        entry = _entries.get(fp)
+        if entry is None:
+            return
+        entry['refs'] -= 1
+        if entry['refs'] <= 0:
+            del _entries[fp]
+
+
+def get_tree(fp, spherical=False):
+    """
+    Return the shared neighbour index of a registered mesh, building it once.
+
+    :param spherical: CubeSphereIndex instead of cKDTree (global meshes)
+    """
+    with _lock:
+        entry = _entries[fp]
+        tree = entry['trees'].get(spherical)
+        if tree is None:
+            from .mesh_cache import cached_tree
+            tree = cached_tree(entry['coords'], fingerprint=fp, spherical=spherical)
+            entry['trees'][spherical] = tree
+        return tree
+
+
+def stats():
+    """Return {fingerprint: reference count} for the registered meshes."""
+    with _lock:
+        return {fp: entry['refs'] for fp, entry in _entries.items()}
@@ -0,0 +1,495 @@
+"""
+Warm model server shared by successive host jobs.
+
+Starting Python, goSPL and PETSc and loading the mesh dominates the runtime of
+short coupled jobs. This module keeps a pool of pre-initialized EnhancedModel
+instances per (config, mesh) fingerprint in a long-lived daemon reachable over
+a UNIX domain socket. A job leases a warm instance, drives it through a
+proxy, and hands it back on release, when the full model state is restored
+to the snapshot taken after initialization. Each lease writes goSPL output to
+its own directory next to the configured one.
+
+Messages are length-prefixed pickles; numpy arrays above a size threshold
+travel through multiprocessing.shared_memory instead of the socket. The
+server only unpickles plain values and numpy arrays from clients, and only
+the model methods and attributes in REMOTE_METHODS / REMOTE_ATTRIBUTES are
+reachable through a lease.
+
+Run the daemon with::
+
+    python -m gospl_model_ext.model_server --socket /tmp/gospl.sock \\
+        --config input.yml --pool 2
+
+and point the C interface at it with ``GOSPL_MODEL_SERVER=/tmp/gospl.sock``.
+"""
+
+import argparse
+import hashlib
+import io
+import os
+import pickle
+import socket
+import socketserver
+import struct
+import threading
+from multiprocessing import shared_memory
+
+import numpy as np
+
+# Arrays at least this large (bytes) are passed through shared memory.
+SHM_THRESHOLD = 64 * 1024
+
+_HEADER = struct.Struct('!Q')
+
+# Model methods a lease may call: the coupling API used by the C interface.
+REMOTE_METHODS = frozenset((
+    'runProcessesForDt', 'runProcessesForSteps', 'runProcessesUntilTime',
+    'apply_velocity_data', 'apply_elevation_data', 'interpolate_elevation_to_points',
+    'get_committed_time', 'set_surface_velocity', 'accumulate_surface_velocity',
+    'set_uplift_rate', 'run_and_get_erosion', 'run_and_get_erosion_sparse',
+    'apply_drift_correction', 'set_transfer_tolerance', 'get_transfer_stats',
+    'declare_surface_points', 'set_surface_velocity_sparse', 'set_uplift_rate_sparse',
+    'enable_speculation', 'speculate_next_interval', 'cancel_speculation',
+    'get_speculation_stats', 'register_plate_ids', 'set_euler_poles',
+    'set_forcing_substeps', 'set_locality_ordering', 'set_active_set',
+    'get_active_set_stats', 'set_catchment_parallel', 'get_catchment_stats',
+    'set_incremental_depressions', 'get_depression_stats', 'get_output_stats',
+))
+
+# Model attributes a lease may read.
+REMOTE_ATTRIBUTES = frozenset(('tNow', 'tEnd', 'dt', 'outputDir', '_last_sparse_erosion'))
+
+# Globals a client message may reference: what numpy needs to rebuild arrays.
+_SAFE_GLOBALS = frozenset((
+    ('numpy', 'ndarray'), ('numpy', 'dtype'),
+    ('numpy.core.multiarray', '_reconstruct'), ('numpy.core.multiarray', 'scalar'),
+    ('numpy._core.multiarray', '_reconstruct'), ('numpy._core.multiarray', 'scalar'),
+    ('numpy.core.numeric', '_frombuffer'), ('numpy._core.numeric', '_frombuffer'),
+    ('builtins', 'complex'), ('builtins', 'slice'), ('builtins', 'frozenset'),
+    ('builtins', 'set'), ('builtins', 'range'),
+))
+
+
+def config_fingerprint(config_path):
+    """
+    Fingerprint a goSPL configuration together with the mesh it loads.
+
+    :param config_path: path to the goSPL YAML configuration
+    :return: hex digest covering the config bytes and the npdata mesh file
+    """
+    h = hashlib.blake2b(digest_size=16)
+    with open(config_path, 'rb') as f:
+        text = f.read()
+    h.update(text)
+
+    mesh_file = None
+    try:
+        import yaml
+        domain = (yaml.safe_load(text) or {}).get('domain', {})
+        npdata = domain.get('npdata')
+        if isinstance(npdata, (list, tuple)) and npdata:
+            mesh_file = str(npdata[0])
+    except Exception:
+        mesh_file = None
+    if mesh_file is not None:
+        base = os.path.dirname(os.path.abspath(config_path))
+        for candidate in (mesh_file + '.npz', mesh_file):
+            for root in ('', base):
+                path = os.path.join(root, candidate)
+                if os.path.isfile(path):
+                    with open(path, 'rb') as f:
+                        for chunk in iter(lambda: f.read(1 << 20), b''):
+                            h.update(chunk)
+                    return h.hexdigest()
+    return h.hexdigest()
+
+
+# ----------------------------------------------------------------------
+# Wire format
+# ----------------------------------------------------------------------
+
+class _Pickler(pickle.Pickler):
+    """
+    Pickler that moves large arrays into shared memory segments.
+
+    The names of the segments created are kept in *segments*; the sender
+    unlinks any the receiver did not consume (see _unlink_segments()).
+    """
+
+    def __init__(self, *args, **kwargs):
+        super().__init__(*args, **kwargs)
+        self.segments = []
+
+    def persistent_id(self, obj):
+        if (type(obj) is np.ndarray and obj.nbytes >= SHM_THRESHOLD
+                and not obj.dtype.hasobject):
+            shm = shared_memory.SharedMemory(create=True, size=obj.nbytes)
+            self.segments.append(shm.name)
+            np.ndarray(obj.shape, dtype=obj.dtype, buffer=shm.buf)[...] = obj
+            # The receiver unlinks the segment, or the sender does once the
+            # peer has replied or gone away; stop resource_tracker doing it too.
+            try:
+                from multiprocessing import resource_tracker
+                resource_tracker.unregister(shm._name, 'shared_memory')
+            except Exception:
+                pass
+            shm.close()
+            return ('shm', shm.name, obj.shape, obj.dtype.str)
+        return None
+
+
+class _Unpickler(pickle.Unpickler):
+    """
+    Unpickler that copies shared memory arrays out and unlinks them.
+
+    With *restricted*, only the globals in _SAFE_GLOBALS can be loaded, so a
+    client message cannot name arbitrary callables.
+    """
+
+    def __init__(self, file, restricted=False):
+        super().__init__(file)
+        self.restricted = restricted
+
+    def find_class(self, module, name):
+        if self.restricted and (module, name) not in _SAFE_GLOBALS:
+            raise pickle.UnpicklingError(f"global {module}.{name} is not allowed")
+        return super().find_class(module, name)
+
+    def persistent_load(self, pid):
+        kind, name, shape, dtype = pid
+        if kind != 'shm':
+            raise pickle.UnpicklingError(f"unknown persistent id {kind!r}")
+        shm = shared_memory.SharedMemory(name=name)
+        try:
+            return np.ndarray(shape, dtype=np.dtype(dtype), buffer=shm.buf).copy()
+        finally:
+            shm.close()
+            shm.unlink()
+
+
+def _unlink_segments(names):
+    """Unlink shared memory segments; ones the receiver consumed are gone."""
+    for name in names:
+        try:
+            shm = shared_memory.SharedMemory(name=name)
+        except FileNotFoundError:
+            continue
+        shm.close()
+        try:
+            shm.unlink()
+        except FileNotFoundError:
+            pass
+
+
+def send_message(sock, obj):
+    """
+    Send one length-prefixed message.
+
+    :return: names of the shared memory segments it references; pass them to
+             _unlink_segments() after the peer's reply, or when the peer is gone
+    """
+    buf = io.BytesIO()
+    pickler = _Pickler(buf, protocol=pickle.HIGHEST_PROTOCOL)
+    try:
+        pickler.dump(obj)
+        payload = buf.getvalue()
+        sock.sendall(_HEADER.pack(len(payload)) + payload)
+    except BaseException:
+        _unlink_segments(pickler.segments)
+        raise
+    return pickler.segments
+
+
+def _recv_exact(sock, n):
+    chunks = []
+    while n > 0:
+        chunk = sock.recv(min(n, 1 << 20))
+        if not chunk:
+            raise ConnectionError("connection closed by peer")
+        chunks.append(chunk)
+        n -= len(chunk)
+    return b''.join(chunks)
+
+
+def recv_message(sock, restricted=False):
+    """Receive one length-prefixed message (see _Unpickler for *restricted*)."""
+    (size,) = _HEADER.unpack(_recv_exact(sock, _HEADER.size))
+    return _Unpickler(io.BytesIO(_recv_exact(sock, size)), restricted=restricted).load()
+
+
+# ----------------------------------------------------------------------
+# Server
+# ----------------------------------------------------------------------
+
+def _default_factory(config_path):
+    from gospl_model_ext import EnhancedModel
+    from gospl_tectonics_ext import DataDrivenTectonics
+    model = EnhancedModel(config_path)
+    model.apply_velocity_data = DataDrivenTectonics.apply_velocity_data.__get__(
+        model, type(model))
+    model.share_mesh_data()
+    return model
+
+
+class ModelServer:
+    """
+    Pool of warm EnhancedModel instances keyed by config fingerprint.
+
+    :param socket_path: UNIX socket to listen on
+    :param pool_size:   idle instances kept ready per fingerprint
+    :param factory:     callable(config_path) creating a model
+                        (default: EnhancedModel with apply_velocity_data bound)
+    """
+
+    def __init__(self, socket_path, pool_size=1, factory=None):
+        self.socket_path = socket_path
+        self.pool_size   = max(0, int(pool_size))
+        self.factory     = factory or _default_factory
+        self._pools = {}          # fingerprint -> [(model, snapshot), ...]
+        self._lock  = threading.Lock()
+        # goSPL/PETSc are not thread-safe; model calls from concurrent
+        # connections are serialized.
+        self._model_lock = threading.Lock()
+        self._warming = set()     # fingerprints with a refill in progress
+        self.stats = {'leases': 0, 'warm_hits': 0, 'cold_starts': 0}
+        self._server = None
+
+    # -- pool management -----------------------------------------------
+
+    def _create(self, config_path):
+        with self._model_lock:
+            model = self.factory(config_path)
+            snapshot = model._snapshot_state()
+        return model, snapshot
+
+    def prewarm(self, config_path, count=None):
+        """Create idle instances for *config_path* until the pool is full."""
+        fp = config_fingerprint(config_path)
+        target = self.pool_size if count is None else int(count)
+        while True:
+            with self._lock:
+                if len(self._pools.setdefault(fp, [])) >= target:
+                    return
+            entry = self._create(config_path)
+            with self._lock:
+                self._pools[fp].append(entry)
+
+    def lease(self, config_path):
+        """Take a warm instance (or create one) reset to its initial state."""
+        fp = config_fingerprint(config_path)
+        with self._lock:
+            self.stats['leases'] += 1
+            lease_id = self.stats['leases']
+            pool = self._pools.setdefault(fp, [])
+            entry = pool.pop() if pool else None
+            if entry is not None:
+                self.stats['warm_hits'] += 1
+            else:
+                self.stats['cold_starts'] += 1
+        if entry is None:
+            entry = self._create(config_path)
+        model, snapshot = entry
+        output_dir = snapshot['scalars'].get('outputDir')
+        if output_dir:
+            with self._model_lock:
+                model.set_output_dir(f"{output_dir}_lease{os.getpid()}-{lease_id}")
+        self._refill(fp, config_path)
+        return fp, entry
+
+    def _refill(self, fp, config_path):
+        """Top the pool back up in the background."""
+        with self._lock:
+            if self.pool_size == 0 or fp in self._warming:
+                return
+            self._warming.add(fp)
+
+        def run():
+            try:
+                self.prewarm(config_path)
+            finally:
+                with self._lock:
+                    self._warming.discard(fp)
+
+        threading.Thread(target=run, daemon=True).start()
+
+    def release(self, fp, entry):
+        """Restore an instance to its initial state and return it to the pool."""
+        model, snapshot = entry
+        with self._model_lock:
+            model.reset_coupling_state()
+            model._restore_state(snapshot)
+        with self._lock:
+            pool = self._pools.setdefault(fp, [])
+            if len(pool) < max(self.pool_size, 1):
+                pool.append(entry)
+
+    # -- request handling ------------------------------------------------
+
+    def _leased_model(self, lease):
+        if lease is None:
+            raise RuntimeError("connection holds no lease")
+        return lease[1][0]
+
+    def _handle_connection(self, sock):
+        lease = None
+        sent = []         # segments of the last reply, until the client answers
+        try:
+            while True:
+                try:
+                    request = recv_message(sock, restricted=True)
+                except ConnectionError:
+                    return
+                except pickle.UnpicklingError as e:
+                    request = ('invalid', e)
+                finally:
+                    _unlink_segments(sent)
+                op = request[0]
+                try:
+                    if op == 'lease':
+                        if lease is not None:
+                            raise RuntimeError("connection already holds a lease")
+                        lease = self.lease(request[1])
+                        reply = ('ok', lease[0])
+                    elif op == 'getattr':
+                        name = request[1]
+                        if name in REMOTE_METHODS:
+                            reply = ('ok', ('callable', None))
+                        elif name in REMOTE_ATTRIBUTES:
+                            with self._model_lock:
+                                value = getattr(self._leased_model(lease), name)
+                            reply = ('ok', ('value', value))
+                        else:
+                            raise AttributeError(f"{name!r} is not available on a leased model")
+                    elif op == 'call':
+                        _, name, args, kwargs = request
+                        if name not in REMOTE_METHODS:
+                            raise AttributeError(f"{name!r} cannot be called on a leased model")
+                        with self._model_lock:
+                            result = getattr(self._leased_model(lease), name)(*args, **kwargs)
+                        reply = ('ok', result)
+                    elif op == 'invalid':
+                        raise request[1]
+                    elif op == 'stats':
+                        with self._lock:
+                            reply = ('ok', dict(self.stats))
+                    else:
+                        raise ValueError(f"unknown request {op!r}")
+                except Exception as e:
+                    reply = ('error', e)
+                try:
+                    sent = send_message(sock, reply)
+                except (pickle.PicklingError, TypeError, AttributeError) as e:
+                    sent = send_message(sock, ('error', RuntimeError(f"unpicklable reply: {e}")))
+        finally:
+            _unlink_segments(sent)
+            if lease is not None:
+                self.release(*lease)
+
+    def serve_forever(self):
+        """Listen on the UNIX socket and serve leases until shutdown()."""
+        if os.path.exists(self.socket_path):
+            os.unlink(self.socket_path)
+        server = self
+
+        class Handler(socketserver.BaseRequestHandler):
+            def handle(self):
+                server._handle_connection(self.request)
+
+        class Server(socketserver.ThreadingMixIn, socketserver.UnixStreamServer):
+            daemon_threads = True
+
+        self._server = Server(self.socket_path, Handler)
+        try:
+            self._server.serve_forever()
+        finally:
+            self._server.server_close()
+            if os.path.exists(self.socket_path):
+                os.unlink(self.socket_path)
+
+    def shutdown(self):
+        """Stop serve_forever() from another thread."""
+        if self._server is not None:
+            self._server.shutdown()
+
+
+# ----------------------------------------------------------------------
+# Client
+# ----------------------------------------------------------------------
+
+class RemoteModel:
+    """
+    Proxy for a leased server-side model.
+
+    Method calls and attribute reads are forwarded over the socket; the lease
+    ends (and the instance goes back to the pool) on destroy().
+    """
+
+    def __init__(self, socket_path, config_path):
+        object.__setattr__(self, '_methods', set())
+        object.__setattr__(self, '_sock', None)
+        sock = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+        sock.connect(socket_path)
+        object.__setattr__(self, '_sock', sock)
+        object.__setattr__(self, 'fingerprint', self._request('lease', config_path))
+
+    def _request(self, *request):
+        sent = send_message(self._sock, request)
+        try:
+            status, payload = recv_message(self._sock)
+        finally:
+            _unlink_segments(sent)
+        if status == 'error':
+            raise payload
+        return payload
+
+    def __getattr__(self, name):
+        if name.startswith('__'):
+            raise AttributeError(name)
+        if name not in self._methods:
+            kind, value = self._request('getattr', name)
+            if kind == 'value':
+                return value
+            self._methods.add(name)
+        return lambda *args, **kwargs: self._request('call', name, args, kwargs)
+
+    def __setattr__(self, name, value):
+        raise AttributeError("attributes of a remote model cannot be set")
+
+    def server_stats(self):
+        """Return the server's lease counters."""
+        return self._request('stats')
+
+    def destroy(self):
+        """End the lease."""
+        if self._sock is not None:
+            self._sock.close()
+            object.__setattr__(self, '_sock', None)
+
+
+def lease(socket_path, config_path):
+    """Lease a warm model from the server at *socket_path*."""
+    return RemoteModel(socket_path, config_path)
+
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(description="Warm goSPL model server")
+    parser.add_argument('--socket', required=True, help="UNIX socket path")
+    parser.add_argument('--config', action='append', default=[],
+                        help="config to prewarm (repeatable)")
+    parser.add_argument('--pool', type=int, default=1,
+                        help="idle instances kept per config (default 1)")
+    args = parser.parse_args(argv)
+
+    server = ModelServer(args.socket, pool_size=args.pool)
+    for config in args.config:
+        server.prewarm(config)
+        print(f"Prewarmed {args.pool} instance(s) of {config}")
+    print(f"Serving on {args.socket}")
+    try:
+        server.serve_forever()
+    except KeyboardInterrupt:
+        pass
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,49 @@
+"""
+Space-filling-curve orderings used to improve memory locality.
+
+Neighbour searches over points that are spatially scattered in memory walk
+the KD-tree and the gathered arrays in random order. Processing the points in
+Morton (Z-order) order keeps consecutive queries in the same tree leaves and
+the same cache lines.
+"""
+
+import numpy as np
+
+_BITS = 21  # 3 x 21 bits fit a uint64 code
+
+
+def _spread_bits(x):
+    """Insert two zero bits between each of the low 21 bits of x."""
+    x = x & np.uint64(0x1fffff)
+    x = (x | (x << np.uint64(32))) & np.uint64(0x1f00000000ffff)
+    x = (x | (x << np.uint64(16))) & np.uint64(0x1f0000ff0000ff)
+    x = (x | (x << np.uint64(8)))  & np.uint64(0x100f00f00f00f00f)
+    x = (x | (x << np.uint64(4)))  & np.uint64(0x10c30c30c30c30c3)
+    x = (x | (x << np.uint64(2)))  & np.uint64(0x1249249249249249)
+    return x
+
+
+def morton_codes(points):
+    """
+    Return 63-bit Morton codes of 3-D points over their bounding box.
+
+    :param points: (N, 3) coordinates
+    :return:       (N,) uint64 codes
+    """
+    points = np.asarray(points, dtype=np.float64)
+    lo = points.min(axis=0)
+    span = np.maximum(points.max(axis=0) - lo, np.finfo(np.float64).tiny)
+    grid = ((points - lo) / span * ((1 << _BITS) - 1)).astype(np.uint64)
+    return (_spread_bits(grid[:, 0])
+            | (_spread_bits(grid[:, 1]) << np.uint64(1))
+            | (_spread_bits(grid[:, 2]) << np.uint64(2)))
+
+
+def morton_order(points):
+    """
+    Return the permutation that sorts *points* along a Morton curve.
+
+    :param points: (N, 3) coordinates
+    :return:       (N,) int64 permutation
+    """
+    return np.argsort(morton_codes(points), kind='stable')
@@ -0,0 +1,222 @@
+"""
+Cube-sphere bucket index for nearest-neighbour searches on global meshes.
+
+On global (non-flatModel) goSPL meshes every node lies on a sphere, so a 3-D
+KD-tree spends most of its splits on empty space. This index projects points
+onto the six faces of a cube with an equi-angular grid (buckets of nearly
+equal area) and stores them bucket by bucket. A k-nearest query scans the
+query's bucket and the buckets within a guaranteed search radius of it, using
+chord distance between directions. The rare query whose k-th neighbour lies
+beyond that radius is answered exactly by a cKDTree over the same unit
+vectors, built on first need.
+
+The scan runs in the native kernel installed by the C++ interface
+(libgospl_extensions), multithreaded with the GIL released. Without it a
+vectorized numpy kernel gives the same results, but slower than cKDTree, so
+models only pick this index when available() is true.
+"""
+
+import os
+
+import numpy as np
+
+# Set by libgospl_extensions on initialization:
+# knn(points, ids, bucket_start, nbr_start, nbrs, queries, query_bucket,
+#     k, workers) -> (chord distances, indices), each (M, k).
+_native_knn = None
+
+# Queries per chunk of the numpy kernel (bounds the candidate gather).
+_CHUNK = 8192
+
+
+def available():
+    """True when the native query kernel is installed."""
+    return _native_knn is not None
+
+
+def _unit(points):
+    points = np.asarray(points, dtype=np.float64)
+    norm = np.linalg.norm(points, axis=1, keepdims=True)
+    return points / np.maximum(norm, np.finfo(np.float64).tiny)
+
+
+def _face_coords(unit):
+    """Return (face, a, b): cube face 0-5 and equi-angular coords in [-1, 1]."""
+    absu = np.abs(unit)
+    axis = np.argmax(absu, axis=1)
+    rows = np.arange(unit.shape[0])
+    major = absu[rows, axis]
+    face = axis * 2 + (unit[rows, axis] < 0)
+    u = unit[rows, (axis + 1) % 3] / major
+    v = unit[rows, (axis + 2) % 3] / major
+    return face, np.arctan(u) * (4.0 / np.pi), np.arctan(v) * (4.0 / np.pi)
+
+
+def _face_to_unit(face, a, b):
+    """Inverse of _face_coords."""
+    axis = face // 2
+    out = np.empty((face.shape[0], 3))
+    rows = np.arange(face.shape[0])
+    out[rows, axis] = np.where(face % 2 == 1, -1.0, 1.0)
+    out[rows, (axis + 1) % 3] = np.tan(a * (np.pi / 4.0))
+    out[rows, (axis + 2) % 3] = np.tan(b * (np.pi / 4.0))
+    return _unit(out)
+
+
+class CubeSphereIndex:
+    """
+    k-nearest-neighbour index over points on a sphere.
+
+    Distances are chord lengths between point directions, scaled by the mean
+    radius of the indexed points; for points on that sphere they equal the
+    Euclidean distances a cKDTree would return.
+
+    :param points:            (N, 3) points on (or near) a sphere centred at 0
+    :param points_per_bucket: target mean bucket occupancy
+    :param workers:           query threads (default: os.cpu_count())
+    """
+
+    def __init__(self, points, points_per_bucket=8, workers=None):
+        points = np.asarray(points, dtype=np.float64)
+        self.n = points.shape[0]
+        self.m = 3
+        if self.n == 0:
+            raise ValueError("cannot index an empty point set")
+        self.radius = float(np.mean(np.linalg.norm(points, axis=1)))
+        self.workers = workers
+        self.resolution = max(1, int(np.sqrt(self.n / (6.0 * max(1, points_per_bucket)))))
+        self.stats = {'queries': 0, 'fallbacks': 0}
+        self._fallback_tree = None
+        self._padded = None
+
+        # Points stored bucket by bucket (CSR), so a bucket scan is contiguous.
+        unit = _unit(points)
+        bucket = self._bucket_of(unit)
+        nbuckets = 6 * self.resolution ** 2
+        order = np.argsort(bucket, kind='stable')
+        self._ids = order.astype(np.int64)
+        self._points = np.ascontiguousarray(unit[order])
+        self._bucket_start = np.zeros(nbuckets + 1, dtype=np.int64)
+        np.cumsum(np.bincount(bucket, minlength=nbuckets), out=self._bucket_start[1:])
+        self._build_neighbours()
+
+    def _bucket_of(self, unit):
+        res = self.resolution
+        face, a, b = _face_coords(unit)
+        i = np.clip(((a + 1.0) * 0.5 * res).astype(np.int64), 0, res - 1)
+        j = np.clip(((b + 1.0) * 0.5 * res).astype(np.int64), 0, res - 1)
+        return (face * res + i) * res + j
+
+    def _build_neighbours(self):
+        """List, per bucket, every bucket that can hold a point within the
+        search radius of a query in that bucket."""
+        from scipy.spatial import cKDTree
+
+        res = self.resolution
+        edges = np.linspace(-1.0, 1.0, res + 1)
+        mids = 0.5 * (edges[:-1] + edges[1:])
+        face, i, j = (g.ravel() for g in np.meshgrid(
+            np.arange(6), np.arange(res), np.arange(res), indexing='ij'))
+        centres = _face_to_unit(face, mids[i], mids[j])
+        # Buckets are convex spherical quads, so a corner is the farthest point.
+        size = np.zeros(face.shape[0])
+        for di in (0, 1):
+            for dj in (0, 1):
+                corner = _face_to_unit(face, edges[i + di], edges[j + dj])
+                size = np.maximum(size, np.linalg.norm(corner - centres, axis=1))
+        size *= 1.0 + 1e-9
+
+        # About half a bucket width, which keeps the lists to the 3 x 3 block
+        # around each bucket (more near the cube corners).
+        self.search_radius = float(np.min(size)) / np.sqrt(2.0)
+        pairs = cKDTree(centres).query_pairs(2.0 * size.max() + self.search_radius,
+                                             output_type='ndarray')
+        c, d = pairs[:, 0], pairs[:, 1]
+        keep = (np.linalg.norm(centres[c] - centres[d], axis=1)
+                <= size[c] + size[d] + self.search_radius)
+        c, d = c[keep], d[keep]
+        every = np.arange(face.shape[0])
+        src = np.concatenate((every, c, d))
+        dst = np.concatenate((every, d, c))
+        order = np.lexsort((dst, src))
+        self._nbrs = dst[order].astype(np.int64)
+        self._nbr_start = np.zeros(face.shape[0] + 1, dtype=np.int64)
+        np.cumsum(np.bincount(src, minlength=face.shape[0]), out=self._nbr_start[1:])
+
+    # -- queries -------------------------------------------------------------
+
+    def _numpy_knn(self, q, qb, k):
+        """Reference kernel: padded candidate gather per chunk of queries."""
+        if self._padded is None:
+            counts = np.diff(self._bucket_start)
+            nb = counts.shape[0]
+            slots = np.full((nb + 1, max(1, counts.max())), self.n, dtype=np.int64)
+            owner = np.repeat(np.arange(nb), counts)
+            slots[owner, np.arange(self.n) - self._bucket_start[owner]] = np.arange(self.n)
+            lens = np.diff(self._nbr_start)
+            nbr = np.full((nb, lens.max()), nb, dtype=np.int64)
+            owner = np.repeat(np.arange(nb), lens)
+            nbr[owner, np.arange(owner.shape[0]) - self._nbr_start[owner]] = self._nbrs
+            # Row n is a sentinel farther than any real neighbour.
+            pts = np.vstack((self._points, np.full((1, 3), 10.0)))
+            self._padded = (slots, nbr, pts, np.append(self._ids, -1))
+        slots, nbr, pts, ids = self._padded
+
+        dists = np.empty((q.shape[0], k))
+        idxs = np.empty((q.shape[0], k), dtype=np.int64)
+        for lo in range(0, q.shape[0], _CHUNK):
+            hi = min(lo + _CHUNK, q.shape[0])
+            cand = slots[nbr[qb[lo:hi]]].reshape(hi - lo, -1)
+            diff = pts[cand] - q[lo:hi, None, :]
+            d2 = np.einsum('ijk,ijk->ij', diff, diff)
+            if k < cand.shape[1]:
+                part = np.argpartition(d2, k - 1, axis=1)[:, :k]
+            else:
+                part = np.broadcast_to(np.arange(k) % cand.shape[1], (hi - lo, k))
+            d2k = np.take_along_axis(d2, part, axis=1)
+            sort = np.argsort(d2k, axis=1, kind='stable')
+            dists[lo:hi] = np.sqrt(np.take_along_axis(d2k, sort, axis=1))
+            best = np.take_along_axis(np.take_along_axis(cand, part, axis=1), sort, axis=1)
+            idxs[lo:hi] = ids[best]
+        dists[idxs < 0] = np.inf
+        return dists, idxs
+
+    def query(self, pts, k=1):
+        """
+        Return the k nearest indexed points, like cKDTree.query.
+
+        :param pts: (M, 3) query coordinates
+        :param k:   number of neighbours
+        :return: (distances, indices), shaped (M,) for k == 1 else (M, k)
+        """
+        k = int(k)
+        if k < 1 or k > self.n:
+            raise ValueError(f"k must be between 1 and {self.n}")
+        q = np.ascontiguousarray(_unit(pts))
+        qb = self._bucket_of(q)
+        if _native_knn is not None:
+            dists, idxs = _native_knn(self._points, self._ids, self._bucket_start,
+                                      self._nbr_start, self._nbrs, q, qb, k,
+                                      max(1, int(self.workers or os.cpu_count() or 1)))
+        else:
+            dists, idxs = self._numpy_knn(q, qb, k)
+
+        # Exact answers where the k-th neighbour may lie beyond the scanned
+        # buckets.
+        miss = np.nonzero(~(dists[:, -1] <= self.search_radius))[0]
+        self.stats['queries'] += q.shape[0]
+        self.stats['fallbacks'] += int(miss.size)
+        if miss.size:
+            if self._fallback_tree is None:
+                from scipy.spatial import cKDTree
+                unit = np.empty_like(self._points)
+                unit[self._ids] = self._points
+                self._fallback_tree = cKDTree(unit)
+            d, i = self._fallback_tree.query(q[miss], k=k)
+            dists[miss] = np.reshape(d, (-1, k))
+            idxs[miss] = np.reshape(i, (-1, k))
+
+        dists *= self.radius
+        if k == 1:
+            return dists[:, 0], idxs[:, 0]
+        return dists, idxs
@@ -9,6 +9,8 @@ DataDrivenTectonics.
 
 import sys
 import os
+import argparse
+import subprocess
 import traceback
 
 # Add the current directory to the path
@@ -118,6 +120,33 @@ def run_example_validation():
     return True
 
 
+def run_performance_tests(results_path, update_baseline=False):
+    """Run the performance tier (tests/test_performance.py) with timings checked."""
+    print("\nRunning performance regression tests...")
+    print("=" * 50)
+    
+    try:
+        import pytest  # noqa: F401
+    except ImportError:
+        print("✗ pytest is required for the performance tests")
+        return False
+    
+    env = dict(os.environ, GOSPL_PERF_TIMING='1', GOSPL_PERF_RESULTS=os.path.abspath(results_path))
+    if update_baseline:
+        env['GOSPL_PERF_UPDATE'] = '1'
+    test_file = os.path.join(os.path.dirname(os.path.abspath(__file__)), 'tests', 'test_performance.py')
+    result = subprocess.run([sys.executable, '-m', 'pytest', test_file, '-q'], env=env)
+    
+    if update_baseline:
+        print("✓ Baseline updated: tests/perf_baseline.json")
+    print(f"Results written to {results_path}")
+    if result.returncode != 0:
+        print("✗ Performance regression against tests/perf_baseline.json")
+        return False
+    print("✓ Performance within baseline")
+    return True
+
+
 def check_environment():
     """Check if the gospl conda environment is activated."""
     print("Checking environment...")
@@ -181,11 +210,23 @@ def check_dependencies():
     return True
 
 
-def main():
+def main(argv=None):
     """Main test runner function."""
+    parser = argparse.ArgumentParser(description="gospl_extensions test runner")
+    parser.add_argument('--perf', action='store_true',
+                        help="run the performance regression tests only")
+    parser.add_argument('--perf-results', default='perf_results.json',
+                        help="JSON file for the performance measurements")
+    parser.add_argument('--update-baseline', action='store_true',
+                        help="with --perf, store the measurements as the new baseline")
+    args = parser.parse_args(argv)
+    
     print("gospl_extensions Test Runner")
     print("=" * 60)
     
+    if args.perf:
+        return 0 if run_performance_tests(args.perf_results, args.update_baseline) else 1
+    
     all_passed = True
     
     # Check environment first
@@ -0,0 +1,80 @@
+"""
+Shared fixtures and helpers for the test suite.
+
+A mock goSPL Model stands in for the real one, so EnhancedModel can be
+exercised on small synthetic meshes without goSPL or PETSc.
+"""
+
+import os
+import sys
+from unittest.mock import Mock, patch
+
+import numpy as np
+import pytest
+# Import before mock_gospl patches sys.modules so it is not reloaded per test.
+import scipy.spatial  # noqa: F401
+
+# Add the parent directory to the path so we can import our modules
+sys.path.insert(0, os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+
+
+class MockModel:
+    """Mock Model class to simulate goSPL Model behavior."""
+    
+    def __init__(self, *args, **kwargs):
+        self.tNow = 0.0
+        self.tEnd = 100000.0
+        self.dt = 1000.0
+        self.run_calls = []
+        
+    def runProcesses(self, *args, **kwargs):
+        """Mock runProcesses method."""
+        # Simulate time advancement
+        old_time = self.tNow
+        self.tNow += self.dt
+        self.run_calls.append({
+            'method': 'runProcesses',
+            'old_time': old_time,
+            'new_time': self.tNow,
+            'args': args,
+            'kwargs': kwargs
+        })
+
+class MockVec:
+    """Minimal stand-in for a PETSc Vec exposing getArray()."""
+
+    def __init__(self, values):
+        self._values = np.asarray(values, dtype=np.float64)
+
+    def getArray(self):
+        return self._values
+
+
+def make_mesh_model(EnhancedModel, n=10, spacing=100.0):
+    """Create an EnhancedModel on a synthetic flat n x n mesh."""
+    model = EnhancedModel("test_config.yml")
+    xs, ys = np.meshgrid(np.arange(n) * spacing, np.arange(n) * spacing)
+    npts = n * n
+    model.mCoords = np.column_stack((xs.ravel(), ys.ravel(), np.zeros(npts)))
+    model.locIDs = np.arange(npts)
+    model.glbIDs = np.arange(npts)
+    model.lpoints = npts
+    model.hGlobal = MockVec(np.zeros(npts))
+    model.hLocal = MockVec(np.zeros(npts))
+    model.advscheme = 0
+    model.tecdata = None
+    return model
+
+@pytest.fixture
+def mock_gospl():
+    """Create mock goSPL environment."""
+    mock_gospl = Mock()
+    mock_model = Mock()
+    mock_model.Model = MockModel
+    mock_gospl.model = mock_model
+    
+    with patch.dict('sys.modules', {
+        'gospl': mock_gospl,
+        'gospl.model': mock_model
+    }):
+        yield mock_gospl
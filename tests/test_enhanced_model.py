@@ -8,12 +8,15 @@ a full goSPL installation by using mock objects.
 import pytest
 import sys
 import os
+import numpy as np
 from unittest.mock import Mock, patch, MagicMock
 import time
 
 # Add the parent directory to the path so we can import our modules
 sys.path.insert(0, os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
 
+from tests.conftest import MockModel, MockVec, make_mesh_model  # noqa: E402
+
 def test_imports():
     """Test that we can import the EnhancedModel class."""
     # Mock goSPL before importing our module
@@ -21,42 +24,6 @@ def test_imports():
         from gospl_model_ext import EnhancedModel
         assert EnhancedModel is not None
 
-class MockModel:
-    """Mock Model class to simulate goSPL Model behavior."""
-    
-    def __init__(self, *args, **kwargs):
-        self.tNow = 0.0
-        self.tEnd = 100000.0
-        self.dt = 1000.0
-        self.run_calls = []
-        
-    def runProcesses(self, *args, **kwargs):
-        """Mock runProcesses method."""
-        # Simulate time advancement
-        old_time = self.tNow
-        self.tNow += self.dt
-        self.run_calls.append({
-            'method': 'runProcesses',
-            'old_time': old_time,
-            'new_time': self.tNow,
-            'args': args,
-            'kwargs': kwargs
-        })
-
-@pytest.fixture
-def mock_gospl():
-    """Create mock goSPL environment."""
-    mock_gospl = Mock()
-    mock_model = Mock()
-    mock_model.Model = MockModel
-    mock_gospl.model = mock_model
-    
-    with patch.dict('sys.modules', {
-        'gospl': mock_gospl,
-        'gospl.model': mock_model
-    }):
-        yield mock_gospl
-
 def test_enhanced_model_creation(mock_gospl):
     """Test that EnhancedModel can be created."""
     from gospl_model_ext import EnhancedModel
@@ -283,6 +250,719 @@ def test_timing_consistency(mock_gospl):
     assert model2.tNow == 5000.0
     assert model3.tNow == 5000.0
 
+def test_transfer_skips_unchanged_values(mock_gospl):
+    """Test that repeated velocities reuse the previous mesh fields."""
+    from gospl_model_ext import EnhancedModel
+
+    model = make_mesh_model(EnhancedModel)
+    rng = np.random.default_rng(0)
+    src = rng.uniform(0.0, 900.0, size=(40, 3))
+    vz = rng.normal(size=40)
+
+    model.set_uplift_rate(src, vz)
+    first = model._upsub_override.copy()
+    model.set_uplift_rate(src, vz.copy())
+
+    stats = model.get_transfer_stats()
+    assert stats['transfers'] == 2
+    assert stats['full'] == 1
+    assert stats['skipped'] == 1
+    assert stats['skip_rate'] == 0.5
+    assert np.array_equal(model._upsub_override, first)
+
+def test_transfer_partial_update_matches_full(mock_gospl):
+    """Test that a localised change only updates the affected mesh nodes."""
+    from gospl_model_ext import EnhancedModel
+
+    model = make_mesh_model(EnhancedModel, n=20)
+    rng = np.random.default_rng(1)
+    src = rng.uniform(0.0, 1900.0, size=(200, 3))
+    vx, vy, vz = rng.normal(size=(3, 200))
+
+    model.set_surface_velocity(src, vx, vy, vz)
+    vz2 = vz.copy()
+    vz2[:3] += 1.0
+    model.set_surface_velocity(src, vx, vy, vz2)
+    partial = model._upsub_override.copy()
+
+    stats = model.get_transfer_stats()
+    assert stats['partial'] == 1
+    assert stats['nodes_updated'] < 2 * model.mCoords.shape[0]
+
+    reference = make_mesh_model(EnhancedModel, n=20)
+    reference.set_surface_velocity(src, vx, vy, vz2)
+    assert np.allclose(partial, reference._upsub_override)
+
+def test_transfer_tolerance(mock_gospl):
+    """Test that sub-tolerance changes are skipped and invalid values rejected."""
+    from gospl_model_ext import EnhancedModel
+
+    model = make_mesh_model(EnhancedModel)
+    src = np.random.default_rng(2).uniform(0.0, 900.0, size=(30, 3))
+    vz = np.ones(30)
+
+    model.set_transfer_tolerance(1.0e-3)
+    model.set_uplift_rate(src, vz)
+    model.set_uplift_rate(src, vz + 1.0e-4)
+    assert model.get_transfer_stats()['skipped'] == 1
+
+    with pytest.raises(ValueError, match="non-negative"):
+        model.set_transfer_tolerance(-1.0)
+
+def test_sparse_velocity_upload_matches_full(mock_gospl):
+    """Test that sparse uploads on declared points match a full transfer."""
+    from gospl_model_ext import EnhancedModel
+
+    model = make_mesh_model(EnhancedModel, n=20)
+    rng = np.random.default_rng(3)
+    src = rng.uniform(0.0, 1900.0, size=(150, 3))
+    vx, vy, vz = rng.normal(size=(3, 150))
+
+    model.declare_surface_points(src)
+    model.set_surface_velocity(src, vx, vy, vz)
+
+    changed = np.array([5, 17, 90])
+    vz2 = vz.copy()
+    vz2[changed] += 2.0
+    model.set_surface_velocity_sparse(changed, vx[changed], vy[changed], vz2[changed])
+    sparse = model._upsub_override.copy()
+
+    reference = make_mesh_model(EnhancedModel, n=20)
+    reference.set_surface_velocity(src, vx, vy, vz2)
+    assert np.allclose(sparse, reference._upsub_override)
+
+    stats = model.get_transfer_stats()
+    assert stats['sparse'] == 1
+    assert stats['nodes_updated'] < 2 * model.mCoords.shape[0]
+
+def test_declared_points_survive_dense_transfers(mock_gospl):
+    """Test that dense transfers from other points keep the declared table."""
+    from gospl_model_ext import EnhancedModel
+
+    model = make_mesh_model(EnhancedModel, n=20)
+    rng = np.random.default_rng(4)
+    src = rng.uniform(0.0, 1900.0, size=(150, 3))
+    vz = rng.normal(size=150)
+    model.declare_surface_points(src)
+    model.set_uplift_rate_sparse(np.arange(150), vz)
+
+    other = rng.uniform(0.0, 1900.0, size=(80, 3))
+    model.set_uplift_rate(other, rng.normal(size=80))
+    model.set_uplift_rate(src, vz, k=5, power=2.0)
+
+    vz[[3, 40]] += 1.0
+    model.set_uplift_rate_sparse([3, 40], vz[[3, 40]])
+    reference = make_mesh_model(EnhancedModel, n=20)
+    reference.set_uplift_rate(src, vz)
+    assert np.allclose(model._upsub_override, reference._upsub_override)
+
+def test_sparse_upload_requires_declaration(mock_gospl):
+    """Test that sparse uploads fail without declared points."""
+    from gospl_model_ext import EnhancedModel
+
+    model = make_mesh_model(EnhancedModel)
+    with pytest.raises(RuntimeError, match="declare_surface_points"):
+        model.set_uplift_rate_sparse([0], [1.0])
+
+def test_sparse_erosion_matches_dense(mock_gospl):
+    """Test that sparse erosion output returns the dense values above threshold."""
+    from gospl_model_ext import EnhancedModel
+
+    def run(model, sparse):
+        src = model.mCoords.copy()
+        vz = np.where(src[:, 0] < 250.0, 1.0e-3, 0.0)
+        model.set_uplift_rate(src, vz)
+        query = src[::3] + 10.0
+        if sparse:
+            return model.run_and_get_erosion_sparse(1000.0, query, 0.5)
+        return model.run_and_get_erosion(1000.0, query)
+
+    dense = run(make_mesh_model(EnhancedModel), sparse=False)
+    indices, values = run(make_mesh_model(EnhancedModel), sparse=True)
+
+    expected = np.flatnonzero(np.abs(dense) > 0.5)
+    assert indices.dtype == np.int32
+    assert 0 < expected.size < dense.size
+    assert np.array_equal(indices, expected)
+    assert np.allclose(values, dense[expected])
+
+def test_accumulated_velocity_is_time_average(mock_gospl):
+    """Test that accumulated velocity samples are consumed as a time average."""
+    from gospl_model_ext import EnhancedModel
+
+    model = make_mesh_model(EnhancedModel)
+    src = np.random.default_rng(4).uniform(0.0, 900.0, size=(50, 3))
+    zeros = np.zeros(50)
+
+    model.accumulate_surface_velocity(src, zeros, zeros, np.full(50, 1.0e-3), 1.0)
+    model.accumulate_surface_velocity(src, zeros, zeros, np.full(50, 4.0e-3), 3.0)
+    erosion = model.run_and_get_erosion(1000.0, src)
+
+    # Mean uplift 3.25e-3 m/yr is stripped from the mock's zero change.
+    assert np.allclose(erosion, -3.25)
+    assert model._vel_accum is None
+    assert model._upsub_override is None
+
+    with pytest.raises(ValueError, match="dt_des must be positive"):
+        model.accumulate_surface_velocity(src, zeros, zeros, zeros, 0.0)
+
+def test_accumulation_keeps_transfer_cache(mock_gospl):
+    """Test that samples from moving points leave the dense transfer cache alone."""
+    from gospl_model_ext import EnhancedModel
+
+    model = make_mesh_model(EnhancedModel)
+    rng = np.random.default_rng(8)
+    src = rng.uniform(0.0, 900.0, size=(50, 3))
+    vel = rng.normal(size=(3, 50))
+    model.set_surface_velocity(src, *vel)
+    table = model._src_idw_cache
+
+    for step in range(3):
+        moved = src + 5.0 * (step + 1)
+        model.accumulate_surface_velocity(moved, *vel, 1.0)
+    assert model._src_idw_cache is table
+    model._vel_accum = None
+
+    model.set_surface_velocity(src, *vel)
+    assert model.get_transfer_stats()['skipped'] == 1
+
+def test_speculation_commit_and_rollback(mock_gospl):
+    """Test that a speculative interval is committed or rolled back on validation."""
+    from gospl_model_ext import EnhancedModel
+
+    model = make_mesh_model(EnhancedModel)
+    model.enable_speculation(True, tolerance=1.0e-9)
+    src = np.random.default_rng(5).uniform(0.0, 900.0, size=(50, 3))
+    uplift = np.full(50, 1.0e-3)
+
+    model.set_uplift_rate(src, uplift)
+    expected = model.run_and_get_erosion(1000.0, src)
+    model.speculate_next_interval(1000.0)
+    assert model.tNow == 2000.0
+    assert model.get_committed_time() == 1000.0
+
+    # Same forcing: the speculative interval is taken as is.
+    model.set_uplift_rate(src, uplift)
+    erosion = model.run_and_get_erosion(1000.0, src)
+    assert np.allclose(erosion, expected)
+    assert model.tNow == 2000.0
+    assert model.get_speculation_stats() == {'committed': 1, 'rolled_back': 0}
+
+    # Changed forcing: the state is rolled back and the interval rerun.
+    model.speculate_next_interval(1000.0)
+    model.set_uplift_rate(src, 2.0 * uplift)
+    erosion = model.run_and_get_erosion(1000.0, src)
+    assert np.allclose(erosion, 2.0 * expected)
+    assert model.tNow == 3000.0
+    assert model.get_speculation_stats() == {'committed': 1, 'rolled_back': 1}
+
+    with pytest.raises(ValueError, match="tolerance must be non-negative"):
+        model.enable_speculation(True, tolerance=-1.0)
+
+def test_speculation_rollback_restores_full_state(mock_gospl):
+    """Test that rollback restores strata and forcing indices and writes no output."""
+    from gospl_model_ext import EnhancedModel
+
+    model = make_mesh_model(EnhancedModel)
+    model.share_mesh_data()
+    shared = model.mCoords
+    model.enable_speculation(True)
+    model.stratH = np.zeros((100, 4))
+    model.tecNb = 0
+    model.saveTime = 5000.0
+    model.tout = 5000.0
+    outputs = []
+    step = model.runProcesses
+
+    def run_processes():
+        step()
+        model.stratH[:, model.tecNb % 4] += 1.0
+        model.tecNb += 1
+        model.flexIso = np.full(100, model.tNow)
+        if model.tecNb > 1:
+            model.stratZ = model.stratH.sum(axis=1)
+        if model.tNow >= model.saveTime:
+            model.visModel()
+            model.saveTime += model.tout
+
+    model.runProcesses = run_processes
+    model.visModel = lambda: outputs.append(model.tNow)
+    src = np.random.default_rng(7).uniform(0.0, 900.0, size=(50, 3))
+
+    model.set_uplift_rate(src, np.full(50, 1.0e-3))
+    model.run_and_get_erosion(1000.0, src)
+    strat, tec = model.stratH.copy(), model.tecNb
+
+    model.speculate_next_interval(1000.0)
+    assert model.tecNb == tec + 1
+    model.cancel_speculation()
+    assert model.tecNb == tec
+    assert np.array_equal(model.stratH, strat)
+    assert np.all(model.flexIso == 1000.0)
+    assert not hasattr(model, 'stratZ')
+    assert model.mCoords is shared
+    assert model.tNow == 1000.0
+
+    # An interval reaching the next output time is not speculated.
+    model.speculate_next_interval(4000.0)
+    assert model.tNow == 1000.0
+    assert model.get_committed_time() == 1000.0
+    model.set_uplift_rate(src, np.full(50, 1.0e-3))
+    model.run_and_get_erosion(4000.0, src)
+    assert outputs == [5000.0]
+    assert model.saveTime == 10000.0
+    model.release_shared_mesh()
+
+def test_euler_pole_velocity(mock_gospl):
+    """Test that per-plate Euler poles give v = omega x r on the mesh."""
+    from gospl_model_ext import EnhancedModel
+
+    model = make_mesh_model(EnhancedModel)
+    # Two plates split at x = 450 m.
+    src = model.mCoords.copy()
+    ids = (src[:, 0] > 450.0).astype(np.int32)
+    model.register_plate_ids(src, ids)
+
+    omega = np.array([[0.0, 0.0, 1.0e-6], [0.0, 0.0, -2.0e-6]])
+    model.set_euler_poles(omega)
+
+    expected = np.cross(omega[ids], model.mCoords)
+    assert np.allclose(model._vx_override, expected[:, 0])
+    assert np.allclose(model._vy_override, expected[:, 1])
+    assert np.allclose(model._upsub_override, 0.0)
+
+    with pytest.raises(ValueError, match="has no Euler pole"):
+        model.set_euler_poles(omega[:1])
+    with pytest.raises(ValueError, match="vertical axis"):
+        model.set_euler_poles([[1.0e-6, 0.0, 0.0], [0.0, 0.0, 1.0e-6]])
+
+def test_euler_pole_velocity_on_sphere(mock_gospl):
+    """Test Euler pole velocities against an exact rotation off the equator."""
+    from gospl_model_ext import EnhancedModel
+
+    model = make_mesh_model(EnhancedModel)
+    model.flatModel = False
+    radius = 6.371e6
+    lat = np.radians(np.linspace(20.0, 70.0, 100))
+    lon = np.radians(np.linspace(-60.0, 60.0, 100))
+    model.mCoords = radius * np.column_stack((np.cos(lat) * np.cos(lon),
+                                              np.cos(lat) * np.sin(lon),
+                                              np.sin(lat)))
+    model.register_plate_ids(model.mCoords, np.zeros(100, dtype=np.int32))
+
+    # Pole at 30N 45E, 1 degree per Myr.
+    rate = np.radians(1.0) / 1.0e6
+    plat, plon = np.radians(30.0), np.radians(45.0)
+    axis = np.array([np.cos(plat) * np.cos(plon), np.cos(plat) * np.sin(plon), np.sin(plat)])
+    model.set_euler_poles((rate * axis)[None, :])
+    vel = np.column_stack((model._vx_override, model._vy_override, model._vz_override))
+
+    # Central difference of the exact (Rodrigues) rotation of every node.
+    r = model.mCoords
+
+    def rotate(theta):
+        return (r * np.cos(theta) + np.cross(axis, r) * np.sin(theta)
+                + np.outer(r @ axis, axis) * (1.0 - np.cos(theta)))
+
+    dt = 1.0e3
+    expected = (rotate(rate * dt) - rotate(-rate * dt)) / (2.0 * dt)
+    assert np.allclose(vel, expected, rtol=1.0e-6, atol=1.0e-9)
+    assert np.abs(vel[:, 2]).max() > 0.0
+    assert np.allclose(np.einsum('ij,ij->i', vel, r) / radius, 0.0, atol=1.0e-9)
+    assert np.allclose(model._upsub_override, 0.0)
+
+def test_forcing_callback_pulled_per_substep(mock_gospl):
+    """Test that registered forcing is pulled at every substep midpoint."""
+    from gospl_model_ext import EnhancedModel
+
+    model = make_mesh_model(EnhancedModel)
+    src = np.random.default_rng(6).uniform(0.0, 900.0, size=(50, 3))
+    times = []
+
+    def pull(time):
+        times.append(time)
+        return np.full(50, 1.0e-3)
+
+    model.register_forcing(1, src, pull)
+    model.set_forcing_substeps(4)
+    erosion = model.run_and_get_erosion(1000.0, src)
+
+    assert times == [125.0, 375.0, 625.0, 875.0]
+    assert np.allclose(erosion, -1.0)
+
+    model.register_forcing(1, None, None)
+    model.run_and_get_erosion(1000.0, src)
+    assert len(times) == 4
+
+    with pytest.raises(ValueError, match="unknown forcing kind"):
+        model.register_forcing(2, src, pull)
+
+def test_shared_mesh_data_across_models(mock_gospl):
+    """Test that models on the same mesh share coordinates and KD-tree."""
+    from gospl_model_ext import EnhancedModel
+    from gospl_model_ext import mesh_store
+
+    first  = make_mesh_model(EnhancedModel)
+    second = make_mesh_model(EnhancedModel)
+    other  = make_mesh_model(EnhancedModel, spacing=50.0)
+    for model in (first, second, other):
+        model.share_mesh_data()
+
+    assert first.mCoords is second.mCoords
+    assert first.mCoords is not other.mCoords
+    assert not first.mCoords.flags.writeable
+    assert first._get_mesh_tree() is second._get_mesh_tree()
+    assert mesh_store.stats()[first._mesh_fp] == 2
+
+    first.release_shared_mesh()
+    first.release_shared_mesh()
+    assert mesh_store.stats()[second._mesh_fp] == 1
+    second.release_shared_mesh()
+    other.release_shared_mesh()
+    assert second._mesh_fp not in mesh_store.stats()
+
+def test_locality_ordering_preserves_results(mock_gospl):
+    """Test that Morton-ordered neighbour searches return the same results."""
+    from gospl_model_ext import EnhancedModel
+    from gospl_model_ext.ordering import morton_order
+
+    model = make_mesh_model(EnhancedModel, n=70, spacing=10.0)
+    rng = np.random.default_rng(3)
+    model.hGlobal.getArray()[:] = rng.uniform(-50.0, 50.0, model.lpoints)
+    query = np.column_stack((rng.uniform(0.0, 690.0, (5000, 2)), np.zeros(5000)))
+    assert query.shape[0] >= model._LOCALITY_MIN_POINTS
+
+    plain = model.interpolate_elevation_to_points(query, k=3)
+    tree = model._get_mesh_tree()
+    plain_knn = model._knn(tree, model.mCoords, 4)
+    model.set_locality_ordering(True)
+    ordered = model.interpolate_elevation_to_points(query, k=3)
+    ordered_knn = model._knn(tree, model.mCoords, 4, mesh_order=True)
+
+    assert np.array_equal(plain, ordered)
+    assert np.array_equal(plain_knn[0], ordered_knn[0])
+    assert np.array_equal(plain_knn[1], ordered_knn[1])
+    order = morton_order(query)
+    assert np.array_equal(np.sort(order), np.arange(query.shape[0]))
+
+def test_cube_sphere_index_matches_kdtree(mock_gospl, monkeypatch):
+    """Test that the cube-sphere index returns the KD-tree neighbours."""
+    from scipy.spatial import cKDTree
+    from gospl_model_ext import EnhancedModel
+    from gospl_model_ext import sphere_index
+
+    radius = 6378137.0
+    i = np.arange(5000) + 0.5
+    phi, theta = np.arccos(1.0 - 2.0 * i / i.size), np.pi * (1.0 + 5.0 ** 0.5) * i
+    mesh = radius * np.column_stack((np.cos(theta) * np.sin(phi),
+                                     np.sin(theta) * np.sin(phi), np.cos(phi)))
+    query = np.random.default_rng(5).normal(size=(3000, 3))
+    query *= radius / np.linalg.norm(query, axis=1, keepdims=True)
+
+    index = sphere_index.CubeSphereIndex(mesh)
+    tree = cKDTree(mesh)
+    for k in (1, 3, 12):
+        dist, idx = index.query(query, k=k)
+        ref_dist, ref_idx = tree.query(query, k=k)
+        assert dist.shape == ref_dist.shape
+        assert np.allclose(dist, ref_dist, rtol=1e-9)
+        assert np.array_equal(idx, ref_idx)
+    # k = 12 exceeds the bucket search radius for some queries.
+    assert 0 < index.stats['fallbacks'] < index.stats['queries']
+
+    # Global models use the index once its native kernel is installed.
+    model = make_mesh_model(EnhancedModel)
+    model.mCoords = mesh
+    model.flatModel = False
+    assert isinstance(model._spatial_index(mesh), cKDTree)
+    monkeypatch.setattr(sphere_index, 'available', lambda: True)
+    assert isinstance(model._get_mesh_tree(), sphere_index.CubeSphereIndex)
+    model.flatModel = True
+    assert isinstance(model._spatial_index(mesh), cKDTree)
+
+def test_active_set_skips_quiescent_steps(mock_gospl):
+    """Test that steps without active nodes run in fast mode until a sweep."""
+    from gospl_model_ext import EnhancedModel
+
+    model = make_mesh_model(EnhancedModel)
+    change = np.zeros(model.lpoints)
+    modes = []
+
+    def run_processes():
+        modes.append(getattr(model, 'fast', False))
+        if not modes[-1]:
+            model.hGlobal.getArray()[:] += change
+        model.tNow += model.dt
+
+    model.runProcesses = run_processes
+    model.set_active_set(threshold=1.0e-6, full_sweep_every=3)
+
+    change[5] = -0.01
+    model.runProcessesForDt(100.0)      # first step: full
+    change[:] = 0.0
+    for _ in range(5):
+        model.runProcessesForDt(100.0)
+    # Active after the erosion step, then two quiescent steps between sweeps.
+    assert modes == [False, False, True, True, False, True]
+    assert getattr(model, 'fast', False) is False
+
+    # An elevation edit between steps reactivates the model.
+    model.hGlobal.getArray()[10] += 1.0
+    model.runProcessesForDt(100.0)
+    assert modes[-1] is False
+
+    stats = model.get_active_set_stats()
+    assert stats['steps'] == 7
+    assert stats['skipped'] == 3
+    assert stats['sweeps'] == 1
+    assert stats['active_fraction'] == 0.0
+
+    model.set_active_set(None)
+    model.runProcessesForDt(100.0)
+    assert modes[-1] is False
+
+def test_catchment_accumulation_matches_global_solve(mock_gospl, monkeypatch):
+    """Test that per-basin flow accumulation solves goSPL's flow system."""
+    from gospl_model_ext import EnhancedModel
+    from gospl_model_ext import catchments
+
+    # Four independent basins of a random two-direction receiver graph.
+    rng = np.random.default_rng(11)
+    n, ndir = 400, 2
+    z = rng.uniform(0.0, 100.0, n)
+    group = np.arange(n) % 4
+    rcv = np.tile(np.arange(n)[:, None], (1, ndir))
+    wght = np.zeros((n, ndir))
+    for i in range(n):
+        lower = np.nonzero((group == group[i]) & (z < z[i]))[0]
+        if lower.size:
+            pick = rng.choice(lower, size=min(ndir, lower.size), replace=False)
+            rcv[i, :pick.size] = pick
+            wght[i, :pick.size] = rng.dirichlet(np.ones(pick.size))
+    source = rng.uniform(0.5, 2.0, n)
+    system = np.eye(n)
+    for k in range(ndir):
+        flows = rcv[:, k] != np.arange(n)
+        system[rcv[flows, k], np.arange(n)[flows]] -= wght[flows, k]
+    expected = np.linalg.solve(system, source)
+
+    basins = catchments.Catchments(rcv, wght)
+    assert basins.count == 4
+    assert basins.sizes[basins.schedule[0]] == basins.sizes.max()
+    assert np.allclose(basins.accumulate(source), expected)
+
+    # A cycle is reported rather than solved.
+    cyclic = rcv.copy()
+    cyclic[0, 0], cyclic[4, 0] = 4, 0
+    both = wght.copy()
+    both[0, 0] = both[4, 0] = 1.0
+    assert catchments.accumulate_global(cyclic, both, source) is None
+
+    # The model routes solves on the flow matrix through the basins.
+    global_solves = []
+    monkeypatch.setattr(MockModel, 'matrixFlow',
+                        lambda self: setattr(self, 'fMati', object()), raising=False)
+    monkeypatch.setattr(MockModel, '_solve_KSP',
+                        lambda self, g, m, v1, v2: global_solves.append(m), raising=False)
+    monkeypatch.setattr(catchments, 'available', lambda: True)
+    model = EnhancedModel("test_config.yml")
+    model.locIDs = np.arange(n)
+    model.rcvID, model.wghtVal = rcv, wght
+    model.set_catchment_parallel(True, threads=2)
+    model.matrixFlow()
+    out = MockVec(np.zeros(n))
+    model._solve_KSP(True, model.fMati, MockVec(source), out)
+    assert np.allclose(out.getArray(), expected)
+    model._solve_KSP(True, object(), MockVec(source), out)
+    model.set_catchment_parallel(True, giant_fraction=0.1)
+    model._solve_KSP(True, model.fMati, MockVec(source), out)
+    assert len(global_solves) == 2
+    stats = model.get_catchment_stats()
+    assert stats['solves'] == 1
+    assert stats['fallbacks'] == 1
+    assert stats['basins'] == 4
+
+def test_incremental_depressions_match_full_fill(mock_gospl):
+    """Test that depression updates only reflood what changed, exactly."""
+    from gospl_model_ext import EnhancedModel
+    from gospl_model_ext.depressions import DepressionFiller
+
+    n = 12
+    model = make_mesh_model(EnhancedModel, n)
+    ij = np.arange(n * n).reshape(n, n)
+    ngb = np.full((n * n, 4), -1)
+    ngb[ij[1:, :].ravel(), 0] = ij[:-1, :].ravel()
+    ngb[ij[:-1, :].ravel(), 1] = ij[1:, :].ravel()
+    ngb[ij[:, 1:].ravel(), 2] = ij[:, :-1].ravel()
+    ngb[ij[:, :-1].ravel(), 3] = ij[:, 1:].ravel()
+    model.FVmesh_ngbID = ngb
+    model.idBorders = np.concatenate((ij[0], ij[-1], ij[1:-1, 0], ij[1:-1, -1]))
+    model.sealevel = -100.0
+    rng = np.random.default_rng(5)
+    h = model.hGlobal.getArray()
+    h[:] = rng.uniform(0.0, 10.0, n * n)
+
+    assert model.get_depression_stats() is None
+    model.set_incremental_depressions(True, tolerance=0.0)
+    assert model.get_depression_stats()['full'] == 1
+    outlets = np.zeros(n * n, dtype=bool)
+    outlets[model.idBorders] = True
+
+    for step in range(15):
+        # Erosion, uplift and drift-correction style edits of a few nodes.
+        nodes = rng.choice(n * n, 3, replace=False)
+        h[nodes] += rng.normal(0.0, 3.0, 3)
+        stats = model.get_depression_stats()
+        reference = DepressionFiller(ngb, h, outlets, tolerance=0.0)
+        assert np.array_equal(model._depressions.filled, reference.filled)
+        assert stats['depressions'] == reference.count
+
+    assert stats['updates'] == 15
+    assert stats['full'] == 1
+    assert stats['total_recomputed'] < 15 * stats['depressions']
+
+    # Nothing moved: nothing is recomputed.
+    assert model.get_depression_stats()['recomputed'] == 0
+
+    # Stepping leaves the state alone; it is only updated when queried.
+    assert not hasattr(EnhancedModel, 'flowAccumulation')
+
+    model.set_incremental_depressions(False)
+    assert model.get_depression_stats() is None
+
+def test_output_stats_time_gospl_output(mock_gospl, monkeypatch):
+    """Test that goSPL's visModel() calls are counted and timed."""
+    from gospl_model_ext import EnhancedModel
+
+    def vis_model(self):
+        time.sleep(0.01)
+
+    def run_processes(self):
+        self.tNow += self.dt
+        if self.tNow % 2000.0 == 0.0:
+            self.visModel()
+
+    monkeypatch.setattr(MockModel, 'visModel', vis_model, raising=False)
+    monkeypatch.setattr(MockModel, 'runProcesses', run_processes)
+    model = EnhancedModel("test_config.yml")
+    assert model.get_output_stats() == {'writes': 0, 'seconds': 0.0}
+    model.runProcessesForSteps(4, dt=1000.0)
+    stats = model.get_output_stats()
+    assert stats['writes'] == 2
+    assert stats['seconds'] >= 0.02
+
+    model.reset_coupling_state()
+    assert model.get_output_stats()['writes'] == 0
+
+def test_gc_policy_keeps_collections_out_of_steps(mock_gospl):
+    """Test that the GC policy holds collections back while a step runs."""
+    import gc
+    from gospl_model_ext import EnhancedModel, gc_policy
+
+    model = EnhancedModel("test_config.yml")
+    seen = []
+
+    def run_processes():
+        seen.append((gc.isenabled(), gc.get_freeze_count()))
+        for _ in range(2000):
+            cycle = []
+            cycle.append(cycle)
+        model.tNow += model.dt
+
+    model.runProcesses = run_processes
+    threshold = gc.get_threshold()
+    try:
+        gc.set_threshold(100)
+        gc_policy.reset_stats()
+        gc_policy.set_mode('disable')
+        model.runProcessesForDt(100.0)
+        assert seen[-1] == (False, 0)
+        assert gc.isenabled()
+        assert gc_policy.stats()['in_step'] == 0
+        gc_policy.collect()
+        stats = gc_policy.stats()
+        assert stats['explicit'] == 1
+        assert stats['max_pause'] > 0.0
+
+        gc_policy.set_mode('freeze')
+        model.runProcessesForDt(100.0)
+        assert seen[-1][0] and seen[-1][1] > 0
+        assert gc.get_freeze_count() == 0
+        with pytest.raises(ValueError):
+            gc_policy.set_mode('never')
+    finally:
+        gc_policy.set_mode('default')
+        gc.set_threshold(*threshold)
+
+def test_log_routes_records_and_prints(mock_gospl, monkeypatch):
+    """Test that log records and routed prints reach the native emitter."""
+    from gospl_model_ext import EnhancedModel, log
+
+    records = []
+    monkeypatch.setattr(log, '_native_emit', lambda *rec: records.append(rec))
+    monkeypatch.setattr(log, 'level', log.INFO)
+
+    model = EnhancedModel("test_config.yml")
+    model.runProcessesForDt(100.0, verbose=True)
+    assert records[0][:2] == (log.INFO, 'runProcessesForDt')
+    assert records[0][2].startswith('step start dt=100.0 ')
+
+    log.debug('test', 'hidden')
+    log.warn('test', 'with fields', path='a b', n=3)
+    assert records[-1] == (log.WARN, 'test', 'with fields path="a b" n=3')
+
+    try:
+        log.route_prints(True)
+        print("partial", end='')
+        print(" line\nsecond")
+        print("tail", end='')
+    finally:
+        log.route_prints(False)
+    assert records[-3:] == [(log.INFO, 'stdout', 'partial line'),
+                            (log.INFO, 'stdout', 'second'),
+                            (log.INFO, 'stdout', 'tail')]
+
+
+def test_mesh_cache_maps_saved_tree(mock_gospl, tmp_path, monkeypatch):
+    """Test that the mesh KD-tree is written once and mapped afterwards."""
+    from gospl_model_ext import EnhancedModel
+
+    monkeypatch.setenv('GOSPL_MESH_CACHE_DIR', str(tmp_path))
+    first = make_mesh_model(EnhancedModel)
+    tree = first._get_mesh_tree()
+    files = list(tmp_path.glob('kdtree-*.bin'))
+    assert len(files) == 1
+
+    second = make_mesh_model(EnhancedModel)
+    mapped = second._get_mesh_tree()
+    assert mapped is not tree
+    query = np.random.default_rng(7).uniform(0.0, 900.0, size=(20, 3))
+    assert np.array_equal(tree.query(query, k=3)[1], mapped.query(query, k=3)[1])
+
+    # A corrupt cache file is rebuilt instead of failing.
+    files[0].write_bytes(b'garbage')
+    third = make_mesh_model(EnhancedModel)
+    assert third._get_mesh_tree().n == 100
+
+
+def test_mesh_cache_rejects_untrusted_files(mock_gospl, tmp_path):
+    """Test that cache files writable by others or naming other globals are not loaded."""
+    import pickle
+    from scipy.spatial import cKDTree
+    from gospl_model_ext import mesh_cache
+
+    path = tmp_path / 'tree.bin'
+    mesh_cache.save(str(path), cKDTree(np.random.default_rng(3).random((50, 3))))
+    assert mesh_cache.load(str(path)).n == 50
+
+    os.chmod(path, 0o666)
+    with pytest.raises(ValueError, match="writable by other users"):
+        mesh_cache.load(str(path))
+
+    mesh_cache.save(str(path), os.system)
+    with pytest.raises(pickle.UnpicklingError, match="not allowed"):
+        mesh_cache.load(str(path))
+
 if __name__ == "__main__":
     # Run tests if called directly
     import subprocess
@@ -312,7 +992,25 @@ if __name__ == "__main__":
                 test_error_handling_invalid_steps,
                 test_error_handling_invalid_target_time,
                 test_dt_override_preserves_original,
-                test_timing_consistency
+                test_timing_consistency,
+                test_transfer_skips_unchanged_values,
+                test_transfer_partial_update_matches_full,
+                test_transfer_tolerance,
+                test_sparse_velocity_upload_matches_full,
+                test_declared_points_survive_dense_transfers,
+                test_sparse_upload_requires_declaration,
+                test_sparse_erosion_matches_dense,
+                test_accumulated_velocity_is_time_average,
+                test_accumulation_keeps_transfer_cache,
+                test_speculation_commit_and_rollback,
+                test_speculation_rollback_restores_full_state,
+                test_euler_pole_velocity,
+                test_euler_pole_velocity_on_sphere,
+                test_forcing_callback_pulled_per_substep,
+                test_shared_mesh_data_across_models,
+                test_locality_ordering_preserves_results,
+                test_active_set_skips_quiescent_steps,
+                test_gc_policy_keeps_collections_out_of_steps
             ]
             
             passed = 0
@@ -0,0 +1,242 @@
+"""
+Tests for the warm model server.
+
+A mock goSPL Model stands in for the real one, so the tests exercise leasing,
+reset-on-release and the shared-memory wire format without goSPL or PETSc.
+"""
+
+import os
+import sys
+import tempfile
+import threading
+import time
+from unittest.mock import Mock, patch
+
+import numpy as np
+import pytest
+# Import before the fixture patches sys.modules so it is not reloaded per test.
+import scipy.spatial  # noqa: F401
+
+sys.path.insert(0, os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+
+
+class MockVec:
+    """Minimal stand-in for a PETSc Vec exposing getArray()."""
+
+    def __init__(self, values):
+        self._values = np.asarray(values, dtype=np.float64)
+
+    def getArray(self):
+        return self._values
+
+
+class MockModel:
+    """
+    Mock goSPL Model whose runProcesses() lowers the surface by 1 m, adds a
+    stratigraphic layer and advances the tectonic record index.
+    """
+
+    def __init__(self, config_path, *args, **kwargs):
+        self.tNow = 0.0
+        self.tEnd = 100000.0
+        self.dt = 1000.0
+        xs, ys = np.meshgrid(np.arange(10) * 100.0, np.arange(10) * 100.0)
+        self.mCoords = np.column_stack((xs.ravel(), ys.ravel(), np.zeros(100)))
+        self.hGlobal = MockVec(np.zeros(100))
+        self.stratH = np.zeros((100, 4))
+        self.stratStep = 0
+        self.tecNb = 0
+        self.outputDir = os.path.join(os.path.dirname(config_path), "output")
+
+    def runProcesses(self):
+        self.tNow += self.dt
+        self.hGlobal.getArray()[:] -= 1.0
+        self.stratH[:, self.stratStep] = 1.0
+        self.stratStep += 1
+        self.tecNb += 1
+
+
+class MockTectonics:
+    """Base class standing in for gospl.mesher.tectonics.Tectonics."""
+
+
+def _mock_gospl():
+    """Patch sys.modules with the goSPL modules the default factory imports."""
+    mock_model = Mock()
+    mock_model.Model = MockModel
+    mock_tectonics = Mock()
+    mock_tectonics.Tectonics = MockTectonics
+    return patch.dict('sys.modules', {
+        'gospl': Mock(), 'gospl.model': mock_model, 'gospl.mesher': Mock(),
+        'gospl.mesher.tectonics': mock_tectonics, 'gospl._fortran': Mock()})
+
+
+@pytest.fixture
+def server(tmp_path):
+    """
+    Start a model server with one warm instance on a temporary socket, using
+    the default factory (shared mesh data, data-driven velocities).
+    """
+    with _mock_gospl():
+        from gospl_model_ext.model_server import ModelServer
+
+        config = tmp_path / "config.yml"
+        config.write_text("name: test\n")
+        sock_dir = tempfile.mkdtemp(prefix="gospl")
+        srv = ModelServer(os.path.join(sock_dir, "server.sock"), pool_size=1)
+        srv.prewarm(str(config))
+        thread = threading.Thread(target=srv.serve_forever, daemon=True)
+        thread.start()
+        while not os.path.exists(srv.socket_path):
+            time.sleep(0.01)
+        yield srv, str(config)
+        srv.shutdown()
+        thread.join()
+        os.rmdir(sock_dir)
+
+
+def test_lease_reuses_warm_instance_reset_to_initial_state(server):
+    """Test that a released instance is reset and handed to the next job."""
+    from gospl_model_ext.model_server import lease
+
+    srv, config = server
+    model = lease(srv.socket_path, config)
+    model.runProcessesForDt(500.0)
+    assert model.tNow == 500.0
+    assert model.dt == 1000.0
+    model.set_transfer_tolerance(0.5)
+    model.destroy()
+
+    # Wait for the release to land back in the pool.
+    deadline = time.time() + 5.0
+    while sum(len(p) for p in srv._pools.values()) < 1 and time.time() < deadline:
+        time.sleep(0.01)
+
+    model = lease(srv.socket_path, config)
+    assert model.tNow == 0.0
+    assert model.interpolate_elevation_to_points(np.zeros((1, 3)), k=1)[0] == 0.0
+    assert not hasattr(model, 'transfer_tol') or model.transfer_tol == 0.0
+    stats = model.server_stats()
+    model.destroy()
+    assert stats['leases'] == 2
+    assert stats['warm_hits'] == 2
+    assert stats['cold_starts'] == 0
+
+
+def _wait_for_release(srv):
+    deadline = time.time() + 5.0
+    while sum(len(p) for p in srv._pools.values()) < 1 and time.time() < deadline:
+        time.sleep(0.01)
+
+
+def _pooled_model(srv):
+    (pool,) = srv._pools.values()
+    return pool[0][0]
+
+
+def test_release_restores_full_state_and_separates_output(server):
+    """Test that strata and forcing indices are reset and leases get own output."""
+    from gospl_model_ext.model_server import lease
+
+    srv, config = server
+    _wait_for_release(srv)
+    coords = _pooled_model(srv).mCoords
+    assert not coords.flags.writeable
+
+    model = lease(srv.socket_path, config)
+    model.runProcessesForDt(500.0)
+    first_dir = model.outputDir
+    model.destroy()
+    _wait_for_release(srv)
+
+    # Strata and forcing indices are back at their initial values, and the
+    # shared (read-only) mesh coordinates survive the restore.
+    pooled = _pooled_model(srv)
+    assert pooled.tecNb == 0
+    assert pooled.stratStep == 0
+    assert np.all(pooled.stratH == 0.0)
+    assert pooled.mCoords is coords
+
+    model = lease(srv.socket_path, config)
+    elev = model.interpolate_elevation_to_points(np.zeros((1, 3)), k=1)
+    second_dir = model.outputDir
+    model.destroy()
+    assert elev.shape == (1,)
+
+    base = os.path.join(os.path.dirname(config), "output")
+    assert first_dir != second_dir
+    for path in (first_dir, second_dir):
+        assert path.startswith(base + "_lease")
+        assert os.path.isdir(os.path.join(path, "h5"))
+        assert os.path.isdir(os.path.join(path, "xmf"))
+
+
+def test_remote_errors_and_large_arrays(server):
+    """Test that remote exceptions propagate and large arrays round-trip."""
+    from gospl_model_ext.model_server import lease, SHM_THRESHOLD
+
+    srv, config = server
+    model = lease(srv.socket_path, config)
+    with pytest.raises(ValueError, match="dt must be positive"):
+        model.runProcessesForDt(-1.0)
+
+    # Large enough to travel through shared memory in both directions.
+    n = SHM_THRESHOLD // 8
+    src = np.column_stack((np.linspace(0.0, 1.0, n), np.zeros(n), np.zeros(n)))
+    model.declare_surface_points(src, k=1)
+    elev = model.interpolate_elevation_to_points(src, k=1)
+    model.destroy()
+    assert elev.shape == (n,)
+
+
+def test_lease_exposes_only_coupling_api(server):
+    """Test that a lease cannot reach methods or attributes off the allow-list."""
+    from gospl_model_ext.model_server import lease
+
+    srv, config = server
+    model = lease(srv.socket_path, config)
+    assert model.tNow == 0.0
+    with pytest.raises(AttributeError):
+        model.share_mesh_data()
+    with pytest.raises(AttributeError):
+        model._restore_state
+    with pytest.raises(AttributeError):
+        model.mCoords
+    model.destroy()
+
+
+def test_rejects_pickled_globals(server):
+    """Test that the server refuses requests naming arbitrary callables."""
+    import socket
+    from gospl_model_ext.model_server import send_message, recv_message
+
+    srv, config = server
+    sock = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+    sock.connect(srv.socket_path)
+    send_message(sock, ('lease', os.system))
+    status, payload = recv_message(sock)
+    sock.close()
+    assert status == 'error'
+    assert 'not allowed' in str(payload)
+
+
+def test_unconsumed_segments_are_unlinked():
+    """Test that shared memory segments are unlinked when the peer goes away."""
+    import socket
+    from multiprocessing import shared_memory
+    with _mock_gospl():
+        from gospl_model_ext.model_server import SHM_THRESHOLD, send_message, _unlink_segments
+
+    left, right = socket.socketpair()
+    names = send_message(left, np.zeros(SHM_THRESHOLD // 8))
+    right.close()
+    left.close()
+    assert len(names) == 1
+    _unlink_segments(names)
+    with pytest.raises(FileNotFoundError):
+        shared_memory.SharedMemory(name=names[0])
+
+
+if __name__ == "__main__":
+    import subprocess
+    subprocess.run([sys.executable, "-m", "pytest", __file__, "-v"], check=True)
@@ -0,0 +1,247 @@
+"""
+Performance regression tests for the coupling methods of EnhancedModel.
+
+Each method runs a fixed workload on a synthetic mesh under the mock goSPL of
+conftest and is measured for:
+
+- trees:       KD-tree builds per call, counted by patching
+               scipy.spatial.cKDTree (an index rebuilt on every call shows up);
+- peak_arrays: peak memory traced by tracemalloc during a call, in units of a
+               mesh-sized float64 array (an extra field copy adds about one);
+- relative:    best wall time per call (least disturbed by other load)
+               divided by that of a calibration workload timed in the same
+               process, so the baseline carries across machines (seconds is
+               reported as well).
+
+tests/perf_baseline.json holds the reference values and tolerances. trees and
+peak_arrays are deterministic and always checked; timings only when
+GOSPL_PERF_TIMING=1, since they need a quiet machine. run_tests.py --perf sets
+it. GOSPL_PERF_RESULTS=<path> writes the measurements as JSON and
+GOSPL_PERF_UPDATE=1 rewrites the baseline from them instead of checking.
+"""
+
+import json
+import os
+import platform
+import sys
+import time
+import tracemalloc
+from contextlib import contextmanager
+from datetime import datetime, timezone
+
+import numpy as np
+import pytest
+
+sys.path.insert(0, os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+
+from tests.conftest import make_mesh_model
+
+BASELINE_PATH = os.path.join(os.path.dirname(os.path.abspath(__file__)), 'perf_baseline.json')
+
+_MESH_SIDE = 60        # 3600 mesh nodes
+_DES_POINTS = 2000
+_REPEATS = 7
+_TIMING = os.environ.get('GOSPL_PERF_TIMING') == '1'
+_UPDATE = os.environ.get('GOSPL_PERF_UPDATE') == '1'
+
+
+class Workload:
+    """DES-side data of the fixed workload."""
+
+    def __init__(self):
+        rng = np.random.default_rng(0)
+        extent = (_MESH_SIDE - 1) * 100.0
+        self.src = rng.uniform(0.0, extent, size=(_DES_POINTS, 3))
+        self.src[:, 2] = 0.0
+        self.query = self.src + 10.0
+        self.elev = rng.uniform(0.0, 100.0, _DES_POINTS)
+        self.vx, self.vy = rng.normal(scale=1.0e-2, size=(2, _DES_POINTS))
+        self.vz = rng.normal(scale=1.0e-3, size=_DES_POINTS)
+        self.changed = np.sort(rng.choice(_DES_POINTS, 20, replace=False))
+
+
+def _declare(model, w):
+    model.declare_surface_points(w.src)
+    model.set_surface_velocity(w.src, w.vx, w.vy, w.vz)
+
+
+def _sparse_velocity(model, w, i):
+    c = w.changed
+    model.set_surface_velocity_sparse(c, w.vx[c], w.vy[c], w.vz[c] + 1.0e-3 * i)
+
+
+def _erosion(model, w, i, sparse=False):
+    model.set_uplift_rate(w.src, w.vz + 1.0e-4 * i)
+    if sparse:
+        return model.run_and_get_erosion_sparse(1000.0, w.query, 0.5)
+    return model.run_and_get_erosion(1000.0, w.query)
+
+
+# name -> (setup(model, workload) or None, call(model, workload, i)); calls
+# vary their inputs with i so that no transfer is skipped as unchanged.
+WORKLOADS = {
+    'interpolate_elevation_to_points': (
+        None, lambda m, w, i: m.interpolate_elevation_to_points(w.query)),
+    'apply_elevation_data': (
+        None, lambda m, w, i: m.apply_elevation_data({'coords': w.src, 'elev': w.elev + i})),
+    'set_surface_velocity': (
+        None, lambda m, w, i: m.set_surface_velocity(w.src, w.vx, w.vy, w.vz + 1.0e-3 * i)),
+    'set_uplift_rate': (
+        None, lambda m, w, i: m.set_uplift_rate(w.src, w.vz + 1.0e-3 * i)),
+    'set_surface_velocity_sparse': (_declare, _sparse_velocity),
+    'run_and_get_erosion': (None, _erosion),
+    'run_and_get_erosion_sparse': (
+        None, lambda m, w, i: _erosion(m, w, i, sparse=True)),
+    'apply_drift_correction': (
+        None, lambda m, w, i: m.apply_drift_correction(w.src, w.elev + i, 0.2)),
+    'runProcessesForDt': (None, lambda m, w, i: m.runProcessesForDt(1000.0)),
+}
+
+
+@contextmanager
+def count_trees():
+    """Count cKDTree constructions; the extension imports it at call time."""
+    import scipy.spatial
+    base = scipy.spatial.cKDTree
+    count = [0]
+
+    class CountingTree(base):
+        def __init__(self, *args, **kwargs):
+            count[0] += 1
+            super().__init__(*args, **kwargs)
+
+    scipy.spatial.cKDTree = CountingTree
+    try:
+        yield count
+    finally:
+        scipy.spatial.cKDTree = base
+
+
+def calibrate():
+    """Best time of a fixed numpy/cKDTree workload of similar size."""
+    from scipy.spatial import cKDTree
+    rng = np.random.default_rng(1)
+    mesh = rng.uniform(size=(_MESH_SIDE * _MESH_SIDE, 3))
+    pts = rng.uniform(size=(_DES_POINTS, 3))
+    values = rng.uniform(size=mesh.shape[0])
+    times = []
+    for _ in range(_REPEATS):
+        start = time.perf_counter()
+        d, idx = cKDTree(mesh, leafsize=10).query(pts, k=3)
+        w = 1.0 / np.maximum(d, 1.0e-20)
+        (w * values[idx]).sum(axis=1) / w.sum(axis=1)
+        times.append(time.perf_counter() - start)
+    return min(times)
+
+
+def measure(EnhancedModel, name, calibration):
+    """Measure one coupling method on the fixed workload."""
+    setup, call = WORKLOADS[name]
+    model = make_mesh_model(EnhancedModel, n=_MESH_SIDE)
+    w = Workload()
+    if setup is not None:
+        setup(model, w)
+    call(model, w, 0)  # builds the cached mesh index and transfer tables
+
+    times = []
+    for i in range(1, _REPEATS + 1):
+        start = time.perf_counter()
+        call(model, w, i)
+        times.append(time.perf_counter() - start)
+
+    with count_trees() as trees:
+        tracemalloc.start()
+        try:
+            call(model, w, _REPEATS + 1)
+            peak = tracemalloc.get_traced_memory()[1]
+        finally:
+            tracemalloc.stop()
+
+    seconds = min(times)
+    return {
+        'seconds': seconds,
+        'relative': seconds / calibration,
+        'trees': trees[0],
+        'peak_arrays': round(peak / (8.0 * model.mCoords.shape[0]), 2),
+    }
+
+
+def load_baseline(path=BASELINE_PATH):
+    if not os.path.exists(path):
+        return {'tolerance': {'time': 2.0, 'time_slack': 0.05, 'peak_arrays': 0.25},
+                'methods': {}}
+    with open(path) as f:
+        return json.load(f)
+
+
+def compare(name, result, baseline, timing=_TIMING):
+    """Return the ways *result* exceeds the baseline of *name*."""
+    ref = baseline['methods'].get(name)
+    if ref is None:
+        return [f"{name}: no baseline (rerun with GOSPL_PERF_UPDATE=1)"]
+    tol = baseline['tolerance']
+    failures = []
+    if result['trees'] > ref['trees']:
+        failures.append(f"{name}: {result['trees']} tree builds per call, baseline {ref['trees']}")
+    limit = ref['peak_arrays'] * (1.0 + tol['peak_arrays']) + 0.5
+    if result['peak_arrays'] > limit:
+        failures.append(f"{name}: peak {result['peak_arrays']} mesh arrays, "
+                        f"baseline {ref['peak_arrays']} (limit {limit:.2f})")
+    # time_slack (in calibration units) keeps microsecond calls out of the noise
+    limit = ref['relative'] * tol['time'] + tol['time_slack']
+    if timing and result['relative'] > limit:
+        failures.append(f"{name}: {result['relative']:.3f} x calibration, "
+                        f"baseline {ref['relative']:.3f} (limit {limit:.3f})")
+    return failures
+
+
+def _environment(calibration):
+    return {
+        'timestamp': datetime.now(timezone.utc).isoformat(timespec='seconds'),
+        'python': platform.python_version(),
+        'numpy': np.__version__,
+        'machine': platform.machine(),
+        'calibration_seconds': calibration,
+    }
+
+
+def write_results(path, results, calibration, failures):
+    data = dict(_environment(calibration), methods=results, failures=failures)
+    with open(path, 'w') as f:
+        json.dump(data, f, indent=2, sort_keys=True)
+
+
+def update_baseline(results, calibration, path=BASELINE_PATH):
+    baseline = load_baseline(path)
+    baseline['generated'] = _environment(calibration)
+    baseline['methods'].update({name: {k: r[k] for k in ('relative', 'trees', 'peak_arrays')}
+                                for name, r in results.items()})
+    with open(path, 'w') as f:
+        json.dump(baseline, f, indent=2, sort_keys=True)
+        f.write('\n')
+
+
+@pytest.fixture(scope='module')
+def perf_run():
+    run = {'calibration': calibrate(), 'baseline': load_baseline(), 'results': {},
+           'failures': []}
+    yield run
+    if _UPDATE:
+        update_baseline(run['results'], run['calibration'])
+    path = os.environ.get('GOSPL_PERF_RESULTS')
+    if path:
+        write_results(path, run['results'], run['calibration'], run['failures'])
+
+
+@pytest.mark.parametrize('name', sorted(WORKLOADS))
+def test_coupling_method_performance(mock_gospl, perf_run, name):
+    """Test that a coupling method stays within its performance baseline."""
+    from gospl_model_ext import EnhancedModel
+
+    result = measure(EnhancedModel, name, perf_run['calibration'])
+    perf_run['results'][name] = result
+    if _UPDATE:
+        return
+    failures = compare(name, result, perf_run['baseline'])
+    perf_run['failures'].extend(failures)
+    assert not failures, '; '.join(failures)